@@ -0,0 +1,352 @@
+#include <BenchmarkRunner.h>
+#include <GPUReducer.h>
+#include <ReductionAutotuner.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+using namespace wgpu;
+
+namespace nv {
+
+namespace {
+
+// Percentile of sorted values, with linear interpolation:
+auto get_percentile(const Vector<F64>& sorted, F64 p) -> F64 {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    F64 pos = p * (F64)(sorted.size() - 1);
+    auto idx = (size_t)pos;
+    if (idx + 1 >= sorted.size()) {
+        return sorted.back();
+    }
+    F64 t = pos - (F64)idx;
+    return sorted[idx] * (1.0 - t) + sorted[idx + 1] * t;
+}
+
+auto to_gbs(U64 bytes, F64 ns) -> F64 {
+    return ns > 0.0 ? (F64)bytes / (std::pow(1024, 3) * ns * 1e-9) : 0.0;
+}
+
+auto escape_json(const String& str) -> String {
+    String res;
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            res += '\\';
+        }
+        res += c;
+    }
+    return res;
+}
+
+auto join_defs(const StringVector& defs, const char* sep) -> String {
+    String res;
+    for (const auto& def : defs) {
+        if (!res.empty()) {
+            res += sep;
+        }
+        res += def;
+    }
+    return res;
+}
+
+} // namespace
+
+auto BenchmarkCase::get_name() const -> String {
+    return kernel + "[" + join_defs(defs, ",") +
+           "]/n=" + std::to_string(size) +
+           "/rf=" + std::to_string(reductionFactor);
+}
+
+BenchmarkRunner::BenchmarkRunner(const BenchmarkRunnerDesc& desc)
+    : _desc(desc) {
+    NVCHK(_desc.numSamples > 0 && _desc.dispatchesPerSample > 0,
+          "BenchmarkRunner: invalid number of samples.");
+    load_baseline();
+};
+
+BenchmarkRunner::~BenchmarkRunner() = default;
+
+auto BenchmarkRunner::create(const BenchmarkRunnerDesc& desc)
+    -> RefPtr<BenchmarkRunner> {
+    return nv::create<BenchmarkRunner>(desc);
+}
+
+void BenchmarkRunner::add_matrix(const BenchmarkMatrix& matrix) {
+    for (const auto& kernel : matrix.kernels) {
+        for (const auto& defs : matrix.defs) {
+            for (auto size : matrix.sizes) {
+                for (auto factor : matrix.reductionFactors) {
+                    _cases.push_back({.kernel = kernel,
+                                      .defs = defs,
+                                      .size = size,
+                                      .reductionFactor = factor});
+                }
+            }
+        }
+    }
+}
+
+auto BenchmarkRunner::compute_stats(Vector<F64> samplesNs,
+                                    U64 bytesPerDispatch, F64 outlierFactor)
+    -> BenchmarkResult {
+    BenchmarkResult res;
+    std::sort(samplesNs.begin(), samplesNs.end());
+
+    // Tukey fences:
+    F64 q1 = get_percentile(samplesNs, 0.25);
+    F64 q3 = get_percentile(samplesNs, 0.75);
+    F64 iqr = q3 - q1;
+    F64 lo = q1 - outlierFactor * iqr;
+    F64 hi = q3 + outlierFactor * iqr;
+
+    Vector<F64> kept;
+    for (auto ns : samplesNs) {
+        if (ns >= lo && ns <= hi) {
+            kept.push_back(ns);
+        }
+    }
+    res.numSamples = (U32)kept.size();
+    res.numOutliers = (U32)(samplesNs.size() - kept.size());
+    if (kept.empty()) {
+        return res;
+    }
+
+    res.medianNs = get_percentile(kept, 0.5);
+    res.p95Ns = get_percentile(kept, 0.95);
+    res.medianGBs = to_gbs(bytesPerDispatch, res.medianNs);
+    res.p95GBs = to_gbs(bytesPerDispatch, res.p95Ns);
+
+    // Distribution-free 95% confidence interval of the median, from the
+    // order statistics at n/2 -/+ 1.96*sqrt(n)/2:
+    F64 n = (F64)kept.size();
+    F64 half = 0.98 * std::sqrt(n);
+    auto lowRank = (I64)std::floor(n / 2.0 - half);
+    auto highRank = (I64)std::ceil(n / 2.0 + half);
+    lowRank = std::clamp<I64>(lowRank, 0, (I64)kept.size() - 1);
+    highRank = std::clamp<I64>(highRank, 0, (I64)kept.size() - 1);
+
+    // Note: the fastest times give the highest bandwidths:
+    res.ciHighGBs = to_gbs(bytesPerDispatch, kept[lowRank]);
+    res.ciLowGBs = to_gbs(bytesPerDispatch, kept[highRank]);
+
+    return res;
+}
+
+auto BenchmarkRunner::run_case(const BenchmarkCase& bcase,
+                               const PassBuilder& builder) -> BenchmarkResult {
+    auto* eng = WGPUEngine::instance();
+    auto pass = builder(bcase);
+    NVCHK(pass.cpass != nullptr, "BenchmarkRunner: no compute pass for {}",
+          bcase.get_name());
+
+    // Invalid dispatches would only record errors:
+    U32 maxDim =
+        GPUReducer::get_device_limits().maxComputeWorkgroupsPerDimension;
+    if (pass.maxWorkgroups > maxDim) {
+        logWARN("{}: skipped, {} workgroups is above the device limit {}",
+                bcase.get_name(), pass.maxWorkgroups, maxDim);
+        BenchmarkResult res;
+        res.bcase = bcase;
+        res.skipped = true;
+        return res;
+    }
+
+    auto& bld = eng->build_commands();
+
+    // Warmup (also compiles the pipelines):
+    bld.reset_all();
+    for (U32 i = 0; i < _desc.warmupIters; ++i) {
+        bld.execute_compute_pass(*pass.cpass);
+    }
+    bld.submit();
+
+    bool valid = !pass.validate || pass.validate();
+
+    Vector<F64> samples;
+    samples.reserve(_desc.numSamples);
+    for (U32 s = 0; s < _desc.numSamples; ++s) {
+        bld.reset_all();
+        bld.write_timestamp(0);
+        for (U32 i = 0; i < _desc.dispatchesPerSample; ++i) {
+            bld.execute_compute_pass(*pass.cpass);
+        }
+        bld.write_timestamp(1);
+        bld.submit(false);
+
+        // Wait for the sample to complete before reading its timestamps:
+        eng->wait_idle();
+        samples.push_back(eng->get_timestamp_delta_ns(0, 1) /
+                          _desc.dispatchesPerSample);
+    }
+
+    auto res = compute_stats(samples, pass.bytesPerDispatch,
+                             _desc.outlierFactor);
+    res.bcase = bcase;
+    res.valid = valid;
+    return res;
+}
+
+auto BenchmarkRunner::run(const PassBuilder& builder)
+    -> const Vector<BenchmarkResult>& {
+    _results.clear();
+    _numSkipped = 0;
+    String adapter = ReductionAutotuner::get_adapter_key();
+
+    for (const auto& bcase : _cases) {
+        auto res = run_case(bcase, builder);
+        if (res.skipped) {
+            _numSkipped++;
+            continue;
+        }
+        String name = bcase.get_name();
+
+        auto it = _baseline.find(adapter + "|" + name);
+        if (it != _baseline.end()) {
+            res.baselineGBs = it->second;
+            res.regressed = res.ciHighGBs <
+                            res.baselineGBs * (1.0 - _desc.regressionTolerance);
+        }
+
+        logNOTE("{}: median {:.3f} GB/s [{:.3f}, {:.3f}], p95 {:.3f} GB/s "
+                "({} samples, {} outliers)",
+                name, res.medianGBs, res.ciLowGBs, res.ciHighGBs, res.p95GBs,
+                res.numSamples, res.numOutliers);
+        if (!res.valid) {
+            logERROR("{}: invalid results.", name);
+        }
+        if (res.regressed) {
+            logERROR("{}: regression, {:.3f} GB/s vs baseline {:.3f} GB/s",
+                     name, res.medianGBs, res.baselineGBs);
+        }
+
+        _results.push_back(res);
+    }
+
+    // The first run on an adapter initializes its baseline:
+    bool missing = false;
+    for (const auto& res : _results) {
+        missing = missing || res.baselineGBs == 0.0;
+    }
+    if (!_desc.baselineFile.empty() && (_desc.updateBaseline || missing)) {
+        for (const auto& res : _results) {
+            String key = adapter + "|" + res.bcase.get_name();
+            if (_desc.updateBaseline || _baseline.count(key) == 0) {
+                _baseline[key] = res.medianGBs;
+            }
+        }
+        save_baseline();
+    }
+
+    return _results;
+}
+
+auto BenchmarkRunner::get_num_regressions() const -> U32 {
+    return (U32)std::count_if(_results.begin(), _results.end(),
+                              [](const auto& res) { return res.regressed; });
+}
+
+auto BenchmarkRunner::get_num_invalid() const -> U32 {
+    return (U32)std::count_if(_results.begin(), _results.end(),
+                              [](const auto& res) { return !res.valid; });
+}
+
+void BenchmarkRunner::write_json(const String& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        logERROR("BenchmarkRunner: cannot write {}", filename);
+        return;
+    }
+
+    file << "{\n  \"adapter\": \""
+         << escape_json(ReductionAutotuner::get_adapter_key())
+         << "\",\n  \"results\": [";
+    for (size_t i = 0; i < _results.size(); ++i) {
+        const auto& res = _results[i];
+        file << (i > 0 ? "," : "") << "\n    {\"kernel\": \""
+             << escape_json(res.bcase.kernel) << "\", \"defs\": [";
+        for (size_t j = 0; j < res.bcase.defs.size(); ++j) {
+            file << (j > 0 ? ", " : "") << "\""
+                 << escape_json(res.bcase.defs[j]) << "\"";
+        }
+        file << "], \"size\": " << res.bcase.size
+             << ", \"reductionFactor\": " << res.bcase.reductionFactor
+             << ", \"samples\": " << res.numSamples
+             << ", \"outliers\": " << res.numOutliers
+             << ", \"medianNs\": " << res.medianNs
+             << ", \"p95Ns\": " << res.p95Ns
+             << ", \"medianGBs\": " << res.medianGBs
+             << ", \"p95GBs\": " << res.p95GBs
+             << ", \"ciLowGBs\": " << res.ciLowGBs
+             << ", \"ciHighGBs\": " << res.ciHighGBs
+             << ", \"baselineGBs\": " << res.baselineGBs
+             << ", \"valid\": " << (res.valid ? "true" : "false")
+             << ", \"regressed\": " << (res.regressed ? "true" : "false")
+             << "}";
+    }
+    file << "\n  ]\n}\n";
+}
+
+void BenchmarkRunner::write_csv(const String& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        logERROR("BenchmarkRunner: cannot write {}", filename);
+        return;
+    }
+
+    file << "kernel,defs,size,reductionFactor,samples,outliers,medianNs,"
+            "p95Ns,medianGBs,p95GBs,ciLowGBs,ciHighGBs,baselineGBs,valid,"
+            "regressed\n";
+    for (const auto& res : _results) {
+        // Note: the defines may contain commas, so they are quoted:
+        String defs = join_defs(res.bcase.defs, ";");
+        std::replace(defs.begin(), defs.end(), '"', '\'');
+        file << res.bcase.kernel << ",\"" << defs << "\"," << res.bcase.size
+             << "," << res.bcase.reductionFactor << "," << res.numSamples
+             << "," << res.numOutliers << "," << res.medianNs << ","
+             << res.p95Ns << "," << res.medianGBs << "," << res.p95GBs << ","
+             << res.ciLowGBs << "," << res.ciHighGBs << "," << res.baselineGBs
+             << "," << (res.valid ? 1 : 0) << "," << (res.regressed ? 1 : 0)
+             << "\n";
+    }
+}
+
+void BenchmarkRunner::load_baseline() {
+    _baseline.clear();
+    if (_desc.baselineFile.empty() ||
+        !system_file_exists(_desc.baselineFile.c_str())) {
+        return;
+    }
+
+    // Each line is: <adapter>|<case name>\t<median GB/s> (the case names
+    // may contain spaces from the defines):
+    std::ifstream file(_desc.baselineFile);
+    String line;
+    while (std::getline(file, line)) {
+        auto pos = line.rfind('\t');
+        if (pos == String::npos) {
+            continue;
+        }
+        _baseline[line.substr(0, pos)] = std::stod(line.substr(pos + 1));
+    }
+
+    logDEBUG("BenchmarkRunner: loaded {} baseline entries from {}",
+             _baseline.size(), _desc.baselineFile);
+}
+
+void BenchmarkRunner::save_baseline() {
+    std::ofstream file(_desc.baselineFile);
+    if (!file.is_open()) {
+        logERROR("BenchmarkRunner: cannot write baseline file {}",
+                 _desc.baselineFile);
+        return;
+    }
+
+    for (const auto& it : _baseline) {
+        file << it.first << "\t" << it.second << "\n";
+    }
+}
+
+} // namespace nv
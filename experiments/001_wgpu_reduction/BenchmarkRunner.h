@@ -0,0 +1,169 @@
+#ifndef NV_BENCHMARKRUNNER_H_
+#define NV_BENCHMARKRUNNER_H_
+
+#include <gpu_common.h>
+
+namespace nv {
+
+/** Declared set of benchmark variants: every combination of kernel, defines
+set, size and reduction factor is a separate case. */
+struct BenchmarkMatrix {
+    /** Shader files to benchmark. */
+    StringVector kernels;
+
+    /** Sets of shader defines. */
+    Vector<StringVector> defs{{}};
+
+    /** Number of elements processed per dispatch. */
+    Vector<U32> sizes{4194304};
+
+    /** Number of elements processed per thread. */
+    Vector<U32> reductionFactors{1};
+};
+
+struct BenchmarkCase {
+    String kernel;
+    StringVector defs;
+    U32 size{0};
+    U32 reductionFactor{1};
+
+    /** Unique name of the case (used as baseline key). */
+    auto get_name() const -> String;
+};
+
+/** Compute pass built for one benchmark case. */
+struct BenchmarkPass {
+    RefPtr<WGPUComputePass> cpass;
+
+    /** Number of bytes read from memory by one dispatch. */
+    U64 bytesPerDispatch{0};
+
+    /** Buffers kept alive while the case is running. */
+    Vector<std::unique_ptr<GPUBuffer>> buffers;
+
+    /** Optional check of the results after the warmup. */
+    std::function<bool()> validate;
+
+    /** Largest number of workgroups per dimension in the dispatches of the
+    pass (cases above the device limit are skipped, 0 to skip the check). */
+    U32 maxWorkgroups{0};
+};
+
+struct BenchmarkResult {
+    BenchmarkCase bcase;
+
+    /** Number of samples kept and rejected as outliers. */
+    U32 numSamples{0};
+    U32 numOutliers{0};
+
+    /** Time per dispatch (in ns). */
+    F64 medianNs{0.0};
+    F64 p95Ns{0.0};
+
+    /** Bandwidth from the median and 95th percentile times (in GB/s). */
+    F64 medianGBs{0.0};
+    F64 p95GBs{0.0};
+
+    /** 95% confidence interval of the median bandwidth. */
+    F64 ciLowGBs{0.0};
+    F64 ciHighGBs{0.0};
+
+    /** Validation result (true if no validation function). */
+    bool valid{true};
+
+    /** The case was not run (dispatch above the device limits). */
+    bool skipped{false};
+
+    /** Baseline median bandwidth (0 if not in the baseline). */
+    F64 baselineGBs{0.0};
+    bool regressed{false};
+};
+
+struct BenchmarkRunnerDesc {
+    /** Number of dispatches before the timed samples. */
+    U32 warmupIters{10};
+
+    /** Number of timed samples per case. */
+    U32 numSamples{30};
+
+    /** Number of dispatches timed in each sample. */
+    U32 dispatchesPerSample{20};
+
+    /** Samples outside [Q1 - k*IQR, Q3 + k*IQR] are rejected. */
+    F64 outlierFactor{1.5};
+
+    /** Baseline file for the regression gate (disabled if empty). */
+    String baselineFile;
+
+    /** A case regresses when the upper bound of its confidence interval is
+    below the baseline median by more than this fraction. */
+    F64 regressionTolerance{0.05};
+
+    /** Store the current results as the new baseline. */
+    bool updateBaseline{false};
+};
+
+/**
+ * Benchmark a matrix of kernel variants: each case is warmed up, then timed
+ * over several samples with timestamp queries. Outliers are rejected before
+ * computing the median/p95 bandwidths and the confidence interval of the
+ * median. The results can be written as JSON or CSV, and compared against a
+ * per-adapter baseline file.
+ */
+class NVGPU_EXPORT BenchmarkRunner : public RefObject {
+  public:
+    using PassBuilder = std::function<BenchmarkPass(const BenchmarkCase&)>;
+
+    explicit BenchmarkRunner(const BenchmarkRunnerDesc& desc);
+    ~BenchmarkRunner() override;
+
+    static auto create(const BenchmarkRunnerDesc& desc = {})
+        -> RefPtr<BenchmarkRunner>;
+
+    /** Add all the cases of a matrix. */
+    void add_matrix(const BenchmarkMatrix& matrix);
+
+    /** Get the declared cases. */
+    auto get_cases() const -> const Vector<BenchmarkCase>& { return _cases; }
+
+    /** Run all the cases, building their compute pass with builder. */
+    auto run(const PassBuilder& builder) -> const Vector<BenchmarkResult>&;
+
+    /** Get the results of the last run. */
+    auto get_results() const -> const Vector<BenchmarkResult>& {
+        return _results;
+    }
+
+    /** Get the number of regressed or invalid cases in the last run. */
+    auto get_num_regressions() const -> U32;
+    auto get_num_invalid() const -> U32;
+
+    /** Get the number of cases skipped in the last run. */
+    auto get_num_skipped() const -> U32 { return _numSkipped; }
+
+    /** Write the results of the last run. */
+    void write_json(const String& filename) const;
+    void write_csv(const String& filename) const;
+
+    /** Compute the statistics of the samples (times per dispatch in ns). */
+    static auto compute_stats(Vector<F64> samplesNs, U64 bytesPerDispatch,
+                              F64 outlierFactor) -> BenchmarkResult;
+
+  protected:
+    BenchmarkRunnerDesc _desc;
+    Vector<BenchmarkCase> _cases;
+    Vector<BenchmarkResult> _results;
+    std::map<String, F64> _baseline;
+    U32 _numSkipped{0};
+
+    /** Time one case. */
+    auto run_case(const BenchmarkCase& bcase, const PassBuilder& builder)
+        -> BenchmarkResult;
+
+    void load_baseline();
+    void save_baseline();
+};
+
+} // namespace nv
+
+#endif
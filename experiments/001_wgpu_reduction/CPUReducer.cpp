@@ -0,0 +1,322 @@
+#include <CPUReducer.h>
+
+#include <limits>
+#include <thread>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define NV_CPUREDUCER_AVX2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define NV_CPUREDUCER_NEON 1
+#endif
+
+namespace nv {
+
+namespace {
+
+// Number of float elements accumulated in SIMD lanes before flushing the
+// partial sums to F64 (to limit the precision loss on large inputs).
+constexpr U64 kFloatBlock = 4096;
+
+template <typename T> auto min_identity() -> T {
+    if constexpr (std::numeric_limits<T>::has_infinity) {
+        return std::numeric_limits<T>::infinity();
+    } else {
+        return std::numeric_limits<T>::max();
+    }
+}
+
+template <typename T> auto max_identity() -> T {
+    if constexpr (std::numeric_limits<T>::has_infinity) {
+        return -std::numeric_limits<T>::infinity();
+    } else {
+        return std::numeric_limits<T>::lowest();
+    }
+}
+
+template <typename T, typename R> auto identity(ReduceOp op) -> R {
+    switch (op) {
+    case ReduceOp::Min:
+        return (R)min_identity<T>();
+    case ReduceOp::Max:
+        return (R)max_identity<T>();
+    default:
+        return R(0);
+    }
+}
+
+template <typename R> auto combine(R a, R b, ReduceOp op) -> R {
+    switch (op) {
+    case ReduceOp::Min:
+        return b < a ? b : a;
+    case ReduceOp::Max:
+        return b > a ? b : a;
+    default:
+        return a + b;
+    }
+}
+
+template <typename T, typename R>
+auto reduce_scalar(const T* data, U64 count, ReduceOp op, R res) -> R {
+    for (U64 i = 0; i < count; ++i) {
+        res = combine<R>(res, (R)data[i], op);
+    }
+    return res;
+}
+
+auto reduce_chunk(const U32* data, U64 count, ReduceOp op) -> U64 {
+    U64 res = identity<U32, U64>(op);
+    U64 i = 0;
+
+#if NV_CPUREDUCER_AVX2
+    if (op == ReduceOp::Sum) {
+        // Split each 64-bit lane in its low and high u32 to accumulate on
+        // 64 bits without any shuffle:
+        const __m256i mask = _mm256_set1_epi64x(0xFFFFFFFF);
+        __m256i acc0 = _mm256_setzero_si256();
+        __m256i acc1 = _mm256_setzero_si256();
+        for (; i + 8 <= count; i += 8) {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(data + i));
+            acc0 = _mm256_add_epi64(acc0, _mm256_and_si256(v, mask));
+            acc1 = _mm256_add_epi64(acc1, _mm256_srli_epi64(v, 32));
+        }
+        alignas(32) U64 lanes[4];
+        _mm256_store_si256((__m256i*)lanes, _mm256_add_epi64(acc0, acc1));
+        res = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    } else {
+        bool isMin = op == ReduceOp::Min;
+        __m256i acc = _mm256_set1_epi32((I32)(U32)res);
+        for (; i + 8 <= count; i += 8) {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(data + i));
+            acc = isMin ? _mm256_min_epu32(acc, v) : _mm256_max_epu32(acc, v);
+        }
+        alignas(32) U32 lanes[8];
+        _mm256_store_si256((__m256i*)lanes, acc);
+        res = reduce_scalar<U32, U64>(lanes, 8, op, res);
+    }
+#elif NV_CPUREDUCER_NEON
+    if (op == ReduceOp::Sum) {
+        uint64x2_t acc0 = vdupq_n_u64(0);
+        uint64x2_t acc1 = vdupq_n_u64(0);
+        for (; i + 8 <= count; i += 8) {
+            acc0 = vpadalq_u32(acc0, vld1q_u32(data + i));
+            acc1 = vpadalq_u32(acc1, vld1q_u32(data + i + 4));
+        }
+        uint64x2_t acc = vaddq_u64(acc0, acc1);
+        res = vgetq_lane_u64(acc, 0) + vgetq_lane_u64(acc, 1);
+    } else {
+        bool isMin = op == ReduceOp::Min;
+        uint32x4_t acc = vdupq_n_u32((U32)res);
+        for (; i + 4 <= count; i += 4) {
+            uint32x4_t v = vld1q_u32(data + i);
+            acc = isMin ? vminq_u32(acc, v) : vmaxq_u32(acc, v);
+        }
+        U32 lanes[4];
+        vst1q_u32(lanes, acc);
+        res = reduce_scalar<U32, U64>(lanes, 4, op, res);
+    }
+#endif
+
+    return reduce_scalar<U32, U64>(data + i, count - i, op, res);
+}
+
+auto reduce_chunk(const F32* data, U64 count, ReduceOp op) -> F64 {
+    F64 res = identity<F32, F64>(op);
+    U64 i = 0;
+
+#if NV_CPUREDUCER_AVX2
+    if (op == ReduceOp::Sum) {
+        while (i + 16 <= count) {
+            U64 end = std::min(count, i + kFloatBlock);
+            __m256 acc0 = _mm256_setzero_ps();
+            __m256 acc1 = _mm256_setzero_ps();
+            for (; i + 16 <= end; i += 16) {
+                acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(data + i));
+                acc1 = _mm256_add_ps(acc1, _mm256_loadu_ps(data + i + 8));
+            }
+            alignas(32) F32 lanes[8];
+            _mm256_store_ps(lanes, _mm256_add_ps(acc0, acc1));
+            res = reduce_scalar<F32, F64>(lanes, 8, op, res);
+        }
+    } else {
+        bool isMin = op == ReduceOp::Min;
+        __m256 acc = _mm256_set1_ps((F32)res);
+        for (; i + 8 <= count; i += 8) {
+            __m256 v = _mm256_loadu_ps(data + i);
+            acc = isMin ? _mm256_min_ps(acc, v) : _mm256_max_ps(acc, v);
+        }
+        alignas(32) F32 lanes[8];
+        _mm256_store_ps(lanes, acc);
+        res = reduce_scalar<F32, F64>(lanes, 8, op, res);
+    }
+#elif NV_CPUREDUCER_NEON
+    if (op == ReduceOp::Sum) {
+        while (i + 8 <= count) {
+            U64 end = std::min(count, i + kFloatBlock);
+            float32x4_t acc0 = vdupq_n_f32(0.0F);
+            float32x4_t acc1 = vdupq_n_f32(0.0F);
+            for (; i + 8 <= end; i += 8) {
+                acc0 = vaddq_f32(acc0, vld1q_f32(data + i));
+                acc1 = vaddq_f32(acc1, vld1q_f32(data + i + 4));
+            }
+            F32 lanes[4];
+            vst1q_f32(lanes, vaddq_f32(acc0, acc1));
+            res = reduce_scalar<F32, F64>(lanes, 4, op, res);
+        }
+    } else {
+        bool isMin = op == ReduceOp::Min;
+        float32x4_t acc = vdupq_n_f32((F32)res);
+        for (; i + 4 <= count; i += 4) {
+            float32x4_t v = vld1q_f32(data + i);
+            acc = isMin ? vminq_f32(acc, v) : vmaxq_f32(acc, v);
+        }
+        F32 lanes[4];
+        vst1q_f32(lanes, acc);
+        res = reduce_scalar<F32, F64>(lanes, 4, op, res);
+    }
+#endif
+
+    return reduce_scalar<F32, F64>(data + i, count - i, op, res);
+}
+
+auto reduce_chunk(const F64* data, U64 count, ReduceOp op) -> F64 {
+    F64 res = identity<F64, F64>(op);
+    U64 i = 0;
+
+#if NV_CPUREDUCER_AVX2
+    __m256d acc0 = _mm256_set1_pd(res);
+    __m256d acc1 = _mm256_set1_pd(res);
+    for (; i + 8 <= count; i += 8) {
+        __m256d v0 = _mm256_loadu_pd(data + i);
+        __m256d v1 = _mm256_loadu_pd(data + i + 4);
+        switch (op) {
+        case ReduceOp::Min:
+            acc0 = _mm256_min_pd(acc0, v0);
+            acc1 = _mm256_min_pd(acc1, v1);
+            break;
+        case ReduceOp::Max:
+            acc0 = _mm256_max_pd(acc0, v0);
+            acc1 = _mm256_max_pd(acc1, v1);
+            break;
+        default:
+            acc0 = _mm256_add_pd(acc0, v0);
+            acc1 = _mm256_add_pd(acc1, v1);
+            break;
+        }
+    }
+    alignas(32) F64 lanes[8];
+    _mm256_store_pd(lanes, acc0);
+    _mm256_store_pd(lanes + 4, acc1);
+    res = reduce_scalar<F64, F64>(lanes, 8, op, identity<F64, F64>(op));
+#elif NV_CPUREDUCER_NEON && defined(__aarch64__)
+    float64x2_t acc0 = vdupq_n_f64(res);
+    float64x2_t acc1 = vdupq_n_f64(res);
+    for (; i + 4 <= count; i += 4) {
+        float64x2_t v0 = vld1q_f64(data + i);
+        float64x2_t v1 = vld1q_f64(data + i + 2);
+        switch (op) {
+        case ReduceOp::Min:
+            acc0 = vminq_f64(acc0, v0);
+            acc1 = vminq_f64(acc1, v1);
+            break;
+        case ReduceOp::Max:
+            acc0 = vmaxq_f64(acc0, v0);
+            acc1 = vmaxq_f64(acc1, v1);
+            break;
+        default:
+            acc0 = vaddq_f64(acc0, v0);
+            acc1 = vaddq_f64(acc1, v1);
+            break;
+        }
+    }
+    F64 lanes[4];
+    vst1q_f64(lanes, acc0);
+    vst1q_f64(lanes + 2, acc1);
+    res = reduce_scalar<F64, F64>(lanes, 4, op, identity<F64, F64>(op));
+#endif
+
+    return reduce_scalar<F64, F64>(data + i, count - i, op, res);
+}
+
+} // namespace
+
+CPUReducer::CPUReducer(const CPUReducerDesc& desc) : _desc(desc) {
+    _numThreads = _desc.numThreads;
+    if (_numThreads == 0) {
+        _numThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    NVCHK(_desc.minElemsPerThread > 0,
+          "CPUReducer: invalid min elements per thread.");
+
+    logDEBUG("CPUReducer: using {} threads, SIMD: {}", _numThreads,
+             get_simd_name());
+};
+
+CPUReducer::~CPUReducer() = default;
+
+auto CPUReducer::create(const CPUReducerDesc& desc) -> RefPtr<CPUReducer> {
+    return nv::create<CPUReducer>(desc);
+}
+
+auto CPUReducer::get_simd_name() -> const char* {
+#if NV_CPUREDUCER_AVX2
+    return "AVX2";
+#elif NV_CPUREDUCER_NEON
+    return "NEON";
+#else
+    return "none";
+#endif
+}
+
+template <typename T, typename R>
+auto CPUReducer::reduce_parallel(const T* data, U64 count, ReduceOp op) -> R {
+    auto startTick = SystemTime::tick();
+
+    U64 maxChunks = (count + _desc.minElemsPerThread - 1) /
+                    _desc.minElemsPerThread;
+    U64 numChunks = std::max<U64>(1, std::min<U64>(_numThreads, maxChunks));
+    U64 chunkSize = (count + numChunks - 1) / numChunks;
+
+    Vector<R> partials(numChunks, identity<T, R>(op));
+    Vector<std::thread> workers;
+    workers.reserve(numChunks - 1);
+
+    // Chunk 0 is processed on the calling thread:
+    for (U64 c = 1; c < numChunks; ++c) {
+        U64 start = c * chunkSize;
+        U64 num = start < count ? std::min(chunkSize, count - start) : 0;
+        workers.emplace_back([&partials, data, start, num, op, c]() {
+            partials[c] = reduce_chunk(data + start, num, op);
+        });
+    }
+    partials[0] = reduce_chunk(data, std::min(chunkSize, count), op);
+
+    R res = partials[0];
+    for (U64 c = 1; c < numChunks; ++c) {
+        workers[c - 1].join();
+        res = combine<R>(res, partials[c], op);
+    }
+
+    _lastDuration = SystemTime::delta_s(startTick, SystemTime::tick());
+    _lastBandwidth = _lastDuration > 0.0
+                         ? (F64)(count * sizeof(T)) /
+                               (std::pow(1024, 3) * _lastDuration)
+                         : 0.0;
+
+    return res;
+}
+
+auto CPUReducer::reduce(const U32* data, U64 count, ReduceOp op) -> U64 {
+    return reduce_parallel<U32, U64>(data, count, op);
+}
+
+auto CPUReducer::reduce(const F32* data, U64 count, ReduceOp op) -> F64 {
+    return reduce_parallel<F32, F64>(data, count, op);
+}
+
+auto CPUReducer::reduce(const F64* data, U64 count, ReduceOp op) -> F64 {
+    return reduce_parallel<F64, F64>(data, count, op);
+}
+
+} // namespace nv
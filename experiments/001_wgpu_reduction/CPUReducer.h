@@ -0,0 +1,66 @@
+#ifndef NV_CPUREDUCER_H_
+#define NV_CPUREDUCER_H_
+
+#include <gpu_common.h>
+
+namespace nv {
+
+enum class ReduceOp : U8 { Sum, Min, Max };
+
+struct CPUReducerDesc {
+    /** Number of worker threads (0 to use all the hardware threads). */
+    U32 numThreads{0};
+
+    /** Minimum number of elements processed by each thread. */
+    U64 minElemsPerThread{1 << 16};
+};
+
+/**
+ * Multithreaded SIMD reduction on the CPU (AVX2 or NEON when available),
+ * used as a baseline and verifier for the GPU reductions.
+ * Integer sums are accumulated on 64 bits, float sums are combined in F64.
+ */
+class NVGPU_EXPORT CPUReducer : public RefObject {
+  public:
+    explicit CPUReducer(const CPUReducerDesc& desc);
+    ~CPUReducer() override;
+
+    static auto create(const CPUReducerDesc& desc = {}) -> RefPtr<CPUReducer>;
+
+    /** Reduce u32 values. */
+    auto reduce(const U32* data, U64 count, ReduceOp op = ReduceOp::Sum)
+        -> U64;
+
+    /** Reduce f32 values. */
+    auto reduce(const F32* data, U64 count, ReduceOp op = ReduceOp::Sum)
+        -> F64;
+
+    /** Reduce f64 values. */
+    auto reduce(const F64* data, U64 count, ReduceOp op = ReduceOp::Sum)
+        -> F64;
+
+    /** Get the duration of the last reduction in seconds. */
+    auto get_last_duration() const -> F64 { return _lastDuration; }
+
+    /** Get the bandwidth achieved by the last reduction in GB/s. */
+    auto get_last_bandwidth() const -> F64 { return _lastBandwidth; }
+
+    /** Get the number of threads used for large inputs. */
+    auto get_num_threads() const -> U32 { return _numThreads; }
+
+    /** Get the name of the SIMD path compiled in. */
+    static auto get_simd_name() -> const char*;
+
+  protected:
+    CPUReducerDesc _desc;
+    U32 _numThreads{1};
+    F64 _lastDuration{0.0};
+    F64 _lastBandwidth{0.0};
+
+    template <typename T, typename R>
+    auto reduce_parallel(const T* data, U64 count, ReduceOp op) -> R;
+};
+
+} // namespace nv
+
+#endif
@@ -0,0 +1,139 @@
+#include <GPUBatchedReducer.h>
+#include <GPUReducer.h>
+
+using namespace wgpu;
+
+namespace nv {
+
+GPUBatchedReducer::GPUBatchedReducer(const GPUBatchedReducerDesc& desc)
+    : _desc(desc) {
+    NVCHK(_desc.input != nullptr, "GPUBatchedReducer: invalid input buffer.");
+    NVCHK(_desc.offsets != nullptr,
+          "GPUBatchedReducer: invalid offsets buffer.");
+    NVCHK(_desc.numSegments > 0, "GPUBatchedReducer: no segment to reduce.");
+    NVCHK(_desc.workgroupSize > 0 &&
+              (_desc.workgroupSize & (_desc.workgroupSize - 1)) == 0,
+          "GPUBatchedReducer: workgroup size {} is not a power of 2.",
+          _desc.workgroupSize);
+    NVCHK(_desc.sliceSize > 0 && _desc.sliceSize <= _desc.workgroupSize &&
+              (_desc.sliceSize & (_desc.sliceSize - 1)) == 0,
+          "GPUBatchedReducer: invalid slice size {}.", _desc.sliceSize);
+    NVCHK(_desc.maxWorkgroups > 0,
+          "GPUBatchedReducer: invalid max number of workgroups.");
+
+    _output = _desc.output;
+    if (_output == nullptr) {
+        _ownedOutput = std::make_unique<GPUBuffer>(
+            (U64)_desc.numSegments * sizeof(U32),
+            BufferUsage::Storage | BufferUsage::CopySrc);
+        _output = _ownedOutput.get();
+    }
+
+    _cpass = _desc.cpass != nullptr ? RefPtr<WGPUComputePass>(_desc.cpass)
+                                    : create_ref_object<WGPUComputePass>();
+
+    build_steps();
+};
+
+GPUBatchedReducer::~GPUBatchedReducer() = default;
+
+auto GPUBatchedReducer::create(const GPUBatchedReducerDesc& desc)
+    -> RefPtr<GPUBatchedReducer> {
+    return nv::create<GPUBatchedReducer>(desc);
+}
+
+auto GPUBatchedReducer::get_identity(BatchReduceOp op) -> U32 {
+    return op == BatchReduceOp::Min ? 0xFFFFFFFFU : 0U;
+}
+
+auto GPUBatchedReducer::add_params(U32 numGroups, U32& groupsX, U32& groupsY)
+    -> GPUBuffer* {
+    GPUReducer::get_dispatch_size(numGroups, _desc.maxWorkgroupsPerDimension,
+                                  groupsX, groupsY);
+
+    U32 params[3] = {_desc.numSegments, numGroups, groupsX};
+    return _params
+        .emplace_back(std::make_unique<GPUBuffer>(sizeof(params),
+                                                  BufferUsage::Storage, params))
+        .get();
+}
+
+void GPUBatchedReducer::build_steps() {
+    U32 wgSize = _desc.workgroupSize;
+    U32 numSegments = _desc.numSegments;
+
+    StringVector defs = {
+        "WG_SIZE=" + std::to_string(wgSize),
+        "REDUCE_IDENTITY=" + std::to_string(get_identity(_desc.op)) + "u"};
+    if (_desc.op == BatchReduceOp::Min) {
+        defs.emplace_back("REDUCE_OP_MIN");
+    } else if (_desc.op == BatchReduceOp::Max) {
+        defs.emplace_back("REDUCE_OP_MAX");
+    }
+
+    _segLists = std::make_unique<GPUBuffer>(
+        (U64)numSegments * 2 * sizeof(U32), BufferUsage::Storage);
+    _counters =
+        std::make_unique<GPUBuffer>(2 * sizeof(U32), BufferUsage::Storage);
+
+    // Reset the class counters:
+    _cpass->add_simple_compute({.shaderFile = "tests/reduction/batchreduce_init",
+                                .entries = {_counters->as_rw_sto()},
+                                .dims = {1}});
+
+    // Sort the segments by size class:
+    U32 groupsX = 0;
+    U32 groupsY = 0;
+    U32 numGroups = (numSegments + wgSize - 1) / wgSize;
+    GPUBuffer* params = add_params(numGroups, groupsX, groupsY);
+
+    StringVector classifyDefs = defs;
+    classifyDefs.emplace_back("SMALL_MAX=" +
+                              std::to_string(_desc.smallSegmentMax));
+    _cpass->add_simple_compute(
+        {.shaderFile = "tests/reduction/batchreduce_classify",
+         .entries = {_desc.offsets->as_sto(), _output->as_rw_sto(),
+                     _segLists->as_rw_sto(), _counters->as_rw_sto(),
+                     params->as_sto()},
+         .defs = classifyDefs,
+         .dims = {groupsX, groupsY}});
+
+    // Small segments, one slice of threads per segment:
+    U32 slicesPerGroup = wgSize / _desc.sliceSize;
+    numGroups = std::min((numSegments + slicesPerGroup - 1) / slicesPerGroup,
+                         _desc.maxWorkgroups);
+    params = add_params(numGroups, groupsX, groupsY);
+
+    StringVector smallDefs = defs;
+    smallDefs.emplace_back("SLICE_SIZE=" + std::to_string(_desc.sliceSize));
+    _cpass->add_simple_compute(
+        {.shaderFile = "tests/reduction/batchreduce_segments",
+         .entries = {_desc.input->as_sto(), _desc.offsets->as_sto(),
+                     _output->as_rw_sto(), _segLists->as_sto(),
+                     _counters->as_sto(), params->as_sto()},
+         .defs = smallDefs,
+         .dims = {groupsX, groupsY}});
+
+    // Large segments, one workgroup per segment:
+    numGroups = std::min(numSegments, _desc.maxWorkgroups);
+    params = add_params(numGroups, groupsX, groupsY);
+
+    StringVector largeDefs = defs;
+    largeDefs.emplace_back("SLICE_SIZE=" + std::to_string(wgSize));
+    largeDefs.emplace_back("LARGE_CLASS");
+    _cpass->add_simple_compute(
+        {.shaderFile = "tests/reduction/batchreduce_segments",
+         .entries = {_desc.input->as_sto(), _desc.offsets->as_sto(),
+                     _output->as_rw_sto(), _segLists->as_sto(),
+                     _counters->as_sto(), params->as_sto()},
+         .defs = largeDefs,
+         .dims = {groupsX, groupsY}});
+
+    logDEBUG("GPUBatchedReducer: {} segments, slices of {} threads for "
+             "segments up to {} elements",
+             numSegments, _desc.sliceSize, _desc.smallSegmentMax);
+}
+
+void GPUBatchedReducer::execute() { _cpass->execute(); }
+
+} // namespace nv
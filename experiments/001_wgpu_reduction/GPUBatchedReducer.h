@@ -0,0 +1,99 @@
+#ifndef NV_GPUBATCHEDREDUCER_H_
+#define NV_GPUBATCHEDREDUCER_H_
+
+#include <GPUReducer.h>
+
+namespace nv {
+
+enum class BatchReduceOp : U8 {
+    Sum,
+    Min,
+    Max,
+};
+
+struct GPUBatchedReducerDesc {
+    /** Input buffer containing the u32 values of all the segments. */
+    GPUBuffer* input{nullptr};
+
+    /** Buffer with numSegments+1 u32 offsets: segment s covers the input
+    elements in [offsets[s], offsets[s+1]). */
+    GPUBuffer* offsets{nullptr};
+
+    /** Number of segments. */
+    U32 numSegments{0};
+
+    /** Optional output buffer with one u32 per segment (a new one is
+    allocated if not provided). */
+    GPUBuffer* output{nullptr};
+
+    /** Reduction operator. */
+    BatchReduceOp op{BatchReduceOp::Sum};
+
+    /** Workgroup size of the reduction kernels. */
+    U32 workgroupSize{256};
+
+    /** Number of threads reducing one small segment. */
+    U32 sliceSize{32};
+
+    /** Max number of elements of a small segment (larger segments are
+    reduced by a full workgroup). */
+    U32 smallSegmentMax{1024};
+
+    /** Max number of workgroups dispatched for each size class (each
+    workgroup loops over the segments of the class). */
+    U32 maxWorkgroups{4096};
+
+    /** Max number of workgroups per dispatch dimension. */
+    U32 maxWorkgroupsPerDimension{kDefaultMaxWorkgroupsPerDimension};
+
+    /** Optional compute pass to append the reduction steps to. */
+    WGPUComputePass* cpass{nullptr};
+};
+
+/**
+ * Reduction of many small independent segments of a buffer in a fixed number
+ * of dispatches (instead of one reduction per segment): the segments are
+ * first sorted by size class on the GPU, then small segments are reduced by
+ * slices of sliceSize threads and large segments by full workgroups. The
+ * output contains one value per segment.
+ */
+class NVGPU_EXPORT GPUBatchedReducer : public RefObject {
+  public:
+    explicit GPUBatchedReducer(const GPUBatchedReducerDesc& desc);
+    ~GPUBatchedReducer() override;
+
+    static auto create(const GPUBatchedReducerDesc& desc)
+        -> RefPtr<GPUBatchedReducer>;
+
+    /** Get the compute pass performing the reduction. */
+    auto get_compute_pass() -> WGPUComputePass& { return *_cpass; }
+
+    /** Get the output buffer (one value per segment). */
+    auto get_output() -> GPUBuffer& { return *_output; }
+
+    /** Get the identity value of a reduction operator. */
+    static auto get_identity(BatchReduceOp op) -> U32;
+
+    /** Execute the reduction immediately. */
+    void execute();
+
+  protected:
+    GPUBatchedReducerDesc _desc;
+    RefPtr<WGPUComputePass> _cpass;
+    GPUBuffer* _output{nullptr};
+
+    std::unique_ptr<GPUBuffer> _ownedOutput;
+    std::unique_ptr<GPUBuffer> _segLists;
+    std::unique_ptr<GPUBuffer> _counters;
+    Vector<std::unique_ptr<GPUBuffer>> _params;
+
+    /** Add the params buffer for a step dispatching numGroups workgroups. */
+    auto add_params(U32 numGroups, U32& groupsX, U32& groupsY) -> GPUBuffer*;
+
+    /** Build the classification and reduction steps. */
+    void build_steps();
+};
+
+} // namespace nv
+
+#endif
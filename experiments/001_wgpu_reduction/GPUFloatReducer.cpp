@@ -0,0 +1,68 @@
+#include <GPUFloatReducer.h>
+#include <GPUReducer.h>
+
+using namespace wgpu;
+
+namespace nv {
+
+GPUFloatReducer::GPUFloatReducer(const GPUFloatReducerDesc& desc)
+    : _desc(desc) {
+    NVCHK(_desc.input != nullptr, "GPUFloatReducer: invalid input buffer.");
+    NVCHK(_desc.count > 0, "GPUFloatReducer: cannot reduce empty input.");
+    NVCHK(_desc.workgroupSize > 0 &&
+              (_desc.workgroupSize & (_desc.workgroupSize - 1)) == 0,
+          "GPUFloatReducer: workgroup size {} is not a power of 2.",
+          _desc.workgroupSize);
+    NVCHK(_desc.gridFactor > 0, "GPUFloatReducer: invalid grid factor.");
+
+    _output = _desc.output;
+    if (_output == nullptr) {
+        _ownedOutput = std::make_unique<GPUBuffer>(
+            sizeof(F32), BufferUsage::Storage | BufferUsage::CopySrc);
+        _output = _ownedOutput.get();
+    }
+
+    build_steps();
+};
+
+GPUFloatReducer::~GPUFloatReducer() = default;
+
+auto GPUFloatReducer::create(const GPUFloatReducerDesc& desc)
+    -> RefPtr<GPUFloatReducer> {
+    return nv::create<GPUFloatReducer>(desc);
+}
+
+void GPUFloatReducer::build_steps() {
+    StringVector defs = {"WG_SIZE=" + std::to_string(_desc.workgroupSize),
+                         "GRID_FACTOR=" + std::to_string(_desc.gridFactor)};
+    if (_desc.useKahan) {
+        defs.emplace_back("KAHAN");
+    }
+
+    // The partials are (sum, compensation) pairs with Kahan summation:
+    StringVector partialDefs = defs;
+    if (_desc.useKahan) {
+        partialDefs.emplace_back("PAIR_INPUT");
+    }
+
+    _cpass = create_ref_object<WGPUComputePass>();
+
+    GPUReducer::add_multipass_steps(
+        *_cpass,
+        {.shaderFile = "tests/reduction/reduce_float",
+         .name = "GPUFloatReducer",
+         .input = _desc.input,
+         .count = _desc.count,
+         .output = _output,
+         .gridSize = _desc.workgroupSize * _desc.gridFactor,
+         .partialSize = _desc.useKahan ? 2 * sizeof(F32) : sizeof(F32),
+         .maxWorkgroupsPerDimension = _desc.maxWorkgroupsPerDimension,
+         .firstDefs = defs,
+         .defs = partialDefs,
+         .lastDefs = {"FINAL_OUTPUT"}},
+        _partials, _params);
+}
+
+void GPUFloatReducer::execute() { _cpass->execute(); }
+
+} // namespace nv
@@ -0,0 +1,73 @@
+#ifndef NV_GPUFLOATREDUCER_H_
+#define NV_GPUFLOATREDUCER_H_
+
+#include <GPUReducer.h>
+
+namespace nv {
+
+struct GPUFloatReducerDesc {
+    /** Input buffer containing the f32 values to reduce. */
+    GPUBuffer* input{nullptr};
+
+    /** Number of elements to reduce from the input buffer. */
+    U32 count{0};
+
+    /** Optional output buffer (a new one is allocated if not provided). */
+    GPUBuffer* output{nullptr};
+
+    /** Workgroup size used for all the reduction steps. */
+    U32 workgroupSize{256};
+
+    /** Number of elements accumulated by each thread in a step. */
+    U32 gridFactor{8};
+
+    /** Max number of workgroups per dispatch dimension. */
+    U32 maxWorkgroupsPerDimension{kDefaultMaxWorkgroupsPerDimension};
+
+    /** Use Kahan compensated summation. */
+    bool useKahan{false};
+};
+
+/**
+ * Deterministic multi-pass sum reduction of f32 elements: the partials are
+ * written to fixed slots and combined in a fixed pairwise tree, so the
+ * result only depends on the input, the workgroup size and the grid factor
+ * (not on the scheduling of the workgroups). Optionally uses Kahan
+ * compensation to limit the rounding errors on large inputs.
+ */
+class NVGPU_EXPORT GPUFloatReducer : public RefObject {
+  public:
+    explicit GPUFloatReducer(const GPUFloatReducerDesc& desc);
+    ~GPUFloatReducer() override;
+
+    static auto create(const GPUFloatReducerDesc& desc)
+        -> RefPtr<GPUFloatReducer>;
+
+    /** Get the compute pass performing the full reduction. */
+    auto get_compute_pass() -> WGPUComputePass& { return *_cpass; }
+
+    /** Get the buffer where the final f32 result is written. */
+    auto get_output() -> GPUBuffer& { return *_output; }
+
+    /** Get the number of chained reduction steps. */
+    auto get_num_steps() const -> U32 { return (U32)_params.size(); }
+
+    /** Execute the reduction immediately. */
+    void execute();
+
+  protected:
+    GPUFloatReducerDesc _desc;
+    RefPtr<WGPUComputePass> _cpass;
+    GPUBuffer* _output{nullptr};
+
+    std::unique_ptr<GPUBuffer> _ownedOutput;
+    std::unique_ptr<GPUBuffer> _partials[2];
+    Vector<std::unique_ptr<GPUBuffer>> _params;
+
+    /** Build the chain of reduction steps. */
+    void build_steps();
+};
+
+} // namespace nv
+
+#endif
@@ -0,0 +1,98 @@
+#include <GPUHistogram.h>
+#include <GPUReducer.h>
+
+using namespace wgpu;
+
+namespace nv {
+
+GPUHistogram::GPUHistogram(const GPUHistogramDesc& desc) : _desc(desc) {
+    NVCHK(_desc.input != nullptr, "GPUHistogram: invalid input buffer.");
+    NVCHK(_desc.count > 0, "GPUHistogram: empty input.");
+    NVCHK(_desc.numBins >= 16 && _desc.numBins <= 65536 &&
+              (_desc.numBins & (_desc.numBins - 1)) == 0,
+          "GPUHistogram: unsupported number of bins {}.", _desc.numBins);
+    NVCHK(_desc.maxWorkgroupBins > 0 &&
+              (_desc.maxWorkgroupBins & (_desc.maxWorkgroupBins - 1)) == 0,
+          "GPUHistogram: max workgroup bins {} is not a power of 2.",
+          _desc.maxWorkgroupBins);
+    NVCHK(_desc.shift < 32, "GPUHistogram: invalid shift {}.", _desc.shift);
+
+    _output = _desc.output;
+    if (_output == nullptr) {
+        _ownedOutput = std::make_unique<GPUBuffer>(
+            (U64)_desc.numBins * sizeof(U32),
+            BufferUsage::Storage | BufferUsage::CopySrc);
+        _output = _ownedOutput.get();
+    }
+
+    _cpass = _desc.cpass != nullptr ? RefPtr<WGPUComputePass>(_desc.cpass)
+                                    : create_ref_object<WGPUComputePass>();
+
+    build_steps();
+};
+
+GPUHistogram::~GPUHistogram() = default;
+
+auto GPUHistogram::create(const GPUHistogramDesc& desc)
+    -> RefPtr<GPUHistogram> {
+    return nv::create<GPUHistogram>(desc);
+}
+
+void GPUHistogram::build_steps() {
+    U32 wgSize = _desc.workgroupSize;
+
+    // Clear the global bins:
+    U32 clearParams[1] = {_desc.numBins};
+    GPUBuffer* params = _params
+                            .emplace_back(std::make_unique<GPUBuffer>(
+                                sizeof(clearParams), BufferUsage::Storage,
+                                clearParams))
+                            .get();
+    _cpass->add_simple_compute(
+        {.shaderFile = "tests/reduction/histogram_clear",
+         .entries = {_output->as_rw_sto(), params->as_sto()},
+         .defs = {"WG_SIZE=" + std::to_string(wgSize)},
+         .dims = {(_desc.numBins + wgSize - 1) / wgSize}});
+
+    U32 binsPerPass = std::min(_desc.numBins, _desc.maxWorkgroupBins);
+    _numPasses = _desc.privatized ? _desc.numBins / binsPerPass : 1;
+
+    StringVector defs = {"WG_SIZE=" + std::to_string(wgSize),
+                         "GRID_FACTOR=" + std::to_string(_desc.gridFactor),
+                         "NUM_BINS=" + std::to_string(_desc.numBins),
+                         "BINS_PER_PASS=" + std::to_string(binsPerPass)};
+    if (!_desc.privatized) {
+        defs.emplace_back("GLOBAL_ATOMICS");
+    }
+
+    U32 gridSize = wgSize * _desc.gridFactor;
+    U32 numGroups = (U32)(((U64)_desc.count + gridSize - 1) / gridSize);
+    U32 groupsX = 0;
+    U32 groupsY = 0;
+    GPUReducer::get_dispatch_size(numGroups, _desc.maxWorkgroupsPerDimension,
+                                  groupsX, groupsY);
+
+    logDEBUG("GPUHistogram: {} elements in {} bins, {} pass(es) of {} bins",
+             _desc.count, _desc.numBins, _numPasses, binsPerPass);
+
+    for (U32 pass = 0; pass < _numPasses; ++pass) {
+        U32 countParams[5] = {_desc.count, numGroups, groupsX, _desc.shift,
+                              pass * binsPerPass};
+        params = _params
+                     .emplace_back(std::make_unique<GPUBuffer>(
+                         sizeof(countParams), BufferUsage::Storage,
+                         countParams))
+                     .get();
+
+        _cpass->add_simple_compute(
+            {.shaderFile = "tests/reduction/histogram_private",
+             .entries = {_desc.input->as_sto(), _output->as_rw_sto(),
+                         params->as_sto()},
+             .defs = defs,
+             .dims = {groupsX, groupsY}});
+    }
+}
+
+void GPUHistogram::execute() { _cpass->execute(); }
+
+} // namespace nv
@@ -0,0 +1,85 @@
+#ifndef NV_GPUHISTOGRAM_H_
+#define NV_GPUHISTOGRAM_H_
+
+#include <GPUReducer.h>
+
+namespace nv {
+
+struct GPUHistogramDesc {
+    /** Input buffer containing the u32 values. */
+    GPUBuffer* input{nullptr};
+
+    /** Number of elements in the input buffer. */
+    U32 count{0};
+
+    /** Number of bins (power of 2 in [16, 65536]). */
+    U32 numBins{256};
+
+    /** The bin of a value is (value >> shift) & (numBins - 1). */
+    U32 shift{0};
+
+    /** Optional output buffer with numBins u32 counts (a new one is
+    allocated if not provided). */
+    GPUBuffer* output{nullptr};
+
+    /** Workgroup size of the histogram kernel. */
+    U32 workgroupSize{256};
+
+    /** Number of elements counted by each thread. */
+    U32 gridFactor{8};
+
+    /** Max number of bins kept in workgroup memory (4096 bins fill the 16KB
+    guaranteed by WebGPU): larger histograms need several passes. */
+    U32 maxWorkgroupBins{4096};
+
+    /** Max number of workgroups per dispatch dimension. */
+    U32 maxWorkgroupsPerDimension{kDefaultMaxWorkgroupsPerDimension};
+
+    /** Use workgroup private bins (or only global atomics otherwise). */
+    bool privatized{true};
+
+    /** Optional compute pass to append the histogram steps to. */
+    WGPUComputePass* cpass{nullptr};
+};
+
+/**
+ * Histogram of u32 values: each workgroup accumulates in private bins in
+ * workgroup memory, merged into the global bins with atomics at the end. When
+ * the bins don't fit in workgroup memory, one pass is done per range of
+ * maxWorkgroupBins bins.
+ */
+class NVGPU_EXPORT GPUHistogram : public RefObject {
+  public:
+    explicit GPUHistogram(const GPUHistogramDesc& desc);
+    ~GPUHistogram() override;
+
+    static auto create(const GPUHistogramDesc& desc) -> RefPtr<GPUHistogram>;
+
+    /** Get the compute pass computing the histogram. */
+    auto get_compute_pass() -> WGPUComputePass& { return *_cpass; }
+
+    /** Get the output buffer (one u32 count per bin). */
+    auto get_output() -> GPUBuffer& { return *_output; }
+
+    /** Get the number of passes over the input. */
+    auto get_num_passes() const -> U32 { return _numPasses; }
+
+    /** Execute the histogram computation immediately. */
+    void execute();
+
+  protected:
+    GPUHistogramDesc _desc;
+    RefPtr<WGPUComputePass> _cpass;
+    GPUBuffer* _output{nullptr};
+    U32 _numPasses{1};
+
+    std::unique_ptr<GPUBuffer> _ownedOutput;
+    Vector<std::unique_ptr<GPUBuffer>> _params;
+
+    /** Build the clear and counting steps. */
+    void build_steps();
+};
+
+} // namespace nv
+
+#endif
@@ -0,0 +1,137 @@
+#include <GPUMipReducer.h>
+#include <GPUReducer.h>
+
+using namespace wgpu;
+
+namespace nv {
+
+GPUMipReducer::GPUMipReducer(const GPUMipReducerDesc& desc) : _desc(desc) {
+    bool fromBuffer = _desc.source == MipSource::Buffer;
+    NVCHK(fromBuffer ? _desc.input != nullptr : _desc.texture != nullptr,
+          "GPUMipReducer: invalid input buffer or texture.");
+    NVCHK(_desc.width > 0 && _desc.height > 0,
+          "GPUMipReducer: invalid source size {}x{}.", _desc.width,
+          _desc.height);
+
+    // Level 0 is the source layer (its offset in the input buffer, or its
+    // index in the texture array):
+    _levels.push_back(
+        {.width = _desc.width,
+         .height = _desc.height,
+         .offset = fromBuffer ? _desc.layer * _desc.width * _desc.height
+                              : _desc.layer});
+
+    U32 offset = 0;
+    while (_levels.back().width > 1 || _levels.back().height > 1) {
+        const auto& prev = _levels.back();
+        Level lvl{.width = (prev.width + 1) / 2,
+                  .height = (prev.height + 1) / 2,
+                  .offset = offset};
+        offset += lvl.width * lvl.height;
+        _levels.push_back(lvl);
+    }
+    NVCHK(_levels.size() > 1 && _levels.size() <= kMaxLevels,
+          "GPUMipReducer: unsupported source size {}x{}.", _desc.width,
+          _desc.height);
+
+    _output = _desc.output;
+    if (_output == nullptr) {
+        _ownedOutput = std::make_unique<GPUBuffer>(
+            (U64)offset * sizeof(F32),
+            BufferUsage::Storage | BufferUsage::CopySrc);
+        _output = _ownedOutput.get();
+    }
+
+    // The counter is reset by the last workgroup after each execution:
+    if (_desc.singleDispatch) {
+        U32 zero = 0;
+        _counter = std::make_unique<GPUBuffer>(sizeof(U32),
+                                               BufferUsage::Storage, &zero);
+    }
+
+    U32 tilesX = (_desc.width + kTileSize - 1) / kTileSize;
+    U32 tilesY = (_desc.height + kTileSize - 1) / kTileSize;
+    U32 numTiles = tilesX * tilesY;
+
+    U32 groupsX = 0;
+    U32 groupsY = 0;
+    GPUReducer::get_dispatch_size(numTiles, _desc.maxWorkgroupsPerDimension,
+                                  groupsX, groupsY);
+
+    // Same layout as Params in mip_reduce:
+    Vector<U32> params(4 + kMaxLevels * 4, 0);
+    params[0] = tilesX;
+    params[1] = numTiles;
+    params[2] = groupsX;
+    params[3] = get_num_levels();
+    memcpy(params.data() + 4, _levels.data(), _levels.size() * sizeof(Level));
+    _params = std::make_unique<GPUBuffer>(
+        params.size() * sizeof(U32), BufferUsage::Storage, params.data());
+
+    const char* opDef = _desc.op == MipReduceOp::Min   ? "MIP_OP_MIN"
+                        : _desc.op == MipReduceOp::Max ? "MIP_OP_MAX"
+                                                       : "MIP_OP_AVG";
+
+    StringVector defs = {"WG_SIZE=256", opDef};
+    switch (_desc.source) {
+    case MipSource::Texture:
+        defs.emplace_back("TEXTURE_INPUT");
+        break;
+    case MipSource::TextureArray:
+        defs.emplace_back("TEXTURE_ARRAY_INPUT");
+        break;
+    case MipSource::StorageTextureArray:
+        defs.emplace_back("STORAGE_ARRAY_INPUT");
+        defs.emplace_back("STORAGE_FORMAT=" + _desc.storageFormat);
+        break;
+    default:
+        break;
+    }
+
+    logDEBUG("GPUMipReducer: {}x{} source, {} levels, {} tiles", _desc.width,
+             _desc.height, get_num_levels(), numTiles);
+
+    BindEntry source = fromBuffer ? _desc.input->as_sto()
+                                  : BindEntry{.textureView = _desc.texture};
+
+    _cpass = _desc.cpass != nullptr ? RefPtr<WGPUComputePass>(_desc.cpass)
+                                    : create_ref_object<WGPUComputePass>();
+    if (_desc.singleDispatch) {
+        _cpass->add_simple_compute(
+            {.shaderFile = "tests/reduction/mip_reduce",
+             .entries = {source, _output->as_rw_sto(), _counter->as_rw_sto(),
+                         _params->as_sto()},
+             .defs = defs,
+             .dims = {groupsX, groupsY}});
+        return;
+    }
+
+    // Portable fallback: the dispatch boundary makes the tile levels visible
+    // to the top levels dispatch:
+    StringVector tileDefs = defs;
+    tileDefs.emplace_back("SPLIT_TOP_LEVELS");
+    _cpass->add_simple_compute(
+        {.shaderFile = "tests/reduction/mip_reduce",
+         .entries = {source, _output->as_rw_sto(), _params->as_sto()},
+         .defs = tileDefs,
+         .dims = {groupsX, groupsY}});
+
+    if (get_num_levels() > kTileLevels) {
+        _cpass->add_simple_compute(
+            {.shaderFile = "tests/reduction/mip_reduce",
+             .entries = {_output->as_rw_sto(), _params->as_sto()},
+             .defs = {"WG_SIZE=256", opDef, "TOP_LEVELS_PASS"},
+             .dims = {1}});
+    }
+};
+
+GPUMipReducer::~GPUMipReducer() = default;
+
+auto GPUMipReducer::create(const GPUMipReducerDesc& desc)
+    -> RefPtr<GPUMipReducer> {
+    return nv::create<GPUMipReducer>(desc);
+}
+
+void GPUMipReducer::execute() { _cpass->execute(); }
+
+} // namespace nv
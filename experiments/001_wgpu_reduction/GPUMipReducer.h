@@ -0,0 +1,139 @@
+#ifndef NV_GPUMIPREDUCER_H_
+#define NV_GPUMIPREDUCER_H_
+
+#include <GPUReducer.h>
+
+namespace nv {
+
+enum class MipReduceOp : U8 {
+    Min,
+    Max,
+    Average,
+};
+
+enum class MipSource : U8 {
+    /** f32 texels in the input buffer. */
+    Buffer,
+    /** First channel of a texture_2d<f32>. */
+    Texture,
+    /** First channel of a layer of a texture_2d_array<f32>. */
+    TextureArray,
+    /** First channel of a layer of a read-only storage texture array (eg.
+    the texture_storage_2d_array targets of the voronoi kernels). */
+    StorageTextureArray,
+};
+
+struct GPUMipReducerDesc {
+    /** Input buffer containing the f32 texels (row major, with the layers
+    stored one after the other for a texture array). */
+    GPUBuffer* input{nullptr};
+
+    /** Size of the source level. */
+    U32 width{0};
+    U32 height{0};
+
+    /** Layer of the source texture array to reduce. */
+    U32 layer{0};
+
+    /** Reduction operator. */
+    MipReduceOp op{MipReduceOp::Max};
+
+    /** Optional output buffer receiving all the levels after the source one
+    (a new one is allocated if not provided). */
+    GPUBuffer* output{nullptr};
+
+    /** Max number of workgroups per dispatch dimension. */
+    U32 maxWorkgroupsPerDimension{kDefaultMaxWorkgroupsPerDimension};
+
+    /** Optional compute pass to append the reduction to. */
+    WGPUComputePass* cpass{nullptr};
+
+    /** Source of the first level (the input buffer or the texture view). */
+    MipSource source{MipSource::Buffer};
+
+    /** Source texture view for the texture sources (with all the layers for
+    the arrays, the level to reduce is selected by layer). */
+    wgpu::TextureView texture{nullptr};
+
+    /** WGSL texel format of the storage texture source. */
+    String storageFormat{"rgba8unorm"};
+
+    /** Compute the top levels in the tile dispatch (last workgroup), or in
+    a second dispatch (portable fallback, cf. GPUMipReducer). */
+    bool singleDispatch{true};
+};
+
+/**
+ * Single dispatch reduction of a 2D image to a full mip chain (eg. Hi-Z depth
+ * pyramid or luminance average): each workgroup builds 6 levels of a 64x64
+ * tile in workgroup memory and the last workgroup to finish computes the top
+ * levels. Level k has the size ceil(size[k-1] / 2) down to 1x1, and all the
+ * levels are packed in the output buffer (cf. get_level_offset()). The
+ * source level is read directly from a buffer or from a texture (layer).
+ * Note: the single dispatch mode assumes that a storageBarrier() followed by
+ * the relaxed atomic counter increment makes the tile levels written by the
+ * other workgroups visible to the last one. The WGSL memory model doesn't
+ * guarantee it (barriers only synchronize a workgroup), so on backends where
+ * it doesn't hold, use singleDispatch = false to compute the top levels in a
+ * second dispatch instead.
+ */
+class NVGPU_EXPORT GPUMipReducer : public RefObject {
+  public:
+    /** Number of source texels per tile side. */
+    static constexpr U32 kTileSize = 64;
+
+    /** Number of levels computed per tile (log2(kTileSize)). */
+    static constexpr U32 kTileLevels = 6;
+
+    /** Max number of levels (including the source level). */
+    static constexpr U32 kMaxLevels = 16;
+
+    explicit GPUMipReducer(const GPUMipReducerDesc& desc);
+    ~GPUMipReducer() override;
+
+    static auto create(const GPUMipReducerDesc& desc) -> RefPtr<GPUMipReducer>;
+
+    /** Get the compute pass performing the reduction. */
+    auto get_compute_pass() -> WGPUComputePass& { return *_cpass; }
+
+    /** Get the output buffer. */
+    auto get_output() -> GPUBuffer& { return *_output; }
+
+    /** Get the number of levels in the output (the source level excluded). */
+    auto get_num_levels() const -> U32 { return (U32)_levels.size() - 1; }
+
+    /** Get the size of a level (level 0 is the source). */
+    auto get_level_size(U32 level) const -> Vec2u {
+        return {_levels[level].width, _levels[level].height};
+    }
+
+    /** Get the offset in elements of a level in the output buffer. */
+    auto get_level_offset(U32 level) const -> U32 {
+        return _levels[level].offset;
+    }
+
+    /** Execute the reduction immediately. */
+    void execute();
+
+  protected:
+    /** Same layout as Level in mip_reduce. */
+    struct Level {
+        U32 width;
+        U32 height;
+        U32 offset;
+        U32 pad;
+    };
+
+    GPUMipReducerDesc _desc;
+    RefPtr<WGPUComputePass> _cpass;
+    GPUBuffer* _output{nullptr};
+    Vector<Level> _levels;
+
+    std::unique_ptr<GPUBuffer> _ownedOutput;
+    std::unique_ptr<GPUBuffer> _counter;
+    std::unique_ptr<GPUBuffer> _params;
+};
+
+} // namespace nv
+
+#endif
@@ -0,0 +1,81 @@
+#include <GPURandomFill.h>
+#include <GPUReducer.h>
+
+using namespace wgpu;
+
+namespace nv {
+
+GPURandomFill::GPURandomFill(const GPURandomFillDesc& desc) : _desc(desc) {
+    NVCHK(_desc.output != nullptr, "GPURandomFill: invalid output buffer.");
+    NVCHK(_desc.count > 0, "GPURandomFill: nothing to fill.");
+    NVCHK((U64)_desc.offset + _desc.count + 4 <= 0xFFFFFFFFULL,
+          "GPURandomFill: sequence range too large.");
+
+    bool isFloat = _desc.type == RandomFillType::UniformFloat;
+    if (isFloat) {
+        NVCHK(_desc.maxFloat >= _desc.minFloat,
+              "GPURandomFill: invalid float range.");
+    } else {
+        NVCHK(_desc.maxInt >= _desc.minInt,
+              "GPURandomFill: invalid integer range.");
+    }
+
+    // Each thread writes the 4 elements of one generator counter (the first
+    // and last counters may be partial for unaligned offsets):
+    U32 firstBlock = _desc.offset / 4;
+    U32 lastBlock = (_desc.offset + _desc.count - 1) / 4;
+    U32 numThreads = lastBlock - firstBlock + 1;
+    U32 numGroups = (numThreads + _desc.workgroupSize - 1) / _desc.workgroupSize;
+
+    U32 groupsX = 0;
+    U32 groupsY = 0;
+    GPUReducer::get_dispatch_size(numGroups, _desc.maxWorkgroupsPerDimension,
+                                  groupsX, groupsY);
+
+    U32 minVal = _desc.minInt;
+    // Note: the full u32 range wraps around to 0:
+    U32 range = _desc.maxInt - _desc.minInt + 1;
+    if (isFloat) {
+        F32 scale = _desc.maxFloat - _desc.minFloat;
+        memcpy(&minVal, &_desc.minFloat, sizeof(F32));
+        memcpy(&range, &scale, sizeof(F32));
+    }
+
+    // Same layout as Params in random_fill:
+    U32 params[10] = {_desc.count,
+                      _desc.offset,
+                      numGroups,
+                      groupsX,
+                      (U32)_desc.seed,
+                      (U32)(_desc.seed >> 32),
+                      _desc.stream,
+                      _desc.outputOffset,
+                      minVal,
+                      range};
+    _params = std::make_unique<GPUBuffer>(sizeof(params), BufferUsage::Storage,
+                                          params);
+
+    StringVector defs = {"WG_SIZE=" + std::to_string(_desc.workgroupSize)};
+    if (isFloat) {
+        defs.emplace_back("FLOAT_OUTPUT");
+    }
+
+    _cpass = _desc.cpass != nullptr ? RefPtr<WGPUComputePass>(_desc.cpass)
+                                    : create_ref_object<WGPUComputePass>();
+    _cpass->add_simple_compute(
+        {.shaderFile = "tests/reduction/random_fill",
+         .entries = {_desc.output->as_rw_sto(), _params->as_sto()},
+         .defs = defs,
+         .dims = {groupsX, groupsY}});
+};
+
+GPURandomFill::~GPURandomFill() = default;
+
+auto GPURandomFill::create(const GPURandomFillDesc& desc)
+    -> RefPtr<GPURandomFill> {
+    return nv::create<GPURandomFill>(desc);
+}
+
+void GPURandomFill::execute() { _cpass->execute(); }
+
+} // namespace nv
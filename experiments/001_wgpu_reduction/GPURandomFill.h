@@ -0,0 +1,84 @@
+#ifndef NV_GPURANDOMFILL_H_
+#define NV_GPURANDOMFILL_H_
+
+#include <GPUReducer.h>
+
+namespace nv {
+
+enum class RandomFillType : U8 {
+    /** Uniform u32 values in [minInt, maxInt]. */
+    UniformInt,
+    /** Uniform f32 values in [minFloat, maxFloat). */
+    UniformFloat,
+};
+
+struct GPURandomFillDesc {
+    /** Buffer to fill. */
+    GPUBuffer* output{nullptr};
+
+    /** Number of elements to write. */
+    U32 count{0};
+
+    /** Index of the first element in the random sequence. */
+    U32 offset{0};
+
+    /** Index of the first element written in the output buffer. */
+    U32 outputOffset{0};
+
+    /** Seed and stream selecting the random sequence. */
+    U64 seed{0};
+    U32 stream{0};
+
+    /** Type of values. */
+    RandomFillType type{RandomFillType::UniformInt};
+
+    /** Integer range (inclusive). */
+    U32 minInt{0};
+    U32 maxInt{0xFFFFFFFF};
+
+    /** Float range. */
+    F32 minFloat{0.0F};
+    F32 maxFloat{1.0F};
+
+    /** Workgroup size of the fill kernel. */
+    U32 workgroupSize{256};
+
+    /** Max number of workgroups per dispatch dimension. */
+    U32 maxWorkgroupsPerDimension{kDefaultMaxWorkgroupsPerDimension};
+
+    /** Optional compute pass to append the fill step to. */
+    WGPUComputePass* cpass{nullptr};
+};
+
+/**
+ * Fill a buffer with uniform random values directly on the GPU (Philox4x32-10
+ * counter-based generator), to avoid generating and uploading large inputs
+ * from the CPU. PhiloxRNG produces the same sequences on the CPU (bit
+ * identical for the integers and the floats in [0, 1), while scaled float
+ * ranges may differ by 1 ulp if the backend fuses the multiply-add).
+ */
+class NVGPU_EXPORT GPURandomFill : public RefObject {
+  public:
+    explicit GPURandomFill(const GPURandomFillDesc& desc);
+    ~GPURandomFill() override;
+
+    static auto create(const GPURandomFillDesc& desc) -> RefPtr<GPURandomFill>;
+
+    /** Get the compute pass filling the buffer. */
+    auto get_compute_pass() -> WGPUComputePass& { return *_cpass; }
+
+    /** Get the filled buffer. */
+    auto get_output() -> GPUBuffer& { return *_desc.output; }
+
+    /** Execute the fill immediately. */
+    void execute();
+
+  protected:
+    GPURandomFillDesc _desc;
+    RefPtr<WGPUComputePass> _cpass;
+    std::unique_ptr<GPUBuffer> _params;
+};
+
+} // namespace nv
+
+#endif
@@ -0,0 +1,198 @@
+#include <GPUReducer.h>
+
+using namespace wgpu;
+
+namespace nv {
+
+GPUReducer::GPUReducer(const GPUReducerDesc& desc) : _desc(desc) {
+    NVCHK(_desc.input != nullptr, "GPUReducer: invalid input buffer.");
+    NVCHK(_desc.count > 0, "GPUReducer: cannot reduce empty input.");
+    NVCHK(_desc.workgroupSize > 0 &&
+              (_desc.workgroupSize & (_desc.workgroupSize - 1)) == 0,
+          "GPUReducer: workgroup size {} is not a power of 2.",
+          _desc.workgroupSize);
+    NVCHK(_desc.gridFactor > 0, "GPUReducer: invalid grid factor.");
+
+    // Fall back on the shared-memory tree if subgroups are not available
+    // (subgroupAdd() can't propagate the carries of the wide accumulators):
+    _useSubgroups = _desc.useSubgroups && !_desc.wideAccumulator &&
+                    is_subgroups_supported();
+    if (_desc.useSubgroups && !_useSubgroups) {
+        logDEBUG("GPUReducer: subgroups not supported, using shared memory.");
+    }
+
+    _output = _desc.output;
+    if (_output == nullptr) {
+        _ownedOutput = std::make_unique<GPUBuffer>(
+            _desc.wideAccumulator ? sizeof(U64) : sizeof(U32),
+            BufferUsage::Storage | BufferUsage::CopySrc);
+        _output = _ownedOutput.get();
+    }
+
+    build_steps();
+};
+
+GPUReducer::~GPUReducer() = default;
+
+auto GPUReducer::create(const GPUReducerDesc& desc) -> RefPtr<GPUReducer> {
+    return nv::create<GPUReducer>(desc);
+}
+
+auto GPUReducer::is_subgroups_supported() -> bool {
+    auto* eng = WGPUEngine::instance();
+    return eng->get_device().HasFeature(FeatureName::Subgroups);
+}
+
+auto GPUReducer::get_device_limits() -> Limits {
+    auto* eng = WGPUEngine::instance();
+    SupportedLimits limits{};
+    eng->get_device().GetLimits(&limits);
+    return limits.limits;
+}
+
+auto GPUReducer::get_elements_per_word(InputFormat format) -> U32 {
+    switch (format) {
+    case InputFormat::PackedU8:
+        return 4;
+    case InputFormat::PackedU16:
+        return 2;
+    default:
+        return 1;
+    }
+}
+
+auto GPUReducer::get_input_format_defs(InputFormat format) -> StringVector {
+    switch (format) {
+    case InputFormat::PackedU8:
+        return {"PACKED_INPUT", "ELEM_BITS=8"};
+    case InputFormat::PackedU16:
+        return {"PACKED_INPUT", "ELEM_BITS=16"};
+    default:
+        return {};
+    }
+}
+
+void GPUReducer::get_dispatch_size(U32 numGroups, U32 maxDim, U32& groupsX,
+                                   U32& groupsY) {
+    if (numGroups <= maxDim) {
+        groupsX = numGroups;
+        groupsY = 1;
+        return;
+    }
+
+    // Fold the workgroups into a 2D grid as square as possible in X:
+    groupsY = (numGroups + maxDim - 1) / maxDim;
+    groupsX = (numGroups + groupsY - 1) / groupsY;
+    NVCHK(groupsY <= maxDim, "GPUReducer: too many workgroups: {}", numGroups);
+}
+
+void GPUReducer::add_multipass_steps(
+    WGPUComputePass& cpass, const MultiPassStepsDesc& desc,
+    std::unique_ptr<GPUBuffer> (&partials)[2],
+    Vector<std::unique_ptr<GPUBuffer>>& params) {
+    U32 gridSize = desc.gridSize;
+    NVCHK(gridSize > 0, "{}: invalid grid size.", desc.name);
+    U32 numItems = desc.numItems > 0 ? desc.numItems : desc.count;
+
+    // Allocate the ping-pong buffers for the partial results: the first step
+    // produces the largest number of partials.
+    U32 numPartials = (U32)(((U64)numItems + gridSize - 1) / gridSize);
+    if (numPartials > 1) {
+        partials[0] = std::make_unique<GPUBuffer>(
+            (U64)numPartials * desc.partialSize, BufferUsage::Storage);
+        U32 next = (numPartials + gridSize - 1) / gridSize;
+        if (next > 1) {
+            partials[1] = std::make_unique<GPUBuffer>(
+                (U64)next * desc.partialSize, BufferUsage::Storage);
+        }
+    }
+
+    GPUBuffer* src = desc.input;
+    U32 count = desc.count;
+    U32 pingPong = 0;
+
+    // Note: we always run at least one step, even for a single element, so
+    // that the result is written to the output buffer.
+    do {
+        bool first = src == desc.input;
+        U32 stepItems = first ? numItems : count;
+        U32 numGroups = (U32)(((U64)stepItems + gridSize - 1) / gridSize);
+        bool last = numGroups == 1;
+        GPUBuffer* dst = last ? desc.output : partials[pingPong].get();
+
+        U32 groupsX = 0;
+        U32 groupsY = 0;
+        get_dispatch_size(numGroups, desc.maxWorkgroupsPerDimension, groupsX,
+                          groupsY);
+
+        U32 stepParams[3] = {count, numGroups, groupsX};
+        params.emplace_back(std::make_unique<GPUBuffer>(
+            sizeof(stepParams), BufferUsage::Storage, stepParams));
+
+        StringVector stepDefs = first ? desc.firstDefs : desc.defs;
+        if (last) {
+            for (const auto& def : desc.lastDefs) {
+                stepDefs.push_back(def);
+            }
+        }
+
+        logDEBUG("{}: step {}: {} elements, {}x{} workgroups", desc.name,
+                 params.size() - 1, count, groupsX, groupsY);
+
+        cpass.add_simple_compute(
+            {.shaderFile = desc.shaderFile,
+             .entries = {src->as_sto(), dst->as_rw_sto(),
+                         params.back()->as_sto()},
+             .defs = stepDefs,
+             .dims = {groupsX, groupsY}});
+
+        src = dst;
+        count = numGroups;
+        pingPong = 1 - pingPong;
+    } while (count > 1);
+}
+
+void GPUReducer::build_steps() {
+    StringVector defs = {"WG_SIZE=" + std::to_string(_desc.workgroupSize),
+                         "GRID_FACTOR=" + std::to_string(_desc.gridFactor)};
+
+    _cpass = create_ref_object<WGPUComputePass>();
+
+    // The first step reads the user input, the next ones read the partials
+    // (as u64 values with wide accumulators):
+    if (_desc.wideAccumulator) {
+        defs.emplace_back("WIDE_ACCUM");
+    }
+    StringVector firstDefs = defs;
+    for (auto& def : get_input_format_defs(_desc.inputFormat)) {
+        firstDefs.push_back(def);
+    }
+    if (_desc.wideAccumulator) {
+        defs.emplace_back("WIDE_INPUT");
+    }
+
+    // The first step reads the packed words directly:
+    U32 elemsPerWord = get_elements_per_word(_desc.inputFormat);
+    U32 numWords = (U32)(((U64)_desc.count + elemsPerWord - 1) / elemsPerWord);
+
+    add_multipass_steps(
+        *_cpass,
+        {.shaderFile = _useSubgroups
+                           ? "tests/reduction/reduce_multipass_subgroups"
+                           : "tests/reduction/reduce_multipass",
+         .name = "GPUReducer",
+         .input = _desc.input,
+         .count = _desc.count,
+         .numItems = numWords,
+         .output = _output,
+         .gridSize = _desc.workgroupSize * _desc.gridFactor,
+         .partialSize = _desc.wideAccumulator ? sizeof(U64) : sizeof(U32),
+         .maxWorkgroupsPerDimension = _desc.maxWorkgroupsPerDimension,
+         .firstDefs = firstDefs,
+         .defs = defs},
+        _partials, _params);
+}
+
+void GPUReducer::execute() { _cpass->execute(); }
+
+} // namespace nv
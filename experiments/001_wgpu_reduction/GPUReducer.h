@@ -0,0 +1,168 @@
+#ifndef NV_GPUREDUCER_H_
+#define NV_GPUREDUCER_H_
+
+#include <gpu_common.h>
+
+namespace nv {
+
+/** Default max number of workgroups per dispatch dimension: the minimum
+maxComputeWorkgroupsPerDimension limit guaranteed by WebGPU, so it is valid on
+any device (cf. GPUReducer::get_device_limits() to use the actual limit). */
+constexpr U32 kDefaultMaxWorkgroupsPerDimension = 65535;
+
+enum class InputFormat : U8 {
+    /** One u32 per element. */
+    U32,
+    /** Four u8 elements packed in each u32 (little-endian). */
+    PackedU8,
+    /** Two u16 elements packed in each u32 (little-endian). */
+    PackedU16,
+};
+
+struct GPUReducerDesc {
+    /** Input buffer containing the values to reduce. */
+    GPUBuffer* input{nullptr};
+
+    /** Number of elements to reduce from the input buffer. */
+    U32 count{0};
+
+    /** Optional output buffer (a new one is allocated if not provided). */
+    GPUBuffer* output{nullptr};
+
+    /** Workgroup size used for all the reduction steps. */
+    U32 workgroupSize{256};
+
+    /** Number of elements accumulated by each thread in a step. */
+    U32 gridFactor{8};
+
+    /** Max number of workgroups per dispatch dimension. */
+    U32 maxWorkgroupsPerDimension{kDefaultMaxWorkgroupsPerDimension};
+
+    /** Use subgroupAdd() when the device supports the subgroups feature. */
+    bool useSubgroups{true};
+
+    /** Format of the input elements. */
+    InputFormat inputFormat{InputFormat::U32};
+
+    /** Accumulate on emulated u64 values (2 x u32 with carry) so that the
+    total doesn't wrap around: the output then contains a u64 value. */
+    bool wideAccumulator{false};
+};
+
+struct MultiPassStepsDesc {
+    /** Shader file used for all the steps. */
+    const char* shaderFile{nullptr};
+
+    /** Name used in the debug logs. */
+    const char* name{"GPUReducer"};
+
+    /** Input buffer read by the first step. */
+    GPUBuffer* input{nullptr};
+
+    /** Number of elements to reduce (written in the params of the first
+    step). */
+    U32 count{0};
+
+    /** Number of items read by the first step (0 to use count, e.g. the
+    number of words with packed inputs). */
+    U32 numItems{0};
+
+    /** Buffer where the last step writes the final result. */
+    GPUBuffer* output{nullptr};
+
+    /** Number of items reduced by each workgroup. */
+    U32 gridSize{0};
+
+    /** Size in bytes of one partial result. */
+    U64 partialSize{sizeof(U32)};
+
+    /** Max number of workgroups per dispatch dimension. */
+    U32 maxWorkgroupsPerDimension{kDefaultMaxWorkgroupsPerDimension};
+
+    /** Defines of the first step (reading the user input). */
+    StringVector firstDefs;
+
+    /** Defines of the next steps (reading the partials). */
+    StringVector defs;
+
+    /** Defines added to the last step (writing the output). */
+    StringVector lastDefs;
+};
+
+/**
+ * Multi-pass sum reduction of an arbitrary number of u32 elements (or u8/u16
+ * elements packed in u32 words).
+ * Each step writes one partial per workgroup, and steps are chained in a
+ * single compute pass until only one value remains (no global atomics).
+ */
+class NVGPU_EXPORT GPUReducer : public RefObject {
+  public:
+    explicit GPUReducer(const GPUReducerDesc& desc);
+    ~GPUReducer() override;
+
+    static auto create(const GPUReducerDesc& desc) -> RefPtr<GPUReducer>;
+
+    /** Get the compute pass performing the full reduction. */
+    auto get_compute_pass() -> WGPUComputePass& { return *_cpass; }
+
+    /** Get the buffer where the final result is written. */
+    auto get_output() -> GPUBuffer& { return *_output; }
+
+    /** Get the number of elements reduced. */
+    auto get_count() const -> U32 { return _desc.count; }
+
+    /** Check if the output contains a u64 value. */
+    auto is_wide() const -> bool { return _desc.wideAccumulator; }
+
+    /** Check if the subgroup kernel was selected. */
+    auto is_using_subgroups() const -> bool { return _useSubgroups; }
+
+    /** Check if the current device supports the subgroups feature. */
+    static auto is_subgroups_supported() -> bool;
+
+    /** Get the limits of the current device. */
+    static auto get_device_limits() -> wgpu::Limits;
+
+    /** Get the number of chained reduction steps. */
+    auto get_num_steps() const -> U32 { return (U32)_params.size(); }
+
+    /** Execute the reduction immediately. */
+    void execute();
+
+    /** Get the number of elements stored in each u32 of the input. */
+    static auto get_elements_per_word(InputFormat format) -> U32;
+
+    /** Get the shader defines for an input format. */
+    static auto get_input_format_defs(InputFormat format) -> StringVector;
+
+    /** Compute the 2D dispatch size for a given number of workgroups. */
+    static void get_dispatch_size(U32 numGroups, U32 maxDim, U32& groupsX,
+                                  U32& groupsY);
+
+    /** Add the chain of multi-pass reduction steps to a compute pass: each
+    step writes one partial per workgroup into the ping-pong partials
+    buffers (allocated here) until a single value is written to the output.
+    The params buffer of each step is appended to params. */
+    static void
+    add_multipass_steps(WGPUComputePass& cpass, const MultiPassStepsDesc& desc,
+                        std::unique_ptr<GPUBuffer> (&partials)[2],
+                        Vector<std::unique_ptr<GPUBuffer>>& params);
+
+  protected:
+    GPUReducerDesc _desc;
+    RefPtr<WGPUComputePass> _cpass;
+    GPUBuffer* _output{nullptr};
+    bool _useSubgroups{false};
+
+    /** Buffers allocated by this reducer. */
+    std::unique_ptr<GPUBuffer> _ownedOutput;
+    std::unique_ptr<GPUBuffer> _partials[2];
+    Vector<std::unique_ptr<GPUBuffer>> _params;
+
+    /** Build the chain of reduction steps. */
+    void build_steps();
+};
+
+} // namespace nv
+
+#endif
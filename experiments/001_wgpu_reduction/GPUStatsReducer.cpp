@@ -0,0 +1,79 @@
+#include <GPUReducer.h>
+#include <GPUStatsReducer.h>
+
+using namespace wgpu;
+
+namespace nv {
+
+GPUStatsReducer::GPUStatsReducer(const GPUStatsReducerDesc& desc)
+    : _desc(desc) {
+    NVCHK(_desc.input != nullptr, "GPUStatsReducer: invalid input buffer.");
+    NVCHK(_desc.count > 0, "GPUStatsReducer: cannot reduce empty input.");
+    NVCHK(_desc.workgroupSize > 0 &&
+              (_desc.workgroupSize & (_desc.workgroupSize - 1)) == 0,
+          "GPUStatsReducer: workgroup size {} is not a power of 2.",
+          _desc.workgroupSize);
+    NVCHK(_desc.gridFactor > 0, "GPUStatsReducer: invalid grid factor.");
+
+    // The arg variants are tracked together with the min/max values:
+    _desc.computeMin = _desc.computeMin || _desc.computeArgMin;
+    _desc.computeMax = _desc.computeMax || _desc.computeArgMax;
+
+    _output = std::make_unique<GPUBuffer>(
+        sizeof(GPUReduceStats), BufferUsage::Storage | BufferUsage::CopySrc);
+
+    build_steps();
+};
+
+GPUStatsReducer::~GPUStatsReducer() = default;
+
+auto GPUStatsReducer::create(const GPUStatsReducerDesc& desc)
+    -> RefPtr<GPUStatsReducer> {
+    return nv::create<GPUStatsReducer>(desc);
+}
+
+void GPUStatsReducer::build_steps() {
+    StringVector defs = {"WG_SIZE=" + std::to_string(_desc.workgroupSize),
+                         "GRID_FACTOR=" + std::to_string(_desc.gridFactor)};
+    if (_desc.computeMin) {
+        defs.emplace_back("STAT_MIN");
+    }
+    if (_desc.computeMax) {
+        defs.emplace_back("STAT_MAX");
+    }
+    if (_desc.computeSum) {
+        defs.emplace_back("STAT_SUM");
+    }
+    if (_desc.computeSumSquares) {
+        defs.emplace_back("STAT_SUMSQ");
+    }
+    if (_desc.computeArgMin) {
+        defs.emplace_back("STAT_ARGMIN");
+    }
+    if (_desc.computeArgMax) {
+        defs.emplace_back("STAT_ARGMAX");
+    }
+
+    _cpass = create_ref_object<WGPUComputePass>();
+
+    StringVector partialDefs = defs;
+    partialDefs.emplace_back("STATS_INPUT");
+
+    GPUReducer::add_multipass_steps(
+        *_cpass,
+        {.shaderFile = "tests/reduction/reduce_stats",
+         .name = "GPUStatsReducer",
+         .input = _desc.input,
+         .count = _desc.count,
+         .output = _output.get(),
+         .gridSize = _desc.workgroupSize * _desc.gridFactor,
+         .partialSize = sizeof(GPUReduceStats),
+         .maxWorkgroupsPerDimension = _desc.maxWorkgroupsPerDimension,
+         .firstDefs = defs,
+         .defs = partialDefs},
+        _partials, _params);
+}
+
+void GPUStatsReducer::execute() { _cpass->execute(); }
+
+} // namespace nv
@@ -0,0 +1,87 @@
+#ifndef NV_GPUSTATSREDUCER_H_
+#define NV_GPUSTATSREDUCER_H_
+
+#include <GPUReducer.h>
+
+namespace nv {
+
+/** Result of a GPUStatsReducer (same layout as Stats in reduce_stats). */
+struct GPUReduceStats {
+    F32 min;
+    F32 max;
+    F32 sum;
+    F32 sumSquares;
+    U32 argMin;
+    U32 argMax;
+    U32 pad0;
+    U32 pad1;
+};
+static_assert(sizeof(GPUReduceStats) == 32, "Invalid GPUReduceStats size");
+
+struct GPUStatsReducerDesc {
+    /** Input buffer containing the f32 values to reduce. */
+    GPUBuffer* input{nullptr};
+
+    /** Number of elements to reduce from the input buffer. */
+    U32 count{0};
+
+    /** Statistics to compute. */
+    bool computeMin{true};
+    bool computeMax{true};
+    bool computeSum{true};
+    bool computeSumSquares{false};
+
+    /** Track the index of the (first) min/max value. */
+    bool computeArgMin{false};
+    bool computeArgMax{false};
+
+    /** Workgroup size used for all the reduction steps. */
+    U32 workgroupSize{256};
+
+    /** Number of elements accumulated by each thread in a step. */
+    U32 gridFactor{8};
+
+    /** Max number of workgroups per dispatch dimension. */
+    U32 maxWorkgroupsPerDimension{kDefaultMaxWorkgroupsPerDimension};
+};
+
+/**
+ * Fused multi-pass reduction computing a configurable set of statistics
+ * (min, max, sum, sum of squares, argmin, argmax) on f32 elements from a
+ * single read of the input. The output buffer contains a GPUReduceStats.
+ */
+class NVGPU_EXPORT GPUStatsReducer : public RefObject {
+  public:
+    explicit GPUStatsReducer(const GPUStatsReducerDesc& desc);
+    ~GPUStatsReducer() override;
+
+    static auto create(const GPUStatsReducerDesc& desc)
+        -> RefPtr<GPUStatsReducer>;
+
+    /** Get the compute pass performing the full reduction. */
+    auto get_compute_pass() -> WGPUComputePass& { return *_cpass; }
+
+    /** Get the buffer where the final GPUReduceStats is written. */
+    auto get_output() -> GPUBuffer& { return *_output; }
+
+    /** Get the number of chained reduction steps. */
+    auto get_num_steps() const -> U32 { return (U32)_params.size(); }
+
+    /** Execute the reduction immediately. */
+    void execute();
+
+  protected:
+    GPUStatsReducerDesc _desc;
+    RefPtr<WGPUComputePass> _cpass;
+
+    std::unique_ptr<GPUBuffer> _output;
+    std::unique_ptr<GPUBuffer> _partials[2];
+    Vector<std::unique_ptr<GPUBuffer>> _params;
+
+    /** Build the chain of reduction steps. */
+    void build_steps();
+};
+
+} // namespace nv
+
+#endif
@@ -0,0 +1,77 @@
+#include <PhiloxRNG.h>
+
+namespace nv {
+
+namespace {
+
+constexpr U32 kPhiloxM0 = 0xD2511F53;
+constexpr U32 kPhiloxM1 = 0xCD9E8D57;
+constexpr U32 kPhiloxW0 = 0x9E3779B9;
+constexpr U32 kPhiloxW1 = 0xBB67AE85;
+
+} // namespace
+
+auto PhiloxRNG::generate_block(U64 block, U64 seed, U32 stream)
+    -> std::array<U32, 4> {
+    std::array<U32, 4> ctr = {(U32)block, (U32)(block >> 32), stream, 0};
+    U32 key0 = (U32)seed;
+    U32 key1 = (U32)(seed >> 32);
+
+    for (U32 i = 0; i < 10; ++i) {
+        if (i > 0) {
+            key0 += kPhiloxW0;
+            key1 += kPhiloxW1;
+        }
+        U64 r0 = (U64)kPhiloxM0 * ctr[0];
+        U64 r1 = (U64)kPhiloxM1 * ctr[2];
+        ctr = {(U32)(r1 >> 32) ^ ctr[1] ^ key0, (U32)r1,
+               (U32)(r0 >> 32) ^ ctr[3] ^ key1, (U32)r0};
+    }
+
+    return ctr;
+}
+
+auto PhiloxRNG::get_u32(U64 index) const -> U32 {
+    return generate_block(index / 4, _seed, _stream)[index % 4];
+}
+
+auto PhiloxRNG::uniform_int(U64 index, U32 minVal, U32 maxVal) const -> U32 {
+    return to_range(get_u32(index), minVal, maxVal - minVal + 1);
+}
+
+auto PhiloxRNG::uniform_float(U64 index, F32 minVal, F32 maxVal) const
+    -> F32 {
+    return minVal + to_unit_float(get_u32(index)) * (maxVal - minVal);
+}
+
+auto PhiloxRNG::uniform_int_vector(U64 count, U32 minVal, U32 maxVal,
+                                   U64 offset) const -> Vector<U32> {
+    Vector<U32> res(count);
+    U32 range = maxVal - minVal + 1;
+    std::array<U32, 4> rnd{};
+    for (U64 i = 0; i < count; ++i) {
+        U64 idx = offset + i;
+        if (i == 0 || idx % 4 == 0) {
+            rnd = generate_block(idx / 4, _seed, _stream);
+        }
+        res[i] = to_range(rnd[idx % 4], minVal, range);
+    }
+    return res;
+}
+
+auto PhiloxRNG::uniform_float_vector(U64 count, F32 minVal, F32 maxVal,
+                                     U64 offset) const -> Vector<F32> {
+    Vector<F32> res(count);
+    F32 scale = maxVal - minVal;
+    std::array<U32, 4> rnd{};
+    for (U64 i = 0; i < count; ++i) {
+        U64 idx = offset + i;
+        if (i == 0 || idx % 4 == 0) {
+            rnd = generate_block(idx / 4, _seed, _stream);
+        }
+        res[i] = minVal + to_unit_float(rnd[idx % 4]) * scale;
+    }
+    return res;
+}
+
+} // namespace nv
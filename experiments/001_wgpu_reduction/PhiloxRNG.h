@@ -0,0 +1,66 @@
+#ifndef NV_PHILOXRNG_H_
+#define NV_PHILOXRNG_H_
+
+#include <gpu_common.h>
+
+#include <array>
+
+namespace nv {
+
+/**
+ * CPU implementation of the Philox4x32-10 counter-based generator of
+ * base/philox: value i of a (seed, stream) sequence is word (i % 4) of the
+ * output for the counter (i / 4, stream), so any element can be computed
+ * directly, and the sequences are bit-identical to the ones written by
+ * GPURandomFill.
+ */
+class NVGPU_EXPORT PhiloxRNG {
+  public:
+    explicit PhiloxRNG(U64 seed = 0, U32 stream = 0)
+        : _seed(seed), _stream(stream) {}
+
+    /** Generate the 4 values of a counter block. */
+    static auto generate_block(U64 block, U64 seed, U32 stream)
+        -> std::array<U32, 4>;
+
+    /** Get the raw u32 value at index in the sequence. */
+    auto get_u32(U64 index) const -> U32;
+
+    /** Get a uniform integer in [minVal, maxVal] at index. */
+    auto uniform_int(U64 index, U32 minVal, U32 maxVal) const -> U32;
+
+    /** Get a uniform float in [minVal, maxVal) at index. */
+    auto uniform_float(U64 index, F32 minVal, F32 maxVal) const -> F32;
+
+    /** Generate count uniform integers in [minVal, maxVal] starting at the
+    index offset in the sequence. */
+    auto uniform_int_vector(U64 count, U32 minVal, U32 maxVal,
+                            U64 offset = 0) const -> Vector<U32>;
+
+    /** Generate count uniform floats in [minVal, maxVal) starting at the
+    index offset in the sequence. */
+    auto uniform_float_vector(U64 count, F32 minVal, F32 maxVal,
+                              U64 offset = 0) const -> Vector<F32>;
+
+    auto get_seed() const -> U64 { return _seed; }
+    auto get_stream() const -> U32 { return _stream; }
+
+    /** Map a raw value to [minVal, minVal + range) (full range if range is
+    0), same as philox_uniform_u32(). */
+    static auto to_range(U32 x, U32 minVal, U32 range) -> U32 {
+        return range == 0 ? x : minVal + (U32)(((U64)x * range) >> 32);
+    }
+
+    /** Map a raw value to [0, 1), same as philox_uniform_f32(). */
+    static auto to_unit_float(U32 x) -> F32 {
+        return (F32)(x >> 8) * (1.0F / 16777216.0F);
+    }
+
+  protected:
+    U64 _seed{0};
+    U32 _stream{0};
+};
+
+} // namespace nv
+
+#endif
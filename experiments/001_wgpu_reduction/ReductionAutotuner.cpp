@@ -0,0 +1,211 @@
+#include <ReductionAutotuner.h>
+
+#include <fstream>
+#include <sstream>
+
+using namespace wgpu;
+
+namespace nv {
+
+ReductionAutotuner::ReductionAutotuner(const ReductionAutotunerDesc& desc)
+    : _desc(desc) {
+    load_cache();
+};
+
+ReductionAutotuner::~ReductionAutotuner() = default;
+
+auto ReductionAutotuner::create(const ReductionAutotunerDesc& desc)
+    -> RefPtr<ReductionAutotuner> {
+    return nv::create<ReductionAutotuner>(desc);
+}
+
+auto ReductionAutotuner::make_reduc7_defs(U32 workgroupSize,
+                                          U32 reductionFactor) -> StringVector {
+    StringVector defs = {"WG_SIZE=" + std::to_string(workgroupSize),
+                         "GRID_SIZE=" +
+                             std::to_string(workgroupSize * reductionFactor)};
+
+    // Enable all the unrolled tree steps below the workgroup size:
+    for (U32 s = workgroupSize; s >= 2; s >>= 1) {
+        defs.push_back("WG_" + std::to_string(s));
+    }
+
+    // Enable the grid loads up to the reduction factor:
+    for (U32 g = 2; g <= reductionFactor; g <<= 1) {
+        defs.push_back("GRID_" + std::to_string(g));
+    }
+
+    return defs;
+}
+
+auto ReductionAutotuner::get_adapter_key() -> String {
+    auto* eng = WGPUEngine::instance();
+    AdapterInfo info{};
+    eng->get_adapter().GetInfo(&info);
+
+    std::ostringstream os;
+    os << std::hex << info.vendorID << ":" << info.deviceID << ":" << std::dec
+       << (U32)info.backendType;
+    return os.str();
+}
+
+auto ReductionAutotuner::get_best_config(const String& shaderFile,
+                                         GPUBuffer& input, U32 count,
+                                         U32 expected,
+                                         const DefsBuilder& builder)
+    -> ReductionTuneConfig {
+    String key = get_adapter_key() + "|" + shaderFile + "|" +
+                 std::to_string(count);
+
+    auto it = _cache.find(key);
+    if (!_desc.forceRetune && it != _cache.end()) {
+        const auto& entry = it->second;
+        logDEBUG("ReductionAutotuner: using cached config for {}: WG_SIZE={}, "
+                 "factor={}",
+                 key, entry.workgroupSize, entry.reductionFactor);
+        return {.workgroupSize = entry.workgroupSize,
+                .reductionFactor = entry.reductionFactor,
+                .defs = builder(entry.workgroupSize, entry.reductionFactor),
+                .elapsedNs = entry.elapsedNs};
+    }
+
+    auto best = tune(shaderFile, input, count, expected, builder);
+
+    _cache[key] = {.workgroupSize = best.workgroupSize,
+                   .reductionFactor = best.reductionFactor,
+                   .elapsedNs = best.elapsedNs};
+    save_cache();
+
+    return best;
+}
+
+auto ReductionAutotuner::tune(const String& shaderFile, GPUBuffer& input,
+                              U32 count, U32 expected,
+                              const DefsBuilder& builder)
+    -> ReductionTuneConfig {
+    ReductionTuneConfig best{};
+    best.elapsedNs = -1.0;
+
+    for (auto wgSize : _desc.workgroupSizes) {
+        for (auto factor : _desc.reductionFactors) {
+            // The atomic-output kernels do not check the input bounds:
+            U32 gridSize = wgSize * factor;
+            if (count % gridSize != 0) {
+                logDEBUG("ReductionAutotuner: skipping WG_SIZE={}, factor={} "
+                         "(count not a multiple of {})",
+                         wgSize, factor, gridSize);
+                continue;
+            }
+
+            auto defs = builder(wgSize, factor);
+            F64 elapsed = time_candidate(shaderFile, input, count, expected,
+                                         wgSize, factor, defs);
+            if (elapsed < 0.0) {
+                logWARN("ReductionAutotuner: invalid result for WG_SIZE={}, "
+                        "factor={}",
+                        wgSize, factor);
+                continue;
+            }
+
+            logDEBUG("ReductionAutotuner: WG_SIZE={}, factor={}: {:.0f} ns",
+                     wgSize, factor, elapsed);
+
+            if (best.elapsedNs < 0.0 || elapsed < best.elapsedNs) {
+                best = {.workgroupSize = wgSize,
+                        .reductionFactor = factor,
+                        .defs = defs,
+                        .elapsedNs = elapsed};
+            }
+        }
+    }
+
+    NVCHK(best.elapsedNs >= 0.0, "ReductionAutotuner: no valid config for {}",
+          shaderFile);
+    logNOTE("ReductionAutotuner: best config for {}: WG_SIZE={}, factor={} "
+            "({:.0f} ns)",
+            shaderFile, best.workgroupSize, best.reductionFactor,
+            best.elapsedNs);
+
+    return best;
+}
+
+auto ReductionAutotuner::time_candidate(const String& shaderFile,
+                                        GPUBuffer& input, U32 count,
+                                        U32 expected, U32 workgroupSize,
+                                        U32 reductionFactor,
+                                        const StringVector& defs) -> F64 {
+    auto* eng = WGPUEngine::instance();
+
+    // Use a fresh atomic output for each candidate:
+    GPUBuffer output(1 * sizeof(U32),
+                     BufferUsage::Storage | BufferUsage::CopySrc);
+
+    U32 ngrps = count / (workgroupSize * reductionFactor);
+
+    auto cpass = create_ref_object<WGPUComputePass>();
+    cpass->add_simple_compute({.shaderFile = shaderFile.c_str(),
+                               .entries = {input.as_sto(), output.as_rw_sto()},
+                               .defs = defs,
+                               .dims = {ngrps}});
+
+    auto& bld = eng->build_commands();
+
+    // Dry-run (also compiles the pipeline):
+    bld.execute_compute_pass(*cpass);
+    bld.submit();
+
+    bld.reset_all();
+    bld.write_timestamp(0);
+    for (U32 i = 0; i < _desc.niters; ++i) {
+        bld.execute_compute_pass(*cpass);
+    }
+    bld.write_timestamp(1);
+    bld.submit(false);
+
+    const U32* data = (U32*)output.copy_to_staged().read_sync();
+    if (data == nullptr || *data != expected * (_desc.niters + 1)) {
+        return -1.0;
+    }
+
+    return eng->get_timestamp_delta_ns(0, 1) / _desc.niters;
+}
+
+void ReductionAutotuner::load_cache() {
+    _cache.clear();
+    if (!system_file_exists(_desc.cacheFile.c_str())) {
+        return;
+    }
+
+    // Each line is: <key> <workgroupSize> <reductionFactor> <elapsedNs>
+    std::ifstream file(_desc.cacheFile);
+    String line;
+    while (std::getline(file, line)) {
+        std::istringstream is(line);
+        String key;
+        CacheEntry entry;
+        if (is >> key >> entry.workgroupSize >> entry.reductionFactor >>
+            entry.elapsedNs) {
+            _cache[key] = entry;
+        }
+    }
+
+    logDEBUG("ReductionAutotuner: loaded {} cached configs from {}",
+             _cache.size(), _desc.cacheFile);
+}
+
+void ReductionAutotuner::save_cache() {
+    std::ofstream file(_desc.cacheFile);
+    if (!file.is_open()) {
+        logERROR("ReductionAutotuner: cannot write cache file {}",
+                 _desc.cacheFile);
+        return;
+    }
+
+    for (const auto& it : _cache) {
+        file << it.first << " " << it.second.workgroupSize << " "
+             << it.second.reductionFactor << " " << it.second.elapsedNs
+             << "\n";
+    }
+}
+
+} // namespace nv
@@ -0,0 +1,95 @@
+#ifndef NV_REDUCTIONAUTOTUNER_H_
+#define NV_REDUCTIONAUTOTUNER_H_
+
+#include <gpu_common.h>
+
+namespace nv {
+
+struct ReductionTuneConfig {
+    /** Workgroup size of the selected variant. */
+    U32 workgroupSize{256};
+
+    /** Number of elements reduced per thread. */
+    U32 reductionFactor{1};
+
+    /** Shader defines for this variant. */
+    StringVector defs;
+
+    /** Measured time for one dispatch (in ns). */
+    F64 elapsedNs{0.0};
+};
+
+struct ReductionAutotunerDesc {
+    /** File used to persist the tuning results. */
+    String cacheFile{"reduction_autotune.cache"};
+
+    /** Workgroup sizes to sweep. */
+    Vector<U32> workgroupSizes{64, 128, 256};
+
+    /** Reduction factors to sweep. */
+    Vector<U32> reductionFactors{2, 4, 8, 16};
+
+    /** Number of timed dispatches per candidate. */
+    U32 niters{50};
+
+    /** Ignore the cached results and tune again. */
+    bool forceRetune{false};
+};
+
+/**
+ * Sweep the shader define space of an atomic-output reduction kernel
+ * (reduc6/reduc7 style) and keep the fastest variant. Results are persisted
+ * per adapter, kernel and input size.
+ */
+class NVGPU_EXPORT ReductionAutotuner : public RefObject {
+  public:
+    using DefsBuilder =
+        std::function<StringVector(U32 workgroupSize, U32 reductionFactor)>;
+
+    explicit ReductionAutotuner(const ReductionAutotunerDesc& desc);
+    ~ReductionAutotuner() override;
+
+    static auto create(const ReductionAutotunerDesc& desc)
+        -> RefPtr<ReductionAutotuner>;
+
+    /** Get the best config for a kernel, tuning it if not in the cache.
+    The input buffer should contain count elements summing to expected. */
+    auto get_best_config(const String& shaderFile, GPUBuffer& input,
+                         U32 count, U32 expected,
+                         const DefsBuilder& builder = make_reduc7_defs)
+        -> ReductionTuneConfig;
+
+    /** Time all the candidates and return the fastest one. */
+    auto tune(const String& shaderFile, GPUBuffer& input, U32 count,
+              U32 expected, const DefsBuilder& builder) -> ReductionTuneConfig;
+
+    /** Build the WG_* and GRID_* defines used by reduc7. */
+    static auto make_reduc7_defs(U32 workgroupSize, U32 reductionFactor)
+        -> StringVector;
+
+    /** Get a string identifying the current adapter. */
+    static auto get_adapter_key() -> String;
+
+  protected:
+    ReductionAutotunerDesc _desc;
+
+    struct CacheEntry {
+        U32 workgroupSize{0};
+        U32 reductionFactor{0};
+        F64 elapsedNs{0.0};
+    };
+
+    std::map<String, CacheEntry> _cache;
+
+    /** Time a single candidate, returns a negative value if invalid. */
+    auto time_candidate(const String& shaderFile, GPUBuffer& input, U32 count,
+                        U32 expected, U32 workgroupSize, U32 reductionFactor,
+                        const StringVector& defs) -> F64;
+
+    void load_cache();
+    void save_cache();
+};
+
+} // namespace nv
+
+#endif
@@ -1,13 +1,28 @@
 #include <nv_tests_framework.h>
 
+#include <BenchmarkRunner.h>
+#include <CPUReducer.h>
+#include <GPUBatchedReducer.h>
+#include <GPUFloatReducer.h>
+#include <GPUHistogram.h>
+#include <GPUMipReducer.h>
+#include <GPURandomFill.h>
+#include <GPUReducer.h>
+#include <GPUStatsReducer.h>
+#include <PhiloxRNG.h>
+#include <ReductionAutotuner.h>
 #include <WGPUEngine.h>
+#include <algorithm>
+#include <cfloat>
+#include <limits>
 #include <numeric>
+#include <type_traits>
 
 using namespace nv;
 using namespace wgpu;
 
 static void run_reduction(const char* code, U32 reducFactor = 1,
-                          StringVector* defs = nullptr) {
+                          StringVector* defs = nullptr, U32 wgSize = 256) {
     // Create a compute pass:
     auto* eng = WGPUEngine::instance();
 
@@ -21,12 +36,13 @@ static void run_reduction(const char* code, U32 reducFactor = 1,
     GPUBuffer output(1 * sizeof(U32),
                      BufferUsage::Storage | BufferUsage::CopySrc);
 
-    // Get the accumulated value:
+    // Get the accumulated value on 64 bits:
+    auto cpu = CPUReducer::create();
+    U64 sum = cpu->reduce(in_data.data(), num);
     U32 niters = 200;
     // Note: we need to account for the dry-run below:
-    U32 total =
-        std::accumulate(in_data.begin(), in_data.end(), 0U) * (niters + 1);
-    U32 ngrps = ((num + 255) / 256) / reducFactor;
+    U64 total = sum * (niters + 1);
+    U32 ngrps = ((num + wgSize - 1) / wgSize) / reducFactor;
     logNOTE("Using {} workgroups", ngrps);
 
     auto cpass = create_ref_object<WGPUComputePass>();
@@ -60,8 +76,12 @@ static void run_reduction(const char* code, U32 reducFactor = 1,
     const U32* data2 = (U32*)output.copy_to_staged().read_sync();
 
     logNOTE("Expected reduction total: {}", total);
+    if (total > std::numeric_limits<U32>::max()) {
+        logWARN("Reduction total overflows the u32 atomic output.");
+    }
     BOOST_REQUIRE(data2 != nullptr);
-    BOOST_CHECK_EQUAL(*data2, total);
+    // The atomic<u32> output wraps modulo 2^32:
+    BOOST_CHECK_EQUAL(*data2, (U32)total);
 
     // Read the elapsed time:
     F64 elapsed = eng->get_timestamp_delta_ns(0, 1);
@@ -73,10 +93,578 @@ static void run_reduction(const char* code, U32 reducFactor = 1,
     // Compute the bandwidth:
     F64 bw = niters * num * sizeof(U32) / (std::pow(1024, 3) * elapsed * 1e-9);
     logNOTE("Compute shader took {} ns, bandwidth: {:.3f} GB/s", elapsed, bw);
+    logNOTE("GPU: {:.3f} GB/s, CPU ({} threads, {}): {:.3f} GB/s", bw,
+            cpu->get_num_threads(), CPUReducer::get_simd_name(),
+            cpu->get_last_bandwidth());
 
     // For ref. max RTX 3090 bandwidth is 936.2 GB/s.
 }
 
+// Reference bandwidth (GB/s) for the percentages in the logs:
+static const F64 kRefBandwidth = 936.2;
+
+struct TimedRun {
+    F64 elapsed{0.0};
+    F64 bandwidth{0.0};
+};
+
+/** Run a compute pass niters times between two timestamps (after a dry run
+unless disabled) and log the elapsed time and the bandwidth, bytesPerRun being
+the number of bytes read (or written) by one run of the pass. */
+static auto run_timed(const char* label, WGPUComputePass& cpass, U32 niters,
+                      U64 bytesPerRun, bool dryRun = true) -> TimedRun {
+    auto* eng = WGPUEngine::instance();
+    auto& bld = eng->build_commands();
+
+    if (dryRun) {
+        bld.execute_compute_pass(cpass);
+        bld.submit();
+    }
+
+    bld.reset_all();
+    bld.write_timestamp(0);
+    for (I32 i = 0; i < niters; ++i) {
+        bld.execute_compute_pass(cpass);
+    }
+    bld.write_timestamp(1);
+    bld.submit(false);
+    eng->wait_idle();
+
+    F64 elapsed = eng->get_timestamp_delta_ns(0, 1);
+    F64 bw = niters * (F64)bytesPerRun / (std::pow(1024, 3) * elapsed * 1e-9);
+    logNOTE("{} took {} ns, bandwidth: {:.3f} GB/s ({:.1f}% of ref.)", label,
+            elapsed, bw, 100.0 * bw / kRefBandwidth);
+    return {.elapsed = elapsed, .bandwidth = bw};
+}
+
+static void run_gpu_reducer(U32 num, U32 gridFactor = 8,
+                            bool useSubgroups = true) {
+    RandGen rnd;
+    auto in_data = rnd.uniform_int_vector<U32>(num, 0, 4);
+
+    GPUBuffer input(num * sizeof(U32), BufferUsage::Storage, in_data.data());
+
+    auto reducer = GPUReducer::create({.input = &input,
+                                       .count = num,
+                                       .gridFactor = gridFactor,
+                                       .useSubgroups = useSubgroups});
+    logNOTE("Reducing {} elements in {} steps (subgroups: {})", num,
+            reducer->get_num_steps(), reducer->is_using_subgroups());
+
+    auto cpu = CPUReducer::create();
+    U32 total = (U32)cpu->reduce(in_data.data(), num);
+
+    auto run = run_timed("Compute shader", reducer->get_compute_pass(), 200,
+                         (U64)num * sizeof(U32));
+
+    // No accumulation across iterations here: each run overwrites the output.
+    const U32* data2 =
+        (U32*)reducer->get_output().copy_to_staged().read_sync();
+
+    BOOST_REQUIRE(data2 != nullptr);
+    BOOST_CHECK_EQUAL(*data2, total);
+
+    logNOTE("GPU: {:.3f} GB/s, CPU ({} threads, {}): {:.3f} GB/s",
+            run.bandwidth, cpu->get_num_threads(), CPUReducer::get_simd_name(),
+            cpu->get_last_bandwidth());
+}
+
+static void run_gpu_reducer_packed(U32 num, InputFormat format,
+                                   U32 gridFactor = 8) {
+    U32 elemsPerWord = GPUReducer::get_elements_per_word(format);
+    U32 bits = 32 / elemsPerWord;
+
+    RandGen rnd;
+    auto in_data = rnd.uniform_int_vector<U32>(num, 0, 4);
+
+    // Pack the elements in u32 words:
+    U32 numWords = (num + elemsPerWord - 1) / elemsPerWord;
+    Vector<U32> packed(numWords, 0);
+    for (U32 i = 0; i < num; ++i) {
+        packed[i / elemsPerWord] |= in_data[i] << ((i % elemsPerWord) * bits);
+    }
+
+    GPUBuffer input(numWords * sizeof(U32), BufferUsage::Storage,
+                    packed.data());
+
+    auto reducer = GPUReducer::create({.input = &input,
+                                       .count = num,
+                                       .gridFactor = gridFactor,
+                                       .inputFormat = format});
+    logNOTE("Reducing {} packed elements ({} per word) in {} steps", num,
+            elemsPerWord, reducer->get_num_steps());
+
+    auto cpu = CPUReducer::create();
+    U32 total = (U32)cpu->reduce(in_data.data(), num);
+
+    // Report the bandwidth actually read, and the equivalent element rate:
+    U32 niters = 200;
+    auto run = run_timed("Compute shader", reducer->get_compute_pass(), niters,
+                         (U64)numWords * sizeof(U32));
+    F64 rate = niters * (F64)num / (run.elapsed * 1e-9) / 1e9;
+    logNOTE("Element rate: {:.3f} Gelems/s", rate);
+
+    const U32* data2 =
+        (U32*)reducer->get_output().copy_to_staged().read_sync();
+
+    BOOST_REQUIRE(data2 != nullptr);
+    BOOST_CHECK_EQUAL(*data2, total);
+}
+
+static void run_gpu_reducer_wide(U32 num, U32 maxValue,
+                                 InputFormat format = InputFormat::U32) {
+    auto* eng = WGPUEngine::instance();
+    U32 elemsPerWord = GPUReducer::get_elements_per_word(format);
+    U32 bits = 32 / elemsPerWord;
+
+    RandGen rnd;
+    auto in_data = rnd.uniform_int_vector<U32>(num, 0, maxValue);
+
+    U32 numWords = (num + elemsPerWord - 1) / elemsPerWord;
+    Vector<U32> packed(numWords, 0);
+    for (U32 i = 0; i < num; ++i) {
+        packed[i / elemsPerWord] |= in_data[i] << ((i % elemsPerWord) * bits);
+    }
+
+    GPUBuffer input(numWords * sizeof(U32), BufferUsage::Storage,
+                    packed.data());
+
+    auto reducer = GPUReducer::create({.input = &input,
+                                       .count = num,
+                                       .inputFormat = format,
+                                       .wideAccumulator = true});
+
+    auto cpu = CPUReducer::create();
+    U64 total = cpu->reduce(in_data.data(), num);
+    logNOTE("Reducing {} elements with wide accumulators, expected: {}", num,
+            total);
+
+    auto& bld = eng->build_commands();
+    bld.execute_compute_pass(reducer->get_compute_pass());
+    bld.submit();
+
+    const U64* data2 =
+        (U64*)reducer->get_output().copy_to_staged().read_sync();
+    BOOST_REQUIRE(data2 != nullptr);
+    BOOST_CHECK_EQUAL(*data2, total);
+}
+
+static void run_wide_reduction(U32 num, U32 wgSize, U32 reducFactor) {
+    // Full range values: the total overflows 32 bits after a few elements.
+    RandGen rnd;
+    auto in_data = rnd.uniform_int_vector<U32>(num, 0, 0xFFFFFFFF);
+
+    GPUBuffer input(num * sizeof(U32), BufferUsage::Storage, in_data.data());
+    GPUBuffer output(sizeof(U64), BufferUsage::Storage | BufferUsage::CopySrc);
+
+    auto cpu = CPUReducer::create();
+    U64 sum = cpu->reduce(in_data.data(), num);
+    U32 niters = 200;
+    // Note: we need to account for the dry-run below:
+    U64 total = sum * (niters + 1);
+
+    U32 ngrps = num / (wgSize * reducFactor);
+    StringVector defs = {"WG_SIZE=" + std::to_string(wgSize),
+                         "GRID_SIZE=" + std::to_string(wgSize * reducFactor)};
+
+    auto cpass = create_ref_object<WGPUComputePass>();
+    cpass->add_simple_compute({.shaderFile = "tests/reduction/reduc8_wide",
+                               .entries = {input.as_sto(), output.as_rw_sto()},
+                               .defs = defs,
+                               .dims = {ngrps}});
+
+    run_timed("Compute shader", *cpass, niters, (U64)num * sizeof(U32));
+
+    const U64* data2 = (U64*)output.copy_to_staged().read_sync();
+    BOOST_REQUIRE(data2 != nullptr);
+    BOOST_CHECK_EQUAL(*data2, total);
+}
+
+static void run_float_reducer(U32 num, bool useKahan) {
+    auto* eng = WGPUEngine::instance();
+
+    // Values spread over several orders of magnitude:
+    RandGen rnd;
+    auto int_data = rnd.uniform_int_vector<U32>(num, 0, 1000000);
+    Vector<F32> in_data(num);
+    for (U32 i = 0; i < num; ++i) {
+        in_data[i] = (F32)int_data[i] * (i % 3 == 0 ? 1e-3F : 1e-6F);
+    }
+
+    GPUBuffer input(num * sizeof(F32), BufferUsage::Storage, in_data.data());
+
+    auto reducer = GPUFloatReducer::create(
+        {.input = &input, .count = num, .useKahan = useKahan});
+    logNOTE("Reducing {} floats in {} steps (Kahan: {})", num,
+            reducer->get_num_steps(), useKahan);
+
+    // Reference on 64 bits:
+    auto cpu = CPUReducer::create();
+    F64 expected = cpu->reduce(in_data.data(), num);
+
+    auto& bld = eng->build_commands();
+
+    // Dry-run:
+    bld.execute_compute_pass(reducer->get_compute_pass());
+    bld.submit();
+    F32 first = *(F32*)reducer->get_output().copy_to_staged().read_sync();
+
+    run_timed("Compute shader", reducer->get_compute_pass(), 200,
+              (U64)num * sizeof(F32), false);
+
+    const F32* data2 =
+        (F32*)reducer->get_output().copy_to_staged().read_sync();
+    BOOST_REQUIRE(data2 != nullptr);
+
+    // Bitwise identical across runs:
+    BOOST_CHECK_EQUAL(memcmp(data2, &first, sizeof(F32)), 0);
+
+    F64 relError = std::abs((F64)*data2 - expected) / expected;
+    logNOTE("Float reduction result: {}, expected: {}, relative error: {:e}",
+            *data2, expected, relError);
+    BOOST_CHECK_LT(relError, useKahan ? 1e-6 : 1e-4);
+}
+
+static void run_stats_reducer(U32 num, bool withArgs) {
+    // Small integers, with many ties on the min/max values:
+    RandGen rnd;
+    auto int_data = rnd.uniform_int_vector<U32>(num, 0, 1000);
+    Vector<F32> in_data(num);
+    for (U32 i = 0; i < num; ++i) {
+        in_data[i] = (F32)int_data[i] - 500.0F;
+    }
+
+    GPUBuffer input(num * sizeof(F32), BufferUsage::Storage, in_data.data());
+
+    auto reducer = GPUStatsReducer::create({.input = &input,
+                                            .count = num,
+                                            .computeSumSquares = true,
+                                            .computeArgMin = withArgs,
+                                            .computeArgMax = withArgs});
+    logNOTE("Reducing stats on {} floats in {} steps (args: {})", num,
+            reducer->get_num_steps(), withArgs);
+
+    // CPU reference (min/max_element return the first extreme value, which is
+    // also the tie-breaking rule on the GPU):
+    auto minIt = std::min_element(in_data.begin(), in_data.end());
+    auto maxIt = std::max_element(in_data.begin(), in_data.end());
+    F64 sum = 0.0;
+    F64 sumAbs = 0.0;
+    F64 sumSq = 0.0;
+    for (auto v : in_data) {
+        sum += v;
+        sumAbs += std::abs(v);
+        sumSq += (F64)v * v;
+    }
+
+    // All the statistics come from a single read of the input:
+    run_timed("Stats reduction", reducer->get_compute_pass(), 100,
+              (U64)num * sizeof(F32));
+
+    const auto* res = (GPUReduceStats*)reducer->get_output()
+                          .copy_to_staged()
+                          .read_sync();
+    BOOST_REQUIRE(res != nullptr);
+
+    BOOST_CHECK_EQUAL(res->min, *minIt);
+    BOOST_CHECK_EQUAL(res->max, *maxIt);
+    if (withArgs) {
+        BOOST_CHECK_EQUAL(res->argMin, (U32)(minIt - in_data.begin()));
+        BOOST_CHECK_EQUAL(res->argMax, (U32)(maxIt - in_data.begin()));
+    }
+
+    // Sums are accumulated on 32 bits (and the signed sum may be close to 0):
+    BOOST_CHECK_LE(std::abs((F64)res->sum - sum), 1e-5 * sumAbs);
+    BOOST_CHECK_LT(std::abs((F64)res->sumSquares - sumSq) / sumSq, 1e-4);
+}
+
+static void run_batched_reducer(U32 numSegments, U32 maxLen,
+                                BatchReduceOp op) {
+    // Random segment lengths (including empty segments):
+    RandGen rnd;
+    auto lengths = rnd.uniform_int_vector<U32>(numSegments, 0, maxLen);
+    Vector<U32> offsets(numSegments + 1, 0);
+    for (U32 i = 0; i < numSegments; ++i) {
+        offsets[i + 1] = offsets[i] + lengths[i];
+    }
+    U32 num = offsets[numSegments];
+    auto in_data = rnd.uniform_int_vector<U32>(std::max(num, 1U), 0, 1000);
+
+    GPUBuffer input(std::max(num, 1U) * sizeof(U32), BufferUsage::Storage,
+                    in_data.data());
+    GPUBuffer offsetsBuf(offsets.size() * sizeof(U32), BufferUsage::Storage,
+                         offsets.data());
+
+    auto reducer = GPUBatchedReducer::create({.input = &input,
+                                              .offsets = &offsetsBuf,
+                                              .numSegments = numSegments,
+                                              .op = op});
+    logNOTE("Batched reduction of {} segments ({} elements)", numSegments,
+            num);
+
+    run_timed("Batched reduction", reducer->get_compute_pass(), 100,
+              (U64)num * sizeof(U32));
+
+    const U32* data =
+        (U32*)reducer->get_output().copy_to_staged().read_sync();
+    BOOST_REQUIRE(data != nullptr);
+
+    U32 identity = GPUBatchedReducer::get_identity(op);
+    U32 numErrors = 0;
+    for (U32 s = 0; s < numSegments; ++s) {
+        U32 expected = identity;
+        for (U32 i = offsets[s]; i < offsets[s + 1]; ++i) {
+            U32 v = in_data[i];
+            switch (op) {
+            case BatchReduceOp::Sum:
+                expected += v;
+                break;
+            case BatchReduceOp::Min:
+                expected = std::min(expected, v);
+                break;
+            case BatchReduceOp::Max:
+                expected = std::max(expected, v);
+                break;
+            }
+        }
+        if (data[s] != expected && numErrors++ < 10) {
+            logERROR("Invalid result for segment {}: {} != {}", s, data[s],
+                     expected);
+        }
+    }
+    BOOST_CHECK_EQUAL(numErrors, 0);
+}
+
+static void run_histogram(U32 num, U32 numBins, U32 maxValue,
+                          bool privatized = true) {
+    // A small maxValue gives a lot of contention on a few bins. The input is
+    // generated on the GPU, and the same sequence on the CPU for the check:
+    GPUBuffer input(num * sizeof(U32), BufferUsage::Storage);
+    auto fill = GPURandomFill::create({.output = &input,
+                                       .count = num,
+                                       .seed = 1234,
+                                       .maxInt = maxValue});
+    fill->execute();
+
+    PhiloxRNG rng(1234);
+    auto in_data = rng.uniform_int_vector(num, 0, maxValue);
+
+    auto hist = GPUHistogram::create({.input = &input,
+                                      .count = num,
+                                      .numBins = numBins,
+                                      .privatized = privatized});
+    logNOTE("Histogram of {} values (max: {}) in {} bins, {} pass(es), "
+            "privatized: {}",
+            num, maxValue, numBins, hist->get_num_passes(), privatized);
+
+    Vector<U32> expected(numBins, 0);
+    for (auto v : in_data) {
+        expected[v & (numBins - 1)]++;
+    }
+
+    run_timed("Histogram", hist->get_compute_pass(), 50,
+              (U64)num * sizeof(U32));
+
+    const U32* data = (U32*)hist->get_output().copy_to_staged().read_sync();
+    BOOST_REQUIRE(data != nullptr);
+    BOOST_CHECK_EQUAL_COLLECTIONS(data, data + numBins, expected.begin(),
+                                  expected.end());
+}
+
+static auto create_r32f_texture(U32 width, U32 height, U32 numLayers,
+                                const F32* data, TextureUsage usage)
+    -> Texture {
+    auto* eng = WGPUEngine::instance();
+
+    TextureDescriptor desc{
+        .usage = usage | TextureUsage::CopyDst,
+        .dimension = TextureDimension::e2D,
+        .size = {width, height, numLayers},
+        .format = TextureFormat::R32Float};
+    Texture tex = eng->get_device().CreateTexture(&desc);
+
+    ImageCopyTexture dst{.texture = tex};
+    TextureDataLayout layout{.bytesPerRow = width * (U32)sizeof(F32),
+                             .rowsPerImage = height};
+    Extent3D extent{width, height, numLayers};
+    eng->get_queue().WriteTexture(&dst, data,
+                                  (size_t)width * height * numLayers *
+                                      sizeof(F32),
+                                  &layout, &extent);
+    return tex;
+}
+
+static void run_mip_reducer(U32 width, U32 height, MipReduceOp op,
+                            U32 numLayers = 1, U32 layer = 0,
+                            MipSource source = MipSource::Buffer,
+                            bool singleDispatch = true) {
+    U32 num = width * height * numLayers;
+    RandGen rnd;
+    auto int_data = rnd.uniform_int_vector<U32>(num, 0, 1000000);
+    Vector<F32> in_data(num);
+    for (U32 i = 0; i < num; ++i) {
+        in_data[i] = (F32)int_data[i] * 1e-6F;
+    }
+
+    GPUBuffer input(num * sizeof(F32), BufferUsage::Storage, in_data.data());
+
+    // Texture sources are r32float textures (arrays) with the same texels:
+    Texture tex;
+    TextureView view;
+    if (source != MipSource::Buffer) {
+        tex = create_r32f_texture(width, height, numLayers, in_data.data(),
+                                  source == MipSource::StorageTextureArray
+                                      ? TextureUsage::StorageBinding
+                                      : TextureUsage::TextureBinding);
+        TextureViewDescriptor viewDesc{
+            .dimension = source == MipSource::Texture
+                             ? TextureViewDimension::e2D
+                             : TextureViewDimension::e2DArray};
+        view = tex.CreateView(&viewDesc);
+    }
+
+    auto reducer = GPUMipReducer::create({.input = &input,
+                                          .width = width,
+                                          .height = height,
+                                          .layer = layer,
+                                          .op = op,
+                                          .source = source,
+                                          .texture = view,
+                                          .storageFormat = "r32float",
+                                          .singleDispatch = singleDispatch});
+    U32 numLevels = reducer->get_num_levels();
+    logNOTE("Mip reduction of {}x{} (layer {}, source {}) in {} levels",
+            width, height, layer, (U32)source, numLevels);
+
+    // CPU reference, with the same rule for the odd sizes:
+    Vector<F32> prev(in_data.begin() + layer * width * height,
+                     in_data.begin() + (layer + 1) * width * height);
+    Vector<Vector<F32>> expected;
+    U32 pw = width;
+    U32 ph = height;
+    for (U32 level = 1; level <= numLevels; ++level) {
+        auto size = reducer->get_level_size(level);
+        Vector<F32> cur(size.x * size.y);
+        for (U32 y = 0; y < size.y; ++y) {
+            for (U32 x = 0; x < size.x; ++x) {
+                F32 acc = op == MipReduceOp::Min   ? FLT_MAX
+                          : op == MipReduceOp::Max ? -FLT_MAX
+                                                   : 0.0F;
+                U32 n = 0;
+                for (U32 d = 0; d < 4; ++d) {
+                    U32 cx = 2 * x + (d & 1);
+                    U32 cy = 2 * y + (d >> 1);
+                    if (cx < pw && cy < ph) {
+                        F32 v = prev[cy * pw + cx];
+                        acc = op == MipReduceOp::Min   ? std::min(acc, v)
+                              : op == MipReduceOp::Max ? std::max(acc, v)
+                                                       : acc + v;
+                        n++;
+                    }
+                }
+                cur[y * size.x + x] =
+                    op == MipReduceOp::Average ? acc / (F32)n : acc;
+            }
+        }
+        expected.push_back(cur);
+        prev = cur;
+        pw = size.x;
+        ph = size.y;
+    }
+
+    run_timed("Mip reduction", reducer->get_compute_pass(), 100,
+              (U64)width * height * sizeof(F32));
+
+    const F32* data =
+        (F32*)reducer->get_output().copy_to_staged().read_sync();
+    BOOST_REQUIRE(data != nullptr);
+
+    U32 numErrors = 0;
+    for (U32 level = 1; level <= numLevels; ++level) {
+        const F32* ldata = data + reducer->get_level_offset(level);
+        const auto& ref = expected[level - 1];
+        for (U32 i = 0; i < ref.size(); ++i) {
+            // Min/max are exact, the average depends on the summation order:
+            F32 tol = op == MipReduceOp::Average ? 1e-5F : 0.0F;
+            if (std::abs(ldata[i] - ref[i]) > tol && numErrors++ < 10) {
+                logERROR("Invalid value at level {}, index {}: {} != {}",
+                         level, i, ldata[i], ref[i]);
+            }
+        }
+    }
+    BOOST_CHECK_EQUAL(numErrors, 0);
+}
+
+static void run_random_fill(U32 num, RandomFillType type, U32 offset,
+                            U32 stream) {
+    GPUBuffer output(num * sizeof(U32),
+                     BufferUsage::Storage | BufferUsage::CopySrc);
+    auto fill = GPURandomFill::create({.output = &output,
+                                       .count = num,
+                                       .offset = offset,
+                                       .seed = 0x123456789ABCDEFULL,
+                                       .stream = stream,
+                                       .type = type,
+                                       .minInt = 10,
+                                       .maxInt = 1000});
+
+    run_timed("Random fill", fill->get_compute_pass(), 1,
+              (U64)num * sizeof(U32), false);
+
+    const U32* data = (U32*)output.copy_to_staged().read_sync();
+    BOOST_REQUIRE(data != nullptr);
+
+    // The CPU sequence must be bit-identical:
+    PhiloxRNG rng(0x123456789ABCDEFULL, stream);
+    if (type == RandomFillType::UniformInt) {
+        auto expected = rng.uniform_int_vector(num, 10, 1000, offset);
+        BOOST_CHECK_EQUAL(memcmp(data, expected.data(), num * sizeof(U32)),
+                          0);
+        BOOST_CHECK_EQUAL(*std::min_element(data, data + num), 10);
+        BOOST_CHECK_EQUAL(*std::max_element(data, data + num), 1000);
+    } else {
+        auto expected = rng.uniform_float_vector(num, 0.0F, 1.0F, offset);
+        BOOST_CHECK_EQUAL(memcmp(data, expected.data(), num * sizeof(F32)),
+                          0);
+    }
+}
+
+template <typename T> static void run_cpu_reducer(U64 num) {
+    logNOTE("Running CPU reductions on {} elements of {} bytes", num,
+            sizeof(T));
+
+    // Values in [-0.5, 0.5) for the floats, so that min/max aren't trivial:
+    RandGen rnd;
+    auto int_data = rnd.uniform_int_vector<U32>(num, 0, 1000000);
+    Vector<T> in_data(num);
+    for (U64 i = 0; i < num; ++i) {
+        in_data[i] = std::is_integral_v<T>
+                         ? (T)int_data[i]
+                         : (T)((F64)int_data[i] * 1e-6 - 0.5);
+    }
+
+    auto cpu = CPUReducer::create();
+
+    // Scalar references:
+    using R = std::conditional_t<std::is_integral_v<T>, U64, F64>;
+    R refSum = std::accumulate(in_data.begin(), in_data.end(), (R)0,
+                               [](R acc, T v) { return acc + (R)v; });
+    R refMin = (R)*std::min_element(in_data.begin(), in_data.end());
+    R refMax = (R)*std::max_element(in_data.begin(), in_data.end());
+
+    // F32 sums are accumulated in SIMD lanes per block before the F64
+    // combine, so they only match up to the F32 precision:
+    F64 sumTol = std::is_same_v<T, F32>   ? 1e-8 * (F64)num
+                 : std::is_same_v<T, F64> ? 1e-9
+                                          : 0.0;
+    R sum = cpu->reduce(in_data.data(), num, ReduceOp::Sum);
+    BOOST_CHECK_LE(std::abs((F64)sum - (F64)refSum), sumTol);
+    BOOST_CHECK_EQUAL(cpu->reduce(in_data.data(), num, ReduceOp::Min),
+                      refMin);
+    BOOST_CHECK_EQUAL(cpu->reduce(in_data.data(), num, ReduceOp::Max),
+                      refMax);
+}
+
 BOOST_AUTO_TEST_SUITE(reduction)
 
 BOOST_AUTO_TEST_CASE(test_reduc0) { run_reduction("tests/reduction/reduc0"); }
@@ -108,4 +696,247 @@ BOOST_AUTO_TEST_CASE(test_reduc7) {
     run_reduction("tests/reduction/reduc7", 16, &defs);
 }
 
+BOOST_AUTO_TEST_CASE(test_reduc7_autotuned) {
+    U32 num = 4194304; // 2^22
+
+    RandGen rnd;
+    auto in_data = rnd.uniform_int_vector<U32>(num, 0, 4);
+    GPUBuffer input(num * sizeof(U32), BufferUsage::Storage, in_data.data());
+    U32 total = std::accumulate(in_data.begin(), in_data.end(), 0U);
+
+    // Tuned only once per adapter, then read back from the cache file:
+    auto tuner = ReductionAutotuner::create({});
+    auto cfg = tuner->get_best_config("tests/reduction/reduc7", input, num,
+                                      total);
+
+    run_reduction("tests/reduction/reduc7", cfg.reductionFactor, &cfg.defs,
+                  cfg.workgroupSize);
+}
+
+BOOST_AUTO_TEST_CASE(test_cpu_reducer) {
+    run_cpu_reducer<U32>(1000003);
+    run_cpu_reducer<F32>(1000003);
+    run_cpu_reducer<F64>(1000003);
+
+    // Tails smaller than a SIMD register:
+    run_cpu_reducer<F32>(5);
+    run_cpu_reducer<F64>(3);
+}
+
+BOOST_AUTO_TEST_CASE(test_gpu_reducer) {
+    run_gpu_reducer(1);
+    run_gpu_reducer(1000003);
+    run_gpu_reducer(4194304, 16);
+}
+
+BOOST_AUTO_TEST_CASE(test_gpu_reducer_2d_dispatch) {
+    // With a grid factor of 1 this needs more than 65535 workgroups in the
+    // first step, so the dispatch gets folded in 2D:
+    run_gpu_reducer(16777216 + 37, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_gpu_reducer_subgroups) {
+    if (!GPUReducer::is_subgroups_supported()) {
+        logNOTE("Subgroups not supported on this adapter, skipping.");
+        return;
+    }
+
+    // Compare subgroupAdd() against the shared-memory tree fallback:
+    run_gpu_reducer(4194304, 16, true);
+    run_gpu_reducer(4194304, 16, false);
+    run_gpu_reducer(1000003, 8, true);
+}
+
+BOOST_AUTO_TEST_CASE(test_gpu_reducer_packed) {
+    run_gpu_reducer_packed(4194304, InputFormat::PackedU8);
+    run_gpu_reducer_packed(4194304, InputFormat::PackedU16);
+    run_gpu_reducer_packed(1000003, InputFormat::PackedU8, 4);
+    run_gpu_reducer_packed(1000003, InputFormat::PackedU16, 4);
+    run_gpu_reducer_packed(3, InputFormat::PackedU8);
+}
+
+BOOST_AUTO_TEST_CASE(test_reduc8_wide) {
+    // Exact u64 total of 201 runs on full range values:
+    run_wide_reduction(4194304, 256, 16);
+    run_wide_reduction(4194304, 128, 8);
+}
+
+BOOST_AUTO_TEST_CASE(test_gpu_reducer_wide) {
+    run_gpu_reducer_wide(4194304, 0xFFFFFFFF);
+    run_gpu_reducer_wide(1000003, 0xFFFFFFFF);
+    run_gpu_reducer_wide(16777216 + 37, 0xFFFF, InputFormat::PackedU16);
+    run_gpu_reducer_wide(1, 0xFFFFFFFF);
+}
+
+BOOST_AUTO_TEST_CASE(test_float_reducer) {
+    run_float_reducer(4194304, false);
+    run_float_reducer(4194304, true);
+    run_float_reducer(1000003, true);
+    run_float_reducer(37, true);
+}
+
+BOOST_AUTO_TEST_CASE(test_stats_reducer) {
+    run_stats_reducer(4194304, false);
+    run_stats_reducer(4194304, true);
+    run_stats_reducer(1000003, true);
+    run_stats_reducer(37, true);
+}
+
+BOOST_AUTO_TEST_CASE(test_batched_reducer) {
+    run_batched_reducer(10000, 5000, BatchReduceOp::Sum);
+    run_batched_reducer(10000, 100, BatchReduceOp::Sum);
+    run_batched_reducer(10000, 5000, BatchReduceOp::Min);
+    run_batched_reducer(3, 20000, BatchReduceOp::Max);
+}
+
+BOOST_AUTO_TEST_CASE(test_histogram) {
+    U32 num = 1 << 24;
+    for (U32 numBins : {16, 256, 4096, 65536}) {
+        run_histogram(num, numBins, numBins - 1);
+    }
+    run_histogram(1000003, 65536, 100000);
+
+    // High contention, privatized vs global atomics:
+    run_histogram(num, 256, 3);
+    run_histogram(num, 256, 3, false);
+}
+
+BOOST_AUTO_TEST_CASE(test_mip_reducer) {
+    run_mip_reducer(64, 64, MipReduceOp::Max);
+    run_mip_reducer(1920, 1080, MipReduceOp::Min);
+    run_mip_reducer(1920, 1080, MipReduceOp::Max);
+    run_mip_reducer(4096, 4096, MipReduceOp::Average);
+    run_mip_reducer(1000, 3, MipReduceOp::Max);
+
+    // One layer of a texture array:
+    run_mip_reducer(512, 512, MipReduceOp::Min, 4, 2);
+
+    // Texture sources:
+    run_mip_reducer(1920, 1080, MipReduceOp::Max, 1, 0, MipSource::Texture);
+    run_mip_reducer(512, 512, MipReduceOp::Min, 4, 2,
+                    MipSource::TextureArray);
+    run_mip_reducer(1000, 3, MipReduceOp::Average, 3, 1,
+                    MipSource::StorageTextureArray);
+
+    // Top levels in a second dispatch:
+    run_mip_reducer(1920, 1080, MipReduceOp::Min, 1, 0, MipSource::Buffer,
+                    false);
+    run_mip_reducer(4096, 4096, MipReduceOp::Average, 1, 0,
+                    MipSource::Buffer, false);
+    run_mip_reducer(64, 64, MipReduceOp::Max, 1, 0, MipSource::Buffer, false);
+}
+
+BOOST_AUTO_TEST_CASE(test_random_fill) {
+    run_random_fill(1 << 24, RandomFillType::UniformInt, 0, 0);
+    run_random_fill(1000003, RandomFillType::UniformInt, 7, 3);
+    run_random_fill(1 << 24, RandomFillType::UniformFloat, 0, 1);
+    run_random_fill(37, RandomFillType::UniformFloat, 1 << 20, 0);
+
+    // Different streams give different sequences:
+    PhiloxRNG rng0(42, 0);
+    PhiloxRNG rng1(42, 1);
+    BOOST_CHECK(rng0.uniform_int_vector(16, 0, 0xFFFFFFFF) !=
+                rng1.uniform_int_vector(16, 0, 0xFFFFFFFF));
+
+    // Philox4x32-10 known answer (zero counter and key):
+    auto kat = PhiloxRNG::generate_block(0, 0, 0);
+    BOOST_CHECK_EQUAL(kat[0], 0x6627e8d5U);
+    BOOST_CHECK_EQUAL(kat[1], 0xe169c58dU);
+    BOOST_CHECK_EQUAL(kat[2], 0xbc57ac4cU);
+    BOOST_CHECK_EQUAL(kat[3], 0x9b00dbd8U);
+}
+
+BOOST_AUTO_TEST_CASE(test_benchmark_stats) {
+    // 1 GiB per dispatch, 20 samples around 1 ms and 2 outliers:
+    Vector<F64> samples;
+    for (U32 i = 0; i < 20; ++i) {
+        samples.push_back(1e6 + (F64)(i % 5) * 1e3);
+    }
+    samples.push_back(5e6);
+    samples.push_back(1e3);
+
+    auto res = BenchmarkRunner::compute_stats(samples, 1ULL << 30, 1.5);
+    BOOST_CHECK_EQUAL(res.numSamples, 20);
+    BOOST_CHECK_EQUAL(res.numOutliers, 2);
+    BOOST_CHECK_CLOSE(res.medianNs, 1.002e6, 1e-6);
+    BOOST_CHECK_LE(res.ciLowGBs, res.medianGBs);
+    BOOST_CHECK_GE(res.ciHighGBs, res.medianGBs);
+    BOOST_CHECK_LE(res.p95GBs, res.medianGBs);
+    BOOST_CHECK_CLOSE(res.medianGBs, 1e9 / 1.002e6, 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(test_reduction_variants_benchmark) {
+    auto runner = BenchmarkRunner::create(
+        {.baselineFile = "reduction_benchmark.baseline"});
+
+    StringVector wgDefs = {"WG_SIZE=256", "WG_256", "WG_128", "WG_64", "WG_32",
+                           "WG_16",       "WG_8",   "WG_4",   "WG_2"};
+    runner->add_matrix({.kernels = {"tests/reduction/reduc0",
+                                    "tests/reduction/reduc1",
+                                    "tests/reduction/reduc3"}});
+    runner->add_matrix({.kernels = {"tests/reduction/reduc4",
+                                    "tests/reduction/reduc5"},
+                        .reductionFactors = {2}});
+    runner->add_matrix({.kernels = {"tests/reduction/reduc6"},
+                        .defs = {wgDefs},
+                        .reductionFactors = {2}});
+    // The reduc7 defines depend on the reduction factor (added below):
+    runner->add_matrix({.kernels = {"tests/reduction/reduc7"},
+                        .sizes = {4194304, 16777216},
+                        .reductionFactors = {4, 8, 16}});
+
+    U32 warmupIters = BenchmarkRunnerDesc{}.warmupIters;
+    runner->run([warmupIters](const BenchmarkCase& bcase) {
+        BenchmarkPass pass;
+        U32 num = bcase.size;
+
+        auto* input = pass.buffers
+                          .emplace_back(std::make_unique<GPUBuffer>(
+                              num * sizeof(U32), BufferUsage::Storage))
+                          .get();
+        auto* output = pass.buffers
+                           .emplace_back(std::make_unique<GPUBuffer>(
+                               sizeof(U32), BufferUsage::Storage |
+                                                BufferUsage::CopySrc))
+                           .get();
+        GPURandomFill::create({.output = input, .count = num, .maxInt = 4})
+            ->execute();
+
+        // The kernels accumulate in the output, so after the warmup it holds
+        // warmupIters times the sum (modulo 2^32):
+        auto values = PhiloxRNG().uniform_int_vector(num, 0, 4);
+        U32 sum = std::accumulate(values.begin(), values.end(), 0U);
+        pass.validate = [output, expected = sum * warmupIters]() {
+            const U32* data = (U32*)output->copy_to_staged().read_sync();
+            return data != nullptr && *data == expected;
+        };
+
+        StringVector defs = bcase.defs;
+        if (bcase.kernel == "tests/reduction/reduc7") {
+            defs = ReductionAutotuner::make_reduc7_defs(256,
+                                                        bcase.reductionFactor);
+        }
+
+        U32 ngrps = ((num + 255) / 256) / bcase.reductionFactor;
+        pass.cpass = create_ref_object<WGPUComputePass>();
+        pass.cpass->add_simple_compute(
+            {.shaderFile = bcase.kernel.c_str(),
+             .entries = {input->as_sto(), output->as_rw_sto()},
+             .defs = defs,
+             .dims = {ngrps}});
+        pass.bytesPerDispatch = (U64)num * sizeof(U32);
+        pass.maxWorkgroups = ngrps;
+        return pass;
+    });
+
+    runner->write_json("reduction_benchmark.json");
+    runner->write_csv("reduction_benchmark.csv");
+    BOOST_CHECK_EQUAL(runner->get_num_invalid(), 0);
+    BOOST_CHECK_EQUAL(runner->get_num_skipped(), 0);
+    // Real timings are too noisy to fail a unit test, the regressions are
+    // only reported:
+    logNOTE("{} regression(s) against the baseline",
+            runner->get_num_regressions());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,30 @@
+// Packed narrow integer input: ELEM_BITS (8 or 16) bits per element, stored
+// little-endian in u32 words. Expects an inputBuffer of u32 words and a
+// params.count giving the number of elements.
+
+const ELEMS_PER_WORD: u32 = 32u / ELEM_BITS;
+
+// Number of words covering the valid elements:
+fn packed_num_words() -> u32 {
+    return (params.count + ELEMS_PER_WORD - 1) / ELEMS_PER_WORD;
+}
+
+// Sum of the elements in the word at index widx (u32 accumulator), the
+// elements past the end of the input are masked out:
+fn packed_word_sum(widx: u32) -> u32 {
+    var word: u32 = inputBuffer[widx];
+
+    let first: u32 = widx * ELEMS_PER_WORD;
+    if first + ELEMS_PER_WORD > params.count {
+        let valid: u32 = params.count - first;
+        word &= (1u << (valid * ELEM_BITS)) - 1u;
+    }
+
+    if ELEM_BITS == 8u {
+        // Add the bytes in pairs, then the 2 halves:
+        let pairs: u32 = (word & 0x00FF00FFu) + ((word >> 8) & 0x00FF00FFu);
+        return (pairs & 0xFFFFu) + (pairs >> 16);
+    }
+
+    return (word & 0xFFFFu) + (word >> 16);
+}
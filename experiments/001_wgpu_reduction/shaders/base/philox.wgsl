@@ -0,0 +1,59 @@
+// Philox4x32-10 counter-based random number generator (Salmon et al., 2011):
+// each (counter, key) pair gives 4 independent u32 values, without any state.
+// Note: keep in sync with PhiloxRNG on the host side.
+
+const PHILOX_M0: u32 = 0xD2511F53u;
+const PHILOX_M1: u32 = 0xCD9E8D57u;
+const PHILOX_W0: u32 = 0x9E3779B9u;
+const PHILOX_W1: u32 = 0xBB67AE85u;
+
+// Full 32x32 -> 64 bits product as (low, high) with 16 bits limbs:
+fn mul_wide_u32(a: u32, b: u32) -> vec2u {
+    let a0: u32 = a & 0xFFFFu;
+    let a1: u32 = a >> 16u;
+    let b0: u32 = b & 0xFFFFu;
+    let b1: u32 = b >> 16u;
+
+    let p00: u32 = a0 * b0;
+    let p01: u32 = a0 * b1;
+    let p10: u32 = a1 * b0;
+    let p11: u32 = a1 * b1;
+
+    // Middle column, can't overflow (3 x 16 bits values):
+    let mid: u32 = (p00 >> 16u) + (p01 & 0xFFFFu) + (p10 & 0xFFFFu);
+    let lo: u32 = (mid << 16u) | (p00 & 0xFFFFu);
+    let hi: u32 = p11 + (p01 >> 16u) + (p10 >> 16u) + (mid >> 16u);
+    return vec2u(lo, hi);
+}
+
+fn philox_round(ctr: vec4u, key: vec2u) -> vec4u {
+    let r0 = mul_wide_u32(PHILOX_M0, ctr.x);
+    let r1 = mul_wide_u32(PHILOX_M1, ctr.z);
+    return vec4u(r1.y ^ ctr.y ^ key.x, r1.x, r0.y ^ ctr.w ^ key.y, r0.x);
+}
+
+fn philox4x32_10(counter: vec4u, seed: vec2u) -> vec4u {
+    var ctr = counter;
+    var key = seed;
+    for (var i: u32 = 0; i < 10; i++) {
+        if i > 0 {
+            key += vec2u(PHILOX_W0, PHILOX_W1);
+        }
+        ctr = philox_round(ctr, key);
+    }
+    return ctr;
+}
+
+// Uniform integer in [minVal, minVal + range) (full u32 range if range is 0),
+// with the (unbiased enough) multiply-high range reduction:
+fn philox_uniform_u32(x: u32, minVal: u32, range: u32) -> u32 {
+    if range == 0 {
+        return x;
+    }
+    return minVal + mul_wide_u32(x, range).y;
+}
+
+// Uniform float in [0, 1) with 24 random bits (exact in f32):
+fn philox_uniform_f32(x: u32) -> f32 {
+    return f32(x >> 8u) * (1.0 / 16777216.0);
+}
@@ -0,0 +1,13 @@
+// Emulated u64 arithmetic on vec2u values (x: low bits, y: high bits).
+
+fn add_u64(a: vec2u, b: vec2u) -> vec2u {
+    let lo: u32 = a.x + b.x;
+    // The low part wrapped around if the result is smaller than an operand:
+    let carry: u32 = select(0u, 1u, lo < a.x);
+    return vec2u(lo, a.y + b.y + carry);
+}
+
+fn add_u64_u32(a: vec2u, b: u32) -> vec2u {
+    let lo: u32 = a.x + b;
+    return vec2u(lo, a.y + select(0u, 1u, lo < b));
+}
@@ -0,0 +1,43 @@
+// Batched segment reduction, classification step:
+// One thread per segment (segment s covers [offsets[s], offsets[s+1]) in the
+// input). Empty segments directly get the identity value, the others are
+// appended to the list of their size class: small segments (at most
+// SMALL_MAX elements) are reduced by a slice of threads, large segments by a
+// full workgroup.
+
+struct Params {
+    // Number of segments (the offsets buffer contains numSegments+1 values):
+    numSegments: u32,
+    // Number of workgroups actually needed for this step:
+    numGroups: u32,
+    // Number of workgroups dispatched along X (for 2D folded dispatch):
+    groupsX: u32,
+}
+
+@group(0) @binding(0) var<storage,read> offsets: array<u32>;
+@group(0) @binding(1) var<storage,read_write> outputBuffer: array<u32>;
+// Small segment ids in [0, numSegments), large ones in [numSegments, 2*numSegments):
+@group(0) @binding(2) var<storage,read_write> segLists: array<u32>;
+// Number of segments in each size class (reset by batchreduce_init):
+@group(0) @binding(3) var<storage,read_write> counters: array<atomic<u32>, 2>;
+@group(0) @binding(4) var<storage,read> params: Params;
+
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(workgroup_id) gid: vec3<u32>, @builtin(local_invocation_id) local_id: vec3<u32>) {
+    let grp: u32 = gid.y * params.groupsX + gid.x;
+    let seg: u32 = grp * WG_SIZE + local_id.x;
+    if grp >= params.numGroups || seg >= params.numSegments {
+        return;
+    }
+
+    let len: u32 = offsets[seg + 1] - offsets[seg];
+    if len == 0 {
+        outputBuffer[seg] = REDUCE_IDENTITY;
+    } else if len <= SMALL_MAX {
+        let slot: u32 = atomicAdd(&counters[0], 1u);
+        segLists[slot] = seg;
+    } else {
+        let slot: u32 = atomicAdd(&counters[1], 1u);
+        segLists[params.numSegments + slot] = seg;
+    }
+}
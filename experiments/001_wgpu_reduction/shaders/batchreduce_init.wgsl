@@ -0,0 +1,9 @@
+// Reset the size class counters before a batched segment reduction.
+
+@group(0) @binding(0) var<storage,read_write> counters: array<u32, 2>;
+
+@compute @workgroup_size(1)
+fn main() {
+    counters[0] = 0;
+    counters[1] = 0;
+}
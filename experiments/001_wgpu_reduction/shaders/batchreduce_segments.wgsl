@@ -0,0 +1,89 @@
+// Batched segment reduction, reduction step for one size class:
+// Each workgroup is split in WG_SIZE / SLICE_SIZE slices, and each slice
+// reduces one segment of the class list at a time, with a grid-stride loop
+// over the list (the number of segments in the class is only known on the
+// GPU, so the dispatch is sized for the worst case and extra slices exit the
+// loop immediately). With SLICE_SIZE == WG_SIZE a full workgroup is used per
+// segment (large class).
+
+struct Params {
+    // Number of segments (the offsets buffer contains numSegments+1 values):
+    numSegments: u32,
+    // Number of workgroups dispatched for this class:
+    numGroups: u32,
+    // Number of workgroups dispatched along X (for 2D folded dispatch):
+    groupsX: u32,
+}
+
+@group(0) @binding(0) var<storage,read> inputBuffer: array<u32>;
+@group(0) @binding(1) var<storage,read> offsets: array<u32>;
+@group(0) @binding(2) var<storage,read_write> outputBuffer: array<u32>;
+@group(0) @binding(3) var<storage,read> segLists: array<u32>;
+@group(0) @binding(4) var<storage,read> counters: array<u32, 2>;
+@group(0) @binding(5) var<storage,read> params: Params;
+
+const SLICES_PER_GROUP: u32 = WG_SIZE / SLICE_SIZE;
+
+var<workgroup> sdata: array<u32, WG_SIZE>;
+
+fn reduce_op(a: u32, b: u32) -> u32 {
+#ifdef REDUCE_OP_MIN
+    return min(a, b);
+#else
+#ifdef REDUCE_OP_MAX
+    return max(a, b);
+#else
+    return a + b;
+#endif
+#endif
+}
+
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(workgroup_id) gid: vec3<u32>, @builtin(local_invocation_id) local_id: vec3<u32>) {
+    let grp: u32 = gid.y * params.groupsX + gid.x;
+    if grp >= params.numGroups {
+        return;
+    }
+
+    let tid: u32 = local_id.x;
+    let slice: u32 = tid / SLICE_SIZE;
+    let lane: u32 = tid % SLICE_SIZE;
+
+#ifdef LARGE_CLASS
+    let count: u32 = counters[1];
+    let listStart: u32 = params.numSegments;
+#else
+    let count: u32 = counters[0];
+    let listStart: u32 = 0u;
+#endif
+    let stride: u32 = params.numGroups * SLICES_PER_GROUP;
+
+    // Note: the loop bounds are uniform in the workgroup, so the barriers
+    // below are valid even if some slices have no segment left:
+    for (var base: u32 = grp * SLICES_PER_GROUP; base < count; base += stride) {
+        let item: u32 = base + slice;
+        var value: u32 = REDUCE_IDENTITY;
+        var seg: u32 = 0u;
+        if item < count {
+            seg = segLists[listStart + item];
+            let end: u32 = offsets[seg + 1];
+            for (var idx: u32 = offsets[seg] + lane; idx < end; idx += SLICE_SIZE) {
+                value = reduce_op(value, inputBuffer[idx]);
+            }
+        }
+        sdata[tid] = value;
+
+        workgroupBarrier();
+
+        for (var s: u32 = SLICE_SIZE / 2; s > 0; s >>= 1) {
+            if lane < s {
+                sdata[tid] = reduce_op(sdata[tid], sdata[tid + s]);
+            }
+            workgroupBarrier();
+        }
+
+        if lane == 0 && item < count {
+            outputBuffer[seg] = sdata[tid];
+        }
+    }
+}
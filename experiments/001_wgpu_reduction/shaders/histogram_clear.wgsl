@@ -0,0 +1,15 @@
+// Reset the global bins before a histogram computation.
+
+struct Params {
+    numBins: u32,
+}
+
+@group(0) @binding(0) var<storage,read_write> histogram: array<u32>;
+@group(0) @binding(1) var<storage,read> params: Params;
+
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(global_invocation_id) id: vec3<u32>) {
+    if id.x < params.numBins {
+        histogram[id.x] = 0;
+    }
+}
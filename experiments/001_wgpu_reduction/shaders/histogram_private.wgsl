@@ -0,0 +1,75 @@
+// Workgroup-privatized histogram:
+// Each workgroup counts GRID_FACTOR * WG_SIZE elements in its own bins in
+// workgroup memory (so the atomic contention stays local to the workgroup),
+// then merges the non empty bins into the global histogram with one atomic
+// per bin. When the NUM_BINS bins don't fit in workgroup memory, the kernel
+// is dispatched once per range of BINS_PER_PASS bins (starting at binOffset)
+// and only counts the elements falling in that range.
+// With GLOBAL_ATOMICS the elements are directly counted in the global bins
+// (reference implementation, collapses under contention).
+
+struct Params {
+    // Number of valid elements in the input buffer:
+    count: u32,
+    // Number of workgroups actually needed for this step:
+    numGroups: u32,
+    // Number of workgroups dispatched along X (for 2D folded dispatch):
+    groupsX: u32,
+    // The bin of a value is (value >> shift) & (NUM_BINS - 1):
+    shift: u32,
+    // First bin counted in this pass:
+    binOffset: u32,
+}
+
+@group(0) @binding(0) var<storage,read> inputBuffer: array<u32>;
+@group(0) @binding(1) var<storage,read_write> histogram: array<atomic<u32>>;
+@group(0) @binding(2) var<storage,read> params: Params;
+
+#ifndef GLOBAL_ATOMICS
+var<workgroup> bins: array<atomic<u32>, BINS_PER_PASS>;
+#endif
+
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(workgroup_id) gid: vec3<u32>, @builtin(local_invocation_id) local_id: vec3<u32>) {
+    let grp: u32 = gid.y * params.groupsX + gid.x;
+    if grp >= params.numGroups {
+        return;
+    }
+
+    var tid: u32 = local_id.x;
+
+#ifndef GLOBAL_ATOMICS
+    for (var b: u32 = tid; b < BINS_PER_PASS; b += WG_SIZE) {
+        atomicStore(&bins[b], 0u);
+    }
+    workgroupBarrier();
+#endif
+
+    var idx: u32 = grp * WG_SIZE * GRID_FACTOR + tid;
+    for (var i: u32 = 0; i < GRID_FACTOR; i++) {
+        if idx < params.count {
+            let bin: u32 = (inputBuffer[idx] >> params.shift) & (NUM_BINS - 1);
+#ifdef GLOBAL_ATOMICS
+            atomicAdd(&histogram[bin], 1u);
+#else
+            // Bins below binOffset wrap around to large values:
+            let slot: u32 = bin - params.binOffset;
+            if slot < BINS_PER_PASS {
+                atomicAdd(&bins[slot], 1u);
+            }
+#endif
+        }
+        idx += WG_SIZE;
+    }
+
+#ifndef GLOBAL_ATOMICS
+    workgroupBarrier();
+
+    for (var b: u32 = tid; b < BINS_PER_PASS; b += WG_SIZE) {
+        let c: u32 = atomicLoad(&bins[b]);
+        if c != 0 {
+            atomicAdd(&histogram[params.binOffset + b], c);
+        }
+    }
+#endif
+}
@@ -0,0 +1,260 @@
+// Single-pass 2D mip pyramid reduction (min, max or average):
+// Each workgroup reduces a tile of 64x64 source texels down to one texel of
+// level 6, keeping the intermediate levels in workgroup memory. The last
+// workgroup to finish (detected with a global atomic counter) then computes
+// the remaining top levels from the storage buffer, so the full pyramid is
+// built in a single dispatch. This relies on storageBarrier() + the atomic
+// counter making the other workgroups' writes visible, which the WGSL memory
+// model doesn't guarantee: with SPLIT_TOP_LEVELS the tile dispatch stops
+// after the tile levels, and the top levels are computed by a second
+// single-workgroup dispatch of this shader with TOP_LEVELS_PASS.
+// Level k has the size ceil(size[k-1] / 2) and each texel only reduces its
+// children that are inside the previous level (so min/max stay conservative
+// on non power of 2 sizes).
+// The source level is read from an f32 buffer, or from the first channel of
+// a texture (TEXTURE_INPUT), a texture array layer (TEXTURE_ARRAY_INPUT) or
+// a storage texture array layer (STORAGE_ARRAY_INPUT, with STORAGE_FORMAT).
+
+struct Level {
+    size: vec2u,
+    // Offset of the level in the input (level 0) or output buffer, or layer
+    // of the source texture array for level 0:
+    offset: u32,
+    pad: u32,
+}
+
+struct Params {
+    // Number of tiles along X:
+    tilesX: u32,
+    // Total number of tiles:
+    numTiles: u32,
+    // Number of workgroups dispatched along X (for 2D folded dispatch):
+    groupsX: u32,
+    // Number of levels written in the output (the source level 0 excluded):
+    numLevels: u32,
+    levels: array<Level, 16>,
+}
+
+#ifdef TOP_LEVELS_PASS
+@group(0) @binding(0) var<storage,read_write> outputBuffer: array<f32>;
+@group(0) @binding(1) var<storage,read> params: Params;
+#else
+#ifdef TEXTURE_INPUT
+@group(0) @binding(0) var inputTex: texture_2d<f32>;
+#else
+#ifdef TEXTURE_ARRAY_INPUT
+@group(0) @binding(0) var inputTex: texture_2d_array<f32>;
+#else
+#ifdef STORAGE_ARRAY_INPUT
+@group(0) @binding(0) var inputTex: texture_storage_2d_array<STORAGE_FORMAT, read>;
+#else
+@group(0) @binding(0) var<storage,read> inputBuffer: array<f32>;
+#endif
+#endif
+#endif
+@group(0) @binding(1) var<storage,read_write> outputBuffer: array<f32>;
+#ifdef SPLIT_TOP_LEVELS
+@group(0) @binding(2) var<storage,read> params: Params;
+#else
+@group(0) @binding(2) var<storage,read_write> counter: atomic<u32>;
+@group(0) @binding(3) var<storage,read> params: Params;
+#endif
+#endif
+
+const TILE_SIZE: u32 = 64;
+const TILE_LEVELS: u32 = 6;
+
+// Odd levels are stored in tileA, even levels in tileB:
+var<workgroup> tileA: array<f32, 1024>;
+var<workgroup> tileB: array<f32, 256>;
+var<workgroup> lastGroup: u32;
+
+fn op_identity() -> f32 {
+#ifdef MIP_OP_MIN
+    return 3.40282347e+38;
+#else
+#ifdef MIP_OP_MAX
+    return -3.40282347e+38;
+#else
+    return 0.0;
+#endif
+#endif
+}
+
+fn op_add(a: f32, b: f32) -> f32 {
+#ifdef MIP_OP_MIN
+    return min(a, b);
+#else
+#ifdef MIP_OP_MAX
+    return max(a, b);
+#else
+    return a + b;
+#endif
+#endif
+}
+
+fn op_final(a: f32, n: u32) -> f32 {
+#ifdef MIP_OP_AVG
+    return a / f32(max(n, 1u));
+#else
+    return a;
+#endif
+}
+
+fn is_inside(level: u32, p: vec2u) -> bool {
+    let size = params.levels[level].size;
+    return p.x < size.x && p.y < size.y;
+}
+
+#ifndef TOP_LEVELS_PASS
+fn load_source(p: vec2u) -> f32 {
+    let lvl = params.levels[0];
+#ifdef TEXTURE_INPUT
+    return textureLoad(inputTex, p, 0).x;
+#else
+#ifdef TEXTURE_ARRAY_INPUT
+    return textureLoad(inputTex, p, lvl.offset, 0).x;
+#else
+#ifdef STORAGE_ARRAY_INPUT
+    return textureLoad(inputTex, p, lvl.offset).x;
+#else
+    return inputBuffer[lvl.offset + p.y * lvl.size.x + p.x];
+#endif
+#endif
+#endif
+}
+#endif
+
+fn load_level(level: u32, p: vec2u) -> f32 {
+#ifndef TOP_LEVELS_PASS
+    if level == 0 {
+        return load_source(p);
+    }
+#endif
+    let lvl = params.levels[level];
+    return outputBuffer[lvl.offset + p.y * lvl.size.x + p.x];
+}
+
+fn store_level(level: u32, p: vec2u, v: f32) {
+    if is_inside(level, p) {
+        let lvl = params.levels[level];
+        outputBuffer[lvl.offset + p.y * lvl.size.x + p.x] = v;
+    }
+}
+
+fn read_tile(level: u32, idx: u32) -> f32 {
+    if (level & 1u) == 1u {
+        return tileA[idx];
+    }
+    return tileB[idx];
+}
+
+fn write_tile(level: u32, idx: u32, v: f32) {
+    if (level & 1u) == 1u {
+        tileA[idx] = v;
+    } else {
+        tileB[idx] = v;
+    }
+}
+
+// Reduce the children of texel p of level from the previous level in memory:
+fn reduce_from_memory(level: u32, p: vec2u) -> f32 {
+    var acc: f32 = op_identity();
+    var n: u32 = 0;
+    for (var d: u32 = 0; d < 4; d++) {
+        let c = 2 * p + vec2u(d & 1u, d >> 1u);
+        if is_inside(level - 1, c) {
+            acc = op_add(acc, load_level(level - 1, c));
+            n++;
+        }
+    }
+    return op_final(acc, n);
+}
+
+// Levels above the tile levels, from the storage buffer (single workgroup):
+fn reduce_top_levels(tid: u32) {
+    for (var level: u32 = TILE_LEVELS + 1; level <= params.numLevels; level++) {
+        let size = params.levels[level].size;
+        for (var i: u32 = tid; i < size.x * size.y; i += WG_SIZE) {
+            let p = vec2u(i % size.x, i / size.x);
+            store_level(level, p, reduce_from_memory(level, p));
+        }
+        storageBarrier();
+    }
+}
+
+#ifdef TOP_LEVELS_PASS
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(local_invocation_id) local_id: vec3<u32>) {
+    reduce_top_levels(local_id.x);
+}
+#else
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(workgroup_id) gid: vec3<u32>, @builtin(local_invocation_id) local_id: vec3<u32>) {
+    let grp: u32 = gid.y * params.groupsX + gid.x;
+    if grp >= params.numTiles {
+        return;
+    }
+
+    let tid: u32 = local_id.x;
+    let tile = vec2u(grp % params.tilesX, grp / params.tilesX);
+    let tileLevels: u32 = min(TILE_LEVELS, params.numLevels);
+
+    // Level 1 from the source texels:
+    for (var li: u32 = tid; li < 1024; li += WG_SIZE) {
+        let p = tile * (TILE_SIZE / 2) + vec2u(li % 32, li / 32);
+        let v = reduce_from_memory(1, p);
+        tileA[li] = v;
+        store_level(1, p, v);
+    }
+    workgroupBarrier();
+
+    // Next levels of the tile from workgroup memory:
+    for (var level: u32 = 2; level <= tileLevels; level++) {
+        let side: u32 = TILE_SIZE >> level;
+        for (var li: u32 = tid; li < side * side; li += WG_SIZE) {
+            let lp = vec2u(li % side, li / side);
+            let p = tile * side + lp;
+            var acc: f32 = op_identity();
+            var n: u32 = 0;
+            for (var d: u32 = 0; d < 4; d++) {
+                let o = vec2u(d & 1u, d >> 1u);
+                if is_inside(level - 1, 2 * p + o) {
+                    let cl = 2 * lp + o;
+                    acc = op_add(acc, read_tile(level - 1, cl.y * 2 * side + cl.x));
+                    n++;
+                }
+            }
+            let v = op_final(acc, n);
+            write_tile(level, li, v);
+            store_level(level, p, v);
+        }
+        workgroupBarrier();
+    }
+
+#ifndef SPLIT_TOP_LEVELS
+    if params.numLevels <= TILE_LEVELS {
+        return;
+    }
+
+    // Make the tile results visible before counting this workgroup:
+    storageBarrier();
+    if tid == 0 {
+        let done: u32 = atomicAdd(&counter, 1u);
+        lastGroup = select(0u, 1u, done == params.numTiles - 1);
+    }
+    if workgroupUniformLoad(&lastGroup) == 0 {
+        return;
+    }
+    storageBarrier();
+
+    // Last workgroup: remaining levels from the storage buffer.
+    reduce_top_levels(tid);
+
+    // Ready for the next execution:
+    if tid == 0 {
+        atomicStore(&counter, 0u);
+    }
+#endif
+}
+#endif
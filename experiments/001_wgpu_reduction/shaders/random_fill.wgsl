@@ -0,0 +1,63 @@
+// Fill a buffer with uniform random values from the Philox4x32-10 generator:
+// element i (counting from params.offset) is word (i % 4) of the generator
+// output for the counter (i / 4 as a u64, stream, 0) and the 64 bits seed, so
+// the sequence doesn't depend on the dispatch and can be reproduced on the
+// CPU. Each thread writes the 4 elements of one counter.
+// With FLOAT_OUTPUT the values are f32 in [minVal, minVal + scale), otherwise
+// u32 in [minVal, minVal + range).
+
+#include "base/philox"
+
+struct Params {
+    // Number of elements to write:
+    count: u32,
+    // Index of the first element in the random sequence:
+    offset: u32,
+    // Number of workgroups actually needed:
+    numGroups: u32,
+    // Number of workgroups dispatched along X (for 2D folded dispatch):
+    groupsX: u32,
+    seed: vec2u,
+    stream: u32,
+    // Offset of the first element in the output buffer:
+    outputOffset: u32,
+    // Min value (f32 bits with FLOAT_OUTPUT):
+    minVal: u32,
+    // Number of values (f32 bits of the scale with FLOAT_OUTPUT):
+    range: u32,
+}
+
+#ifdef FLOAT_OUTPUT
+@group(0) @binding(0) var<storage,read_write> outputBuffer: array<f32>;
+#else
+@group(0) @binding(0) var<storage,read_write> outputBuffer: array<u32>;
+#endif
+@group(0) @binding(1) var<storage,read> params: Params;
+
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(workgroup_id) gid: vec3<u32>, @builtin(local_invocation_id) local_id: vec3<u32>) {
+    let grp: u32 = gid.y * params.groupsX + gid.x;
+    if grp >= params.numGroups {
+        return;
+    }
+
+    // Counter of this thread, starting from the one containing offset:
+    let block: u32 = params.offset / 4u + grp * WG_SIZE + local_id.x;
+    // Note: offset + count fits in 32 bits, so the high part of the block
+    // index is always 0:
+    let rnd = philox4x32_10(vec4u(block, 0u, params.stream, 0u), params.seed);
+
+    for (var k: u32 = 0; k < 4; k++) {
+        let i: u32 = block * 4u + k;
+        if i >= params.offset && i - params.offset < params.count {
+#ifdef FLOAT_OUTPUT
+            let u: f32 = philox_uniform_f32(rnd[k]);
+            outputBuffer[params.outputOffset + i - params.offset] =
+                bitcast<f32>(params.minVal) + u * bitcast<f32>(params.range);
+#else
+            outputBuffer[params.outputOffset + i - params.offset] =
+                philox_uniform_u32(rnd[k], params.minVal, params.range);
+#endif
+        }
+    }
+}
@@ -0,0 +1,46 @@
+#include "base/wide"
+
+// Reduction #8: same structure as reduc7 (GRID_SIZE/WG_SIZE elements per
+// thread, tree reduction in shared memory, one atomic update per workgroup),
+// but with emulated u64 accumulators everywhere, so the total doesn't wrap
+// around at 2^32.
+
+@group(0) @binding(0) var<storage,read> inputBuffer: array<u32>;
+// Low and high words of the u64 total:
+@group(0) @binding(1) var<storage,read_write> output: array<atomic<u32>, 2>;
+
+var<workgroup> sdata: array<vec2u, WG_SIZE>;
+
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(workgroup_id) gid: vec3<u32>, @builtin(local_invocation_id) local_id: vec3<u32>) {
+    var tid: u32 = local_id.x;
+    var idx: u32 = gid.x * GRID_SIZE + tid;
+
+    // Note: assuming here we don't need to check the input array bounds.
+    var value = vec2u(0);
+    for (var i: u32 = 0; i < GRID_SIZE / WG_SIZE; i++) {
+        value = add_u64_u32(value, inputBuffer[idx]);
+        idx += WG_SIZE;
+    }
+    sdata[tid] = value;
+
+    // sync all the threads:
+    workgroupBarrier();
+
+    for (var s: u32 = WG_SIZE / 2; s > 0; s >>= 1) {
+        if tid < s {
+            sdata[tid] = add_u64(sdata[tid], sdata[tid + s]);
+        }
+        workgroupBarrier();
+    }
+
+    // Cross-workgroup combine with carry propagation: the high word is only
+    // updated once the low word addition told us if it wrapped around, so
+    // the total is exact whatever the order of the workgroups:
+    if tid == 0 {
+        let total = sdata[0];
+        let old: u32 = atomicAdd(&output[0], total.x);
+        let carry: u32 = select(0u, 1u, old + total.x < old);
+        atomicAdd(&output[1], total.y + carry);
+    }
+}
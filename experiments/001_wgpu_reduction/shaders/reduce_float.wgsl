@@ -0,0 +1,115 @@
+// Deterministic f32 multi-pass reduction step:
+// Same layout as reduce_multipass, but the order of the additions only
+// depends on WG_SIZE and GRID_FACTOR: each thread accumulates its elements in
+// order, the workgroup tree is fixed and each workgroup writes its partial to
+// a fixed slot (no atomics). So the result is identical from run to run.
+// With KAHAN, the values are accumulated as (sum, compensation) pairs, and
+// PAIR_INPUT reads such pairs from a previous step. FINAL_OUTPUT writes the
+// compensated f32 sum instead of the pair.
+
+struct Params {
+    // Number of valid elements in the input buffer:
+    count: u32,
+    // Number of workgroups actually needed for this step:
+    numGroups: u32,
+    // Number of workgroups dispatched along X (for 2D folded dispatch):
+    groupsX: u32,
+}
+
+#ifdef KAHAN
+alias accum_t = vec2f;
+#else
+alias accum_t = f32;
+#endif
+
+#ifdef PAIR_INPUT
+alias input_t = vec2f;
+#else
+alias input_t = f32;
+#endif
+
+#ifdef FINAL_OUTPUT
+alias output_t = f32;
+#else
+alias output_t = accum_t;
+#endif
+
+@group(0) @binding(0) var<storage,read> inputBuffer: array<input_t>;
+@group(0) @binding(1) var<storage,read_write> outputBuffer: array<output_t>;
+@group(0) @binding(2) var<storage,read> params: Params;
+
+// Kahan summation step: acc.y holds the low order bits lost so far.
+fn kahan_add(acc: vec2f, value: f32) -> vec2f {
+    let y: f32 = value - acc.y;
+    let t: f32 = acc.x + y;
+    return vec2f(t, (t - acc.x) - y);
+}
+
+fn accum_add(a: accum_t, b: input_t) -> accum_t {
+#ifdef PAIR_INPUT
+    // The pair b stands for b.x - b.y:
+    return kahan_add(kahan_add(a, b.x), -b.y);
+#else
+#ifdef KAHAN
+    return kahan_add(a, b);
+#else
+    return a + b;
+#endif
+#endif
+}
+
+fn accum_merge(a: accum_t, b: accum_t) -> accum_t {
+#ifdef KAHAN
+    return kahan_add(kahan_add(a, b.x), -b.y);
+#else
+    return a + b;
+#endif
+}
+
+fn to_output(a: accum_t) -> output_t {
+#ifdef FINAL_OUTPUT
+#ifdef KAHAN
+    return a.x - a.y;
+#else
+    return a;
+#endif
+#else
+    return a;
+#endif
+}
+
+var<workgroup> sdata: array<accum_t, WG_SIZE>;
+
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(workgroup_id) gid: vec3<u32>, @builtin(local_invocation_id) local_id: vec3<u32>) {
+    let grp: u32 = gid.y * params.groupsX + gid.x;
+    if grp >= params.numGroups {
+        return;
+    }
+
+    var tid: u32 = local_id.x;
+    var idx: u32 = grp * WG_SIZE * GRID_FACTOR + tid;
+
+    var value = accum_t(0.0);
+    for (var i: u32 = 0; i < GRID_FACTOR; i++) {
+        if idx < params.count {
+            value = accum_add(value, inputBuffer[idx]);
+        }
+        idx += WG_SIZE;
+    }
+    sdata[tid] = value;
+
+    workgroupBarrier();
+
+    // Fixed pairwise tree:
+    for (var s: u32 = WG_SIZE / 2; s > 0; s >>= 1) {
+        if tid < s {
+            sdata[tid] = accum_merge(sdata[tid], sdata[tid + s]);
+        }
+        workgroupBarrier();
+    }
+
+    if tid == 0 {
+        outputBuffer[grp] = to_output(sdata[0]);
+    }
+}
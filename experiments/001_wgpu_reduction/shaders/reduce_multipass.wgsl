@@ -0,0 +1,107 @@
+// Generic multi-pass reduction step:
+// Each workgroup reduces GRID_FACTOR * WG_SIZE consecutive elements and writes
+// a single partial result in the output buffer (no atomics involved), so the
+// same kernel can be applied again on the partials until only 1 value is left.
+// With WIDE_ACCUM the accumulation is done on emulated u64 values (vec2u), and
+// WIDE_INPUT reads such u64 partials from a previous step.
+
+struct Params {
+    // Number of valid elements in the input buffer:
+    count: u32,
+    // Number of workgroups actually needed for this step:
+    numGroups: u32,
+    // Number of workgroups dispatched along X (for 2D folded dispatch):
+    groupsX: u32,
+}
+
+#ifdef WIDE_ACCUM
+#include "base/wide"
+alias accum_t = vec2u;
+#else
+alias accum_t = u32;
+#endif
+
+#ifdef WIDE_INPUT
+alias input_t = vec2u;
+#else
+alias input_t = u32;
+#endif
+
+@group(0) @binding(0) var<storage,read> inputBuffer: array<input_t>;
+@group(0) @binding(1) var<storage,read_write> outputBuffer: array<accum_t>;
+@group(0) @binding(2) var<storage,read> params: Params;
+
+#ifdef PACKED_INPUT
+#include "base/packed"
+#endif
+
+fn accum_add(a: accum_t, b: input_t) -> accum_t {
+#ifdef WIDE_INPUT
+    return add_u64(a, b);
+#else
+#ifdef WIDE_ACCUM
+    return add_u64_u32(a, b);
+#else
+    return a + b;
+#endif
+#endif
+}
+
+var<workgroup> sdata: array<accum_t, WG_SIZE>;
+
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(workgroup_id) gid: vec3<u32>, @builtin(local_invocation_id) local_id: vec3<u32>) {
+    // Fold the 2D dispatch back into a linear workgroup index:
+    let grp: u32 = gid.y * params.groupsX + gid.x;
+
+    // The last row of a 2D dispatch may contain some extra workgroups:
+    if grp >= params.numGroups {
+        return;
+    }
+
+    var tid: u32 = local_id.x;
+    var idx: u32 = grp * WG_SIZE * GRID_FACTOR + tid;
+    let count: u32 = params.count;
+
+    // Grid loop with bound checks: the input size doesn't need to be
+    // a multiple of the grid size anymore.
+    var value = accum_t(0);
+#ifdef PACKED_INPUT
+    // Grid loop on the packed words instead of the elements:
+    let numWords: u32 = packed_num_words();
+    for (var i: u32 = 0; i < GRID_FACTOR; i++) {
+        if idx < numWords {
+            value = accum_add(value, packed_word_sum(idx));
+        }
+        idx += WG_SIZE;
+    }
+#else
+    for (var i: u32 = 0; i < GRID_FACTOR; i++) {
+        if idx < count {
+            value = accum_add(value, inputBuffer[idx]);
+        }
+        idx += WG_SIZE;
+    }
+#endif
+    sdata[tid] = value;
+
+    // sync all the threads:
+    workgroupBarrier();
+
+    // Barrier-correct tree reduction in shared memory:
+    for (var s: u32 = WG_SIZE / 2; s > 0; s >>= 1) {
+        if tid < s {
+#ifdef WIDE_ACCUM
+            sdata[tid] = add_u64(sdata[tid], sdata[tid + s]);
+#else
+            sdata[tid] += sdata[tid + s];
+#endif
+        }
+        workgroupBarrier();
+    }
+
+    // Write the partial result for this workgroup:
+    if tid == 0 {
+        outputBuffer[grp] = sdata[0];
+    }
+}
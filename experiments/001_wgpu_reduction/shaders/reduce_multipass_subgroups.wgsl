@@ -0,0 +1,75 @@
+// Multi-pass reduction step using the WGSL subgroups feature:
+// Same layout as reduce_multipass, but the in-workgroup reduction uses
+// subgroupAdd() instead of the shared-memory tree. We don't make any assumption
+// on the subgroup size or on how invocations are mapped to subgroups: each
+// subgroup leader simply accumulates its partial in a workgroup atomic.
+
+enable subgroups;
+
+struct Params {
+    // Number of valid elements in the input buffer:
+    count: u32,
+    // Number of workgroups actually needed for this step:
+    numGroups: u32,
+    // Number of workgroups dispatched along X (for 2D folded dispatch):
+    groupsX: u32,
+}
+
+@group(0) @binding(0) var<storage,read> inputBuffer: array<u32>;
+@group(0) @binding(1) var<storage,read_write> outputBuffer: array<u32>;
+@group(0) @binding(2) var<storage,read> params: Params;
+
+#ifdef PACKED_INPUT
+#include "base/packed"
+#endif
+
+var<workgroup> wgSum: atomic<u32>;
+
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(workgroup_id) gid: vec3<u32>, @builtin(local_invocation_id) local_id: vec3<u32>,
+        @builtin(subgroup_invocation_id) sg_id: u32) {
+    // Fold the 2D dispatch back into a linear workgroup index:
+    let grp: u32 = gid.y * params.groupsX + gid.x;
+
+    // The last row of a 2D dispatch may contain some extra workgroups:
+    if grp >= params.numGroups {
+        return;
+    }
+
+    var tid: u32 = local_id.x;
+    var idx: u32 = grp * WG_SIZE * GRID_FACTOR + tid;
+    let count: u32 = params.count;
+
+    var value: u32 = 0;
+#ifdef PACKED_INPUT
+    // Grid loop on the packed words instead of the elements:
+    let numWords: u32 = packed_num_words();
+    for (var i: u32 = 0; i < GRID_FACTOR; i++) {
+        if idx < numWords {
+            value += packed_word_sum(idx);
+        }
+        idx += WG_SIZE;
+    }
+#else
+    for (var i: u32 = 0; i < GRID_FACTOR; i++) {
+        if idx < count {
+            value += inputBuffer[idx];
+        }
+        idx += WG_SIZE;
+    }
+#endif
+
+    // Reduce within the subgroup (must be called in uniform control flow):
+    let sgSum: u32 = subgroupAdd(value);
+    if sg_id == 0 {
+        atomicAdd(&wgSum, sgSum);
+    }
+
+    // sync all the threads:
+    workgroupBarrier();
+
+    // Write the partial result for this workgroup:
+    if tid == 0 {
+        outputBuffer[grp] = atomicLoad(&wgSum);
+    }
+}
@@ -0,0 +1,120 @@
+// Fused multi-statistic reduction step:
+// Same layout as reduce_multipass, but all the requested statistics are
+// computed from a single read of the f32 input, and each workgroup writes a
+// Stats partial. With STATS_INPUT the step reads the partials of a previous
+// step instead. The statistics are selected with the defines:
+// STAT_MIN, STAT_MAX, STAT_SUM, STAT_SUMSQ, STAT_ARGMIN and STAT_ARGMAX (the
+// arg variants also require the corresponding min/max).
+
+struct Params {
+    // Number of valid elements in the input buffer:
+    count: u32,
+    // Number of workgroups actually needed for this step:
+    numGroups: u32,
+    // Number of workgroups dispatched along X (for 2D folded dispatch):
+    groupsX: u32,
+}
+
+// Note: keep in sync with GPUReduceStats on the host side.
+struct Stats {
+    minVal: f32,
+    maxVal: f32,
+    sum: f32,
+    sumSq: f32,
+    argMin: u32,
+    argMax: u32,
+    pad0: u32,
+    pad1: u32,
+}
+
+#ifdef STATS_INPUT
+@group(0) @binding(0) var<storage,read> inputBuffer: array<Stats>;
+#else
+@group(0) @binding(0) var<storage,read> inputBuffer: array<f32>;
+#endif
+@group(0) @binding(1) var<storage,read_write> outputBuffer: array<Stats>;
+@group(0) @binding(2) var<storage,read> params: Params;
+
+const F32_MAX: f32 = 3.40282347e+38;
+const NO_INDEX: u32 = 0xFFFFFFFFu;
+
+fn stats_identity() -> Stats {
+    return Stats(F32_MAX, -F32_MAX, 0.0, 0.0, NO_INDEX, NO_INDEX, 0, 0);
+}
+
+fn stats_merge(a: Stats, b: Stats) -> Stats {
+    var r = a;
+#ifdef STAT_MIN
+#ifdef STAT_ARGMIN
+    // The lowest index wins on ties, so the result is deterministic:
+    if b.minVal < a.minVal || (b.minVal == a.minVal && b.argMin < a.argMin) {
+        r.minVal = b.minVal;
+        r.argMin = b.argMin;
+    }
+#else
+    r.minVal = min(a.minVal, b.minVal);
+#endif
+#endif
+#ifdef STAT_MAX
+#ifdef STAT_ARGMAX
+    if b.maxVal > a.maxVal || (b.maxVal == a.maxVal && b.argMax < a.argMax) {
+        r.maxVal = b.maxVal;
+        r.argMax = b.argMax;
+    }
+#else
+    r.maxVal = max(a.maxVal, b.maxVal);
+#endif
+#endif
+#ifdef STAT_SUM
+    r.sum = a.sum + b.sum;
+#endif
+#ifdef STAT_SUMSQ
+    r.sumSq = a.sumSq + b.sumSq;
+#endif
+    return r;
+}
+
+fn load_stats(idx: u32) -> Stats {
+#ifdef STATS_INPUT
+    return inputBuffer[idx];
+#else
+    let v: f32 = inputBuffer[idx];
+    return Stats(v, v, v, v * v, idx, idx, 0, 0);
+#endif
+}
+
+var<workgroup> sdata: array<Stats, WG_SIZE>;
+
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(workgroup_id) gid: vec3<u32>, @builtin(local_invocation_id) local_id: vec3<u32>) {
+    let grp: u32 = gid.y * params.groupsX + gid.x;
+    if grp >= params.numGroups {
+        return;
+    }
+
+    var tid: u32 = local_id.x;
+    var idx: u32 = grp * WG_SIZE * GRID_FACTOR + tid;
+
+    // Grid loop: all the statistics are updated from the same load.
+    var value = stats_identity();
+    for (var i: u32 = 0; i < GRID_FACTOR; i++) {
+        if idx < params.count {
+            value = stats_merge(value, load_stats(idx));
+        }
+        idx += WG_SIZE;
+    }
+    sdata[tid] = value;
+
+    workgroupBarrier();
+
+    for (var s: u32 = WG_SIZE / 2; s > 0; s >>= 1) {
+        if tid < s {
+            sdata[tid] = stats_merge(sdata[tid], sdata[tid + s]);
+        }
+        workgroupBarrier();
+    }
+
+    if tid == 0 {
+        outputBuffer[grp] = sdata[0];
+    }
+}
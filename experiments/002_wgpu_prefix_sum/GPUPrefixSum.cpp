@@ -0,0 +1,207 @@
+#include <GPUPrefixSum.h>
+#include <GPUReducer.h>
+
+using namespace wgpu;
+
+namespace nv {
+
+GPUPrefixSum::GPUPrefixSum(const GPUPrefixSumDesc& desc) : _desc(desc) {
+    NVCHK(_desc.input != nullptr, "GPUPrefixSum: invalid input buffer.");
+    NVCHK(_desc.output != nullptr, "GPUPrefixSum: invalid output buffer.");
+    NVCHK(_desc.count > 0, "GPUPrefixSum: cannot scan empty input.");
+
+    _numTiles = (U32)(((U64)_desc.count + kTileSize - 1) / kTileSize);
+
+    // The single pass tile statuses hold the prefixes on 30 bits:
+    U64 maxTotal = get_max_total(_desc);
+    bool fits = maxTotal < kMaxSinglePassTotal;
+
+    _mode = _desc.mode;
+    if (_mode == PrefixSumMode::Auto) {
+        _mode = is_single_pass_safe() && fits ? PrefixSumMode::SinglePass
+                                              : PrefixSumMode::ReduceThenScan;
+    }
+    NVCHK(_mode != PrefixSumMode::SinglePass || fits,
+          "GPUPrefixSum: total sum bound {} too large for the single pass "
+          "mode (max 2^30).",
+          maxTotal);
+
+    _cpass = _desc.cpass != nullptr ? RefPtr<WGPUComputePass>(_desc.cpass)
+                                    : create_ref_object<WGPUComputePass>();
+
+    if (_mode == PrefixSumMode::SinglePass) {
+        U32 params[2] = {_desc.count, _numTiles};
+        _params = std::make_unique<GPUBuffer>(sizeof(params),
+                                              BufferUsage::Storage, params);
+        build_single_pass();
+    } else {
+        build_reduce_then_scan(_desc.input, _desc.output, _desc.count,
+                               _desc.inclusive, _desc.inputFormat);
+    }
+};
+
+GPUPrefixSum::~GPUPrefixSum() = default;
+
+auto GPUPrefixSum::create(const GPUPrefixSumDesc& desc)
+    -> RefPtr<GPUPrefixSum> {
+    return nv::create<GPUPrefixSum>(desc);
+}
+
+auto GPUPrefixSum::get_max_total(const GPUPrefixSumDesc& desc) -> U64 {
+    if (desc.maxTotal > 0) {
+        return desc.maxTotal;
+    }
+
+    U64 maxValue = desc.inputFormat == InputFormat::PackedU8    ? 0xFF
+                   : desc.inputFormat == InputFormat::PackedU16 ? 0xFFFF
+                                                                : 0xFFFFFFFF;
+    return (U64)desc.count * maxValue;
+}
+
+auto GPUPrefixSum::is_single_pass_safe() -> bool {
+    auto* eng = WGPUEngine::instance();
+    AdapterInfo info{};
+    eng->get_adapter().GetInfo(&info);
+
+    // Software rasterizers (SwiftShader, lavapipe, WARP) do not schedule
+    // workgroups fairly and would deadlock in the look-back loop:
+    if (info.adapterType == AdapterType::CPU) {
+        return false;
+    }
+
+    // Same thing for the mobile GPU vendors (ARM, Qualcomm, ImgTec):
+    switch (info.vendorID) {
+    case 0x13B5:
+    case 0x5143:
+    case 0x1010:
+        return false;
+    default:
+        return true;
+    }
+}
+
+void GPUPrefixSum::build_single_pass() {
+    StringVector defs = {"WG_SIZE=" + std::to_string(kWorkgroupSize)};
+    if (!_desc.inclusive) {
+        defs.emplace_back("EXCLUSIVE");
+    }
+    for (auto& def : GPUReducer::get_input_format_defs(_desc.inputFormat)) {
+        defs.push_back(def);
+    }
+
+    // Slot 0 holds the tile counter:
+    _tileStatus = std::make_unique<GPUBuffer>(
+        (U64)(_numTiles + 1) * sizeof(U32), BufferUsage::Storage);
+
+    // Reset the tile statuses:
+    U32 initGroups = (_numTiles + 1 + kWorkgroupSize - 1) / kWorkgroupSize;
+    _cpass->add_simple_compute(
+        {.shaderFile = "tests/prefixsum/prefixsum6_init",
+         .entries = {_params->as_sto(), _tileStatus->as_rw_sto()},
+         .defs = {"WG_SIZE=" + std::to_string(kWorkgroupSize)},
+         .dims = {initGroups}});
+
+    // Note: tile indices are allocated dynamically in the shader, so the
+    // shape of the dispatch doesn't matter:
+    U32 groupsX = 0;
+    U32 groupsY = 0;
+    GPUReducer::get_dispatch_size(_numTiles, _desc.maxWorkgroupsPerDimension,
+                                  groupsX, groupsY);
+
+    logDEBUG("GPUPrefixSum: scanning {} elements in {} tiles", _desc.count,
+             _numTiles);
+
+    _cpass->add_simple_compute(
+        {.shaderFile = "tests/prefixsum/prefixsum6_decoupledlookback",
+         .entries = {_desc.input->as_sto(), _desc.output->as_rw_sto(),
+                     _params->as_sto(), _tileStatus->as_rw_sto()},
+         .defs = defs,
+         .dims = {groupsX, groupsY}});
+}
+
+void GPUPrefixSum::build_reduce_then_scan(GPUBuffer* input, GPUBuffer* output,
+                                          U32 count, bool inclusive,
+                                          InputFormat format) {
+    U32 numTiles = (U32)(((U64)count + kTileSize - 1) / kTileSize);
+
+    U32 groupsX = 0;
+    U32 groupsY = 0;
+    GPUReducer::get_dispatch_size(numTiles, _desc.maxWorkgroupsPerDimension,
+                                  groupsX, groupsY);
+
+    // Same layout as the params of the reduce_multipass kernel:
+    U32 params[3] = {count, numTiles, groupsX};
+    // Note: keep raw pointers since _buffers grows in the recursive calls.
+    GPUBuffer* paramsBuf = _buffers
+                               .emplace_back(std::make_unique<GPUBuffer>(
+                                   sizeof(params), BufferUsage::Storage, params))
+                               .get();
+
+    StringVector defs = {"WG_SIZE=" + std::to_string(kWorkgroupSize)};
+    if (!inclusive) {
+        defs.emplace_back("EXCLUSIVE");
+    }
+    StringVector formatDefs = GPUReducer::get_input_format_defs(format);
+    for (auto& def : formatDefs) {
+        defs.push_back(def);
+    }
+
+    logDEBUG("GPUPrefixSum: reduce-then-scan level with {} elements in {} "
+             "tiles",
+             count, numTiles);
+
+    if (numTiles == 1) {
+        // Top level: a single tile, no offsets to add.
+        _cpass->add_simple_compute(
+            {.shaderFile = "tests/prefixsum/prefixsum7_scanadd",
+             .entries = {input->as_sto(), output->as_rw_sto(),
+                         paramsBuf->as_sto()},
+             .defs = defs,
+             .dims = {groupsX, groupsY}});
+        return;
+    }
+
+    GPUBuffer* tileSums = _buffers
+                              .emplace_back(std::make_unique<GPUBuffer>(
+                                  (U64)numTiles * sizeof(U32),
+                                  BufferUsage::Storage))
+                              .get();
+    GPUBuffer* tileOffsets = _buffers
+                                 .emplace_back(std::make_unique<GPUBuffer>(
+                                     (U64)numTiles * sizeof(U32),
+                                     BufferUsage::Storage))
+                                 .get();
+
+    // Phase 1: reduce each tile (the reduction workgroups cover exactly the
+    // same elements as the scan tiles, so the packed inputs need less words
+    // per thread):
+    U32 gridFactor = 4 / GPUReducer::get_elements_per_word(format);
+    StringVector reduceDefs = {"WG_SIZE=" + std::to_string(kWorkgroupSize),
+                               "GRID_FACTOR=" + std::to_string(gridFactor)};
+    for (auto& def : formatDefs) {
+        reduceDefs.push_back(def);
+    }
+    _cpass->add_simple_compute(
+        {.shaderFile = "tests/reduction/reduce_multipass",
+         .entries = {input->as_sto(), tileSums->as_rw_sto(),
+                     paramsBuf->as_sto()},
+         .defs = reduceDefs,
+         .dims = {groupsX, groupsY}});
+
+    // Phase 2: exclusive scan of the tile sums:
+    build_reduce_then_scan(tileSums, tileOffsets, numTiles, false,
+                           InputFormat::U32);
+
+    // Phase 3: scan each tile and add its offset:
+    defs.emplace_back("TILE_OFFSETS");
+    _cpass->add_simple_compute(
+        {.shaderFile = "tests/prefixsum/prefixsum7_scanadd",
+         .entries = {input->as_sto(), output->as_rw_sto(), paramsBuf->as_sto(),
+                     tileOffsets->as_sto()},
+         .defs = defs,
+         .dims = {groupsX, groupsY}});
+}
+
+void GPUPrefixSum::execute() { _cpass->execute(); }
+
+} // namespace nv
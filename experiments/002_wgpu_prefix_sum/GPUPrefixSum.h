@@ -0,0 +1,124 @@
+#ifndef NV_GPUPREFIXSUM_H_
+#define NV_GPUPREFIXSUM_H_
+
+#include <GPUReducer.h>
+
+namespace nv {
+
+enum class PrefixSumMode : U8 {
+    /** Select the mode from the adapter type. */
+    Auto,
+    /** Chained scan with decoupled look-back (requires forward progress). */
+    SinglePass,
+    /** Hierarchical reduce tiles / scan tile sums / scan and add. */
+    ReduceThenScan,
+};
+
+struct GPUPrefixSumDesc {
+    /** Input buffer containing the values to scan. */
+    GPUBuffer* input{nullptr};
+
+    /** Output buffer receiving the scanned values. */
+    GPUBuffer* output{nullptr};
+
+    /** Number of elements to scan. */
+    U32 count{0};
+
+    /** Compute an inclusive (or exclusive) scan. */
+    bool inclusive{true};
+
+    /** Max number of workgroups per dispatch dimension. */
+    U32 maxWorkgroupsPerDimension{kDefaultMaxWorkgroupsPerDimension};
+
+    /** Scan algorithm to use. Note that with U32 input and no maxTotal the
+    derived bound is count * (2^32 - 1), never below 2^30, so Auto never
+    picks the single pass mode: pass maxTotal to get it (packed inputs only
+    reach it with small counts). */
+    PrefixSumMode mode{PrefixSumMode::Auto};
+
+    /** Optional compute pass to append the scan steps to. */
+    WGPUComputePass* cpass{nullptr};
+
+    /** Format of the input elements (the output is always u32). */
+    InputFormat inputFormat{InputFormat::U32};
+
+    /** Upper bound of the sum of all the input elements (0: derived from
+    the count and the range of the input format). Required with U32 input
+    to use the single pass mode (the derived bound is always too large). */
+    U64 maxTotal{0};
+};
+
+/**
+ * Device-wide prefix sum over a full buffer. The default single pass mode is
+ * a chained scan with decoupled look-back on top of the vec4 Sklansky tile
+ * scan, the reduce-then-scan mode is used on adapters that may not schedule
+ * workgroups fairly (software or mobile adapters).
+ * Note: the single pass mode packs the inclusive tile prefixes on 30 bits
+ * next to a 2 bits status flag, so it requires a total sum below 2^30 (cf.
+ * GPUPrefixSumDesc::maxTotal): the auto mode falls back to reduce-then-scan
+ * when the bound is larger.
+ */
+class NVGPU_EXPORT GPUPrefixSum : public RefObject {
+  public:
+    /** Workgroup size of the tile scan (fixed by base/prefixsum). */
+    static constexpr U32 kWorkgroupSize = 256;
+
+    /** Number of elements per tile. */
+    static constexpr U32 kTileSize = kWorkgroupSize * 4;
+
+    /** Exclusive bound of the total sum in the single pass mode (30 bits
+    tile prefixes). */
+    static constexpr U64 kMaxSinglePassTotal = 1ULL << 30;
+
+    explicit GPUPrefixSum(const GPUPrefixSumDesc& desc);
+    ~GPUPrefixSum() override;
+
+    static auto create(const GPUPrefixSumDesc& desc) -> RefPtr<GPUPrefixSum>;
+
+    /** Get the compute pass performing the scan. */
+    auto get_compute_pass() -> WGPUComputePass& { return *_cpass; }
+
+    /** Get the output buffer. */
+    auto get_output() -> GPUBuffer& { return *_desc.output; }
+
+    /** Get the number of tiles. */
+    auto get_num_tiles() const -> U32 { return _numTiles; }
+
+    /** Get the selected scan mode. */
+    auto get_mode() const -> PrefixSumMode { return _mode; }
+
+    /** Check if the current adapter guarantees forward progress between
+    workgroups, as required by the single pass mode. */
+    static auto is_single_pass_safe() -> bool;
+
+    /** Get the bound of the total sum of a scan (from maxTotal or from the
+    count and input format). */
+    static auto get_max_total(const GPUPrefixSumDesc& desc) -> U64;
+
+    /** Execute the scan immediately. */
+    void execute();
+
+  protected:
+    GPUPrefixSumDesc _desc;
+    RefPtr<WGPUComputePass> _cpass;
+    U32 _numTiles{0};
+    PrefixSumMode _mode{PrefixSumMode::SinglePass};
+
+    std::unique_ptr<GPUBuffer> _params;
+    std::unique_ptr<GPUBuffer> _tileStatus;
+
+    /** Intermediate buffers for the reduce-then-scan levels. */
+    Vector<std::unique_ptr<GPUBuffer>> _buffers;
+
+    /** Build the single pass look-back scan. */
+    void build_single_pass();
+
+    /** Recursively build the reduce-then-scan phases for one level. */
+    void build_reduce_then_scan(GPUBuffer* input, GPUBuffer* output,
+                                U32 count, bool inclusive,
+                                InputFormat format);
+};
+
+} // namespace nv
+
+#endif
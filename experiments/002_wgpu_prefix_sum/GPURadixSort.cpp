@@ -0,0 +1,109 @@
+#include <GPURadixSort.h>
+#include <GPUReducer.h>
+
+using namespace wgpu;
+
+namespace nv {
+
+GPURadixSort::GPURadixSort(const GPURadixSortDesc& desc) : _desc(desc) {
+    NVCHK(_desc.keys != nullptr, "GPURadixSort: invalid keys buffer.");
+    NVCHK(_desc.count > 0, "GPURadixSort: cannot sort empty input.");
+    NVCHK(_desc.itemsPerThread > 0, "GPURadixSort: invalid items per thread.");
+
+    U32 tileSize = kWorkgroupSize * _desc.itemsPerThread;
+    _numTiles = (U32)(((U64)_desc.count + tileSize - 1) / tileSize);
+
+    U32 groupsX = 0;
+    U32 groupsY = 0;
+    GPUReducer::get_dispatch_size(_numTiles, _desc.maxWorkgroupsPerDimension,
+                                  groupsX, groupsY);
+
+    U64 size = (U64)_desc.count * sizeof(U32);
+    _tempKeys = std::make_unique<GPUBuffer>(size, BufferUsage::Storage);
+    if (_desc.values != nullptr) {
+        _tempValues = std::make_unique<GPUBuffer>(size, BufferUsage::Storage);
+    }
+
+    U32 histCount = kRadix * _numTiles;
+    _tileHist = std::make_unique<GPUBuffer>((U64)histCount * sizeof(U32),
+                                            BufferUsage::Storage);
+    _digitOffsets = std::make_unique<GPUBuffer>((U64)histCount * sizeof(U32),
+                                                BufferUsage::Storage);
+
+    StringVector defs = {"WG_SIZE=" + std::to_string(kWorkgroupSize),
+                         "ITEMS_PER_THREAD=" +
+                             std::to_string(_desc.itemsPerThread)};
+    StringVector scatterDefs = defs;
+    if (_desc.values != nullptr) {
+        scatterDefs.emplace_back("WITH_VALUES");
+    }
+
+    logDEBUG("GPURadixSort: sorting {} keys in {} tiles", _desc.count,
+             _numTiles);
+
+    _cpass = create_ref_object<WGPUComputePass>();
+
+    // Ping-pong between the user buffers and the temp buffers: with an even
+    // number of passes the result ends up back in the user buffers.
+    GPUBuffer* keys[2] = {_desc.keys, _tempKeys.get()};
+    GPUBuffer* values[2] = {_desc.values, _tempValues.get()};
+
+    for (U32 pass = 0; pass < kNumPasses; ++pass) {
+        U32 src = pass & 1;
+        U32 dst = 1 - src;
+
+        U32 params[4] = {_desc.count, _numTiles, groupsX, pass * kRadixBits};
+        auto* paramsBuf = _params
+                              .emplace_back(std::make_unique<GPUBuffer>(
+                                  sizeof(params), BufferUsage::Storage, params))
+                              .get();
+
+        // Per-tile digit histograms:
+        _cpass->add_simple_compute(
+            {.shaderFile = "tests/prefixsum/radixsort_histogram",
+             .entries = {keys[src]->as_sto(), _tileHist->as_rw_sto(),
+                         paramsBuf->as_sto()},
+             .defs = defs,
+             .dims = {groupsX, groupsY}});
+
+        // Global exclusive scan of the digit-major histograms:
+        _scans.push_back(GPUPrefixSum::create(
+            {.input = _tileHist.get(),
+             .output = _digitOffsets.get(),
+             .count = histCount,
+             .inclusive = false,
+             .maxWorkgroupsPerDimension = _desc.maxWorkgroupsPerDimension,
+             .mode = _desc.scanMode,
+             .cpass = _cpass.get(),
+             .maxTotal = _desc.count}));
+
+        // Stable scatter:
+        if (_desc.values != nullptr) {
+            _cpass->add_simple_compute(
+                {.shaderFile = "tests/prefixsum/radixsort_scatter",
+                 .entries = {keys[src]->as_sto(), keys[dst]->as_rw_sto(),
+                             _digitOffsets->as_sto(), paramsBuf->as_sto(),
+                             values[src]->as_sto(), values[dst]->as_rw_sto()},
+                 .defs = scatterDefs,
+                 .dims = {groupsX, groupsY}});
+        } else {
+            _cpass->add_simple_compute(
+                {.shaderFile = "tests/prefixsum/radixsort_scatter",
+                 .entries = {keys[src]->as_sto(), keys[dst]->as_rw_sto(),
+                             _digitOffsets->as_sto(), paramsBuf->as_sto()},
+                 .defs = scatterDefs,
+                 .dims = {groupsX, groupsY}});
+        }
+    }
+};
+
+GPURadixSort::~GPURadixSort() = default;
+
+auto GPURadixSort::create(const GPURadixSortDesc& desc)
+    -> RefPtr<GPURadixSort> {
+    return nv::create<GPURadixSort>(desc);
+}
+
+void GPURadixSort::execute() { _cpass->execute(); }
+
+} // namespace nv
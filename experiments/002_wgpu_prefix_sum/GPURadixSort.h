@@ -0,0 +1,70 @@
+#ifndef NV_GPURADIXSORT_H_
+#define NV_GPURADIXSORT_H_
+
+#include <GPUPrefixSum.h>
+
+namespace nv {
+
+struct GPURadixSortDesc {
+    /** Buffer containing the u32 keys to sort (sorted in place). */
+    GPUBuffer* keys{nullptr};
+
+    /** Optional buffer of u32 values reordered with the keys. */
+    GPUBuffer* values{nullptr};
+
+    /** Number of keys to sort. */
+    U32 count{0};
+
+    /** Number of keys handled by each thread in a tile. */
+    U32 itemsPerThread{16};
+
+    /** Max number of workgroups per dispatch dimension. */
+    U32 maxWorkgroupsPerDimension{kDefaultMaxWorkgroupsPerDimension};
+
+    /** Scan algorithm used for the digit offsets. */
+    PrefixSumMode scanMode{PrefixSumMode::Auto};
+};
+
+/**
+ * Device-wide stable LSD radix sort of u32 keys (with optional u32 values),
+ * using 4 bit digits: for each digit we compute per-tile histograms, scan
+ * them globally and scatter the keys stably.
+ */
+class NVGPU_EXPORT GPURadixSort : public RefObject {
+  public:
+    static constexpr U32 kRadixBits = 4;
+    static constexpr U32 kRadix = 1 << kRadixBits;
+    static constexpr U32 kNumPasses = 32 / kRadixBits;
+
+    explicit GPURadixSort(const GPURadixSortDesc& desc);
+    ~GPURadixSort() override;
+
+    static auto create(const GPURadixSortDesc& desc) -> RefPtr<GPURadixSort>;
+
+    /** Get the compute pass performing the sort. */
+    auto get_compute_pass() -> WGPUComputePass& { return *_cpass; }
+
+    /** Get the number of tiles. */
+    auto get_num_tiles() const -> U32 { return _numTiles; }
+
+    /** Execute the sort immediately. */
+    void execute();
+
+  protected:
+    static constexpr U32 kWorkgroupSize = 256;
+
+    GPURadixSortDesc _desc;
+    RefPtr<WGPUComputePass> _cpass;
+    U32 _numTiles{0};
+
+    std::unique_ptr<GPUBuffer> _tempKeys;
+    std::unique_ptr<GPUBuffer> _tempValues;
+    std::unique_ptr<GPUBuffer> _tileHist;
+    std::unique_ptr<GPUBuffer> _digitOffsets;
+    Vector<std::unique_ptr<GPUBuffer>> _params;
+    Vector<RefPtr<GPUPrefixSum>> _scans;
+};
+
+} // namespace nv
+
+#endif
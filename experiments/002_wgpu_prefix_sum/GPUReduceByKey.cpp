@@ -0,0 +1,84 @@
+#include <GPUReduceByKey.h>
+#include <GPUReducer.h>
+
+using namespace wgpu;
+
+namespace nv {
+
+GPUReduceByKey::GPUReduceByKey(const GPUReduceByKeyDesc& desc) : _desc(desc) {
+    NVCHK(_desc.keys != nullptr, "GPUReduceByKey: invalid keys buffer.");
+    NVCHK(_desc.values != nullptr, "GPUReduceByKey: invalid values buffer.");
+    NVCHK(_desc.outputKeys != nullptr && _desc.outputValues != nullptr,
+          "GPUReduceByKey: invalid output buffers.");
+    NVCHK(_desc.count > 0, "GPUReduceByKey: cannot reduce empty input.");
+
+    U32 numGroups = (_desc.count + kWorkgroupSize - 1) / kWorkgroupSize;
+    U32 groupsX = 0;
+    U32 groupsY = 0;
+    GPUReducer::get_dispatch_size(numGroups, _desc.maxWorkgroupsPerDimension,
+                                  groupsX, groupsY);
+
+    U32 params[3] = {_desc.count, numGroups, groupsX};
+    _params = std::make_unique<GPUBuffer>(sizeof(params), BufferUsage::Storage,
+                                          params);
+
+    U64 size = (U64)_desc.count * sizeof(U32);
+    _flags = std::make_unique<GPUBuffer>(size, BufferUsage::Storage);
+    _runIds = std::make_unique<GPUBuffer>(size, BufferUsage::Storage);
+    _runSums = std::make_unique<GPUBuffer>(size, BufferUsage::Storage);
+    _counts = std::make_unique<GPUBuffer>(
+        sizeof(U32), BufferUsage::Storage | BufferUsage::CopySrc);
+
+    _cpass = create_ref_object<WGPUComputePass>();
+    StringVector defs = {"WG_SIZE=" + std::to_string(kWorkgroupSize)};
+
+    // Phase 1: flag the head of each run:
+    _cpass->add_simple_compute(
+        {.shaderFile = "tests/prefixsum/reducebykey_flags",
+         .entries = {_desc.keys->as_sto(), _flags->as_rw_sto(),
+                     _params->as_sto()},
+         .defs = defs,
+         .dims = {groupsX, groupsY}});
+
+    // Phase 2: run indices from the inclusive scan of the flags:
+    _runScan = GPUPrefixSum::create(
+        {.input = _flags.get(),
+         .output = _runIds.get(),
+         .count = _desc.count,
+         .inclusive = true,
+         .maxWorkgroupsPerDimension = _desc.maxWorkgroupsPerDimension,
+         .mode = _desc.scanMode,
+         .cpass = _cpass.get(),
+         .maxTotal = _desc.count});
+
+    // Phase 3: segmented sums of the values:
+    _valueScan = GPUSegmentedScan::create(
+        {.input = _desc.values,
+         .output = _runSums.get(),
+         .count = _desc.count,
+         .flags = _flags.get(),
+         .inclusive = true,
+         .maxWorkgroupsPerDimension = _desc.maxWorkgroupsPerDimension,
+         .cpass = _cpass.get()});
+
+    // Phase 4: write one key/value per run:
+    _cpass->add_simple_compute(
+        {.shaderFile = "tests/prefixsum/reducebykey_scatter",
+         .entries = {_desc.keys->as_sto(), _flags->as_sto(), _runIds->as_sto(),
+                     _runSums->as_sto(), _desc.outputKeys->as_rw_sto(),
+                     _desc.outputValues->as_rw_sto(), _counts->as_rw_sto(),
+                     _params->as_sto()},
+         .defs = defs,
+         .dims = {groupsX, groupsY}});
+};
+
+GPUReduceByKey::~GPUReduceByKey() = default;
+
+auto GPUReduceByKey::create(const GPUReduceByKeyDesc& desc)
+    -> RefPtr<GPUReduceByKey> {
+    return nv::create<GPUReduceByKey>(desc);
+}
+
+void GPUReduceByKey::execute() { _cpass->execute(); }
+
+} // namespace nv
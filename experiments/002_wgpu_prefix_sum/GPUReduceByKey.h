@@ -0,0 +1,71 @@
+#ifndef NV_GPUREDUCEBYKEY_H_
+#define NV_GPUREDUCEBYKEY_H_
+
+#include <GPUPrefixSum.h>
+#include <GPUSegmentedScan.h>
+
+namespace nv {
+
+struct GPUReduceByKeyDesc {
+    /** Input keys (runs of equal keys are collapsed). */
+    GPUBuffer* keys{nullptr};
+
+    /** Input u32 values summed over each run. */
+    GPUBuffer* values{nullptr};
+
+    /** Number of input elements. */
+    U32 count{0};
+
+    /** Output buffer receiving the key of each run. */
+    GPUBuffer* outputKeys{nullptr};
+
+    /** Output buffer receiving the sum of each run. */
+    GPUBuffer* outputValues{nullptr};
+
+    /** Max number of workgroups per dispatch dimension. */
+    U32 maxWorkgroupsPerDimension{kDefaultMaxWorkgroupsPerDimension};
+
+    /** Scan algorithm used for the run indices. */
+    PrefixSumMode scanMode{PrefixSumMode::Auto};
+};
+
+/**
+ * Reduce-by-key on the GPU: collapse the runs of equal consecutive keys,
+ * writing one key and the sum of the corresponding values per run. The
+ * number of runs is written in the count buffer.
+ */
+class NVGPU_EXPORT GPUReduceByKey : public RefObject {
+  public:
+    explicit GPUReduceByKey(const GPUReduceByKeyDesc& desc);
+    ~GPUReduceByKey() override;
+
+    static auto create(const GPUReduceByKeyDesc& desc)
+        -> RefPtr<GPUReduceByKey>;
+
+    /** Get the compute pass performing the reduction. */
+    auto get_compute_pass() -> WGPUComputePass& { return *_cpass; }
+
+    /** Get the buffer containing the number of runs. */
+    auto get_count_buffer() -> GPUBuffer& { return *_counts; }
+
+    /** Execute the reduction immediately. */
+    void execute();
+
+  protected:
+    static constexpr U32 kWorkgroupSize = 256;
+
+    GPUReduceByKeyDesc _desc;
+    RefPtr<WGPUComputePass> _cpass;
+    RefPtr<GPUPrefixSum> _runScan;
+    RefPtr<GPUSegmentedScan> _valueScan;
+
+    std::unique_ptr<GPUBuffer> _params;
+    std::unique_ptr<GPUBuffer> _flags;
+    std::unique_ptr<GPUBuffer> _runIds;
+    std::unique_ptr<GPUBuffer> _runSums;
+    std::unique_ptr<GPUBuffer> _counts;
+};
+
+} // namespace nv
+
+#endif
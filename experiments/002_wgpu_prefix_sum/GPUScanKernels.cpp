@@ -0,0 +1,206 @@
+#include <GPUReducer.h>
+#include <GPUScanKernels.h>
+#include <ReductionAutotuner.h>
+#include <WGPUEngine.h>
+
+using namespace wgpu;
+
+namespace nv {
+
+static auto is_float_type(ScanElementType type) -> bool {
+    return type == ScanElementType::F32 || type == ScanElementType::Vec2F ||
+           type == ScanElementType::Vec4F;
+}
+
+static auto is_signed_type(ScanElementType type) -> bool {
+    return type == ScanElementType::I32 || type == ScanElementType::Vec2I ||
+           type == ScanElementType::Vec4I;
+}
+
+auto GPUScanKernels::is_supported(const ScanKernelDesc& desc) -> bool {
+    if (desc.op == ScanOperator::Or && is_float_type(desc.type)) {
+        return false;
+    }
+
+    bool found = false;
+    for (U32 size : kWorkgroupSizes) {
+        found = found || size == desc.workgroupSize;
+    }
+    if (!found) {
+        return false;
+    }
+
+    // 512 is above the default WebGPU limits:
+    auto limits = GPUReducer::get_device_limits();
+    return desc.workgroupSize <= limits.maxComputeInvocationsPerWorkgroup &&
+           desc.workgroupSize <= limits.maxComputeWorkgroupSizeX;
+}
+
+auto GPUScanKernels::select_workgroup_size(ScanElementType type,
+                                           ScanOperator op, U32 count)
+    -> U32 {
+    static std::map<String, U32> selected;
+    String key = ReductionAutotuner::get_adapter_key() + "|" +
+                 get_type_name(type) + "|" + std::to_string((I32)op) + "|" +
+                 std::to_string(count);
+    auto it = selected.find(key);
+    if (it != selected.end()) {
+        return it->second;
+    }
+
+    auto* eng = WGPUEngine::instance();
+    U32 maxDim =
+        GPUReducer::get_device_limits().maxComputeWorkgroupsPerDimension;
+    U64 size = (U64)count * get_element_size(type);
+    GPUBuffer input(size, BufferUsage::Storage);
+    GPUBuffer output(size, BufferUsage::Storage);
+
+    constexpr U32 niters = 20;
+    U32 best = 0;
+    F64 bestNs = 0.0;
+    for (U32 wgSize : kWorkgroupSizes) {
+        ScanKernelDesc desc{.type = type, .op = op, .workgroupSize = wgSize};
+        if (!is_supported(desc)) {
+            continue;
+        }
+
+        U32 numGroups = (count + wgSize - 1) / wgSize;
+        U32 groupsX = 0;
+        U32 groupsY = 0;
+        GPUReducer::get_dispatch_size(numGroups, maxDim, groupsX, groupsY);
+        U32 params[3] = {count, numGroups, groupsX};
+        GPUBuffer paramsBuf(sizeof(params), BufferUsage::Storage, params);
+
+        auto cpass = create_ref_object<WGPUComputePass>();
+        cpass->add_simple_compute(
+            {.shaderFile = "tests/prefixsum/scan_generic",
+             .entries = {input.as_sto(), output.as_rw_sto(),
+                         paramsBuf.as_sto()},
+             .defs = make_defs(desc),
+             .dims = {groupsX, groupsY}});
+
+        // Dry-run (also compiles the pipeline):
+        auto& bld = eng->build_commands();
+        bld.execute_compute_pass(*cpass);
+        bld.submit();
+
+        bld.reset_all();
+        bld.write_timestamp(0);
+        for (U32 i = 0; i < niters; ++i) {
+            bld.execute_compute_pass(*cpass);
+        }
+        bld.write_timestamp(1);
+        bld.submit(false);
+
+        // Wait for the timed dispatches before reading the timestamps:
+        eng->wait_idle();
+        F64 elapsed = eng->get_timestamp_delta_ns(0, 1) / niters;
+        logDEBUG("GPUScanKernels: WG_SIZE={}: {:.0f} ns", wgSize, elapsed);
+        if (best == 0 || elapsed < bestNs) {
+            best = wgSize;
+            bestNs = elapsed;
+        }
+    }
+
+    NVCHK(best != 0, "GPUScanKernels: no supported workgroup size.");
+    logNOTE("GPUScanKernels: selected WG_SIZE={} for {} ({:.0f} ns)", best,
+            get_type_name(type), bestNs);
+    selected[key] = best;
+    return best;
+}
+
+auto GPUScanKernels::make_defs(const ScanKernelDesc& desc) -> StringVector {
+    NVCHK(is_supported(desc),
+          "GPUScanKernels: unsupported variant (type={}, op={}, WG_SIZE={})",
+          (I32)desc.type, (I32)desc.op, desc.workgroupSize);
+
+    StringVector defs = {"WG_SIZE=" + std::to_string(desc.workgroupSize),
+                         "SCAN_TYPE=" + get_type_name(desc.type),
+                         "SCAN_IDENTITY=" + get_identity(desc.type, desc.op)};
+
+    switch (desc.op) {
+    case ScanOperator::Add:
+        defs.emplace_back("SCAN_OP_ADD");
+        break;
+    case ScanOperator::Min:
+        defs.emplace_back("SCAN_OP_MIN");
+        break;
+    case ScanOperator::Max:
+        defs.emplace_back("SCAN_OP_MAX");
+        break;
+    case ScanOperator::Or:
+        defs.emplace_back("SCAN_OP_OR");
+        break;
+    }
+
+    return defs;
+}
+
+auto GPUScanKernels::get_type_name(ScanElementType type) -> String {
+    switch (type) {
+    case ScanElementType::U32:
+        return "u32";
+    case ScanElementType::I32:
+        return "i32";
+    case ScanElementType::F32:
+        return "f32";
+    case ScanElementType::Vec2U:
+        return "vec2u";
+    case ScanElementType::Vec4U:
+        return "vec4u";
+    case ScanElementType::Vec2I:
+        return "vec2i";
+    case ScanElementType::Vec4I:
+        return "vec4i";
+    case ScanElementType::Vec2F:
+        return "vec2f";
+    case ScanElementType::Vec4F:
+        return "vec4f";
+    }
+
+    THROW_MSG("GPUScanKernels: invalid element type {}", (I32)type);
+    return {};
+}
+
+auto GPUScanKernels::get_element_size(ScanElementType type) -> U32 {
+    switch (type) {
+    case ScanElementType::Vec2U:
+    case ScanElementType::Vec2I:
+    case ScanElementType::Vec2F:
+        return 2 * sizeof(U32);
+    case ScanElementType::Vec4U:
+    case ScanElementType::Vec4I:
+    case ScanElementType::Vec4F:
+        return 4 * sizeof(U32);
+    default:
+        return sizeof(U32);
+    }
+}
+
+auto GPUScanKernels::get_identity(ScanElementType type, ScanOperator op)
+    -> String {
+    // Note: the identity is a scalar, splatted by the scan_t() constructor
+    // in base/scan.
+    bool isFloat = is_float_type(type);
+    bool isSigned = is_signed_type(type);
+
+    switch (op) {
+    case ScanOperator::Add:
+    case ScanOperator::Or:
+        return isFloat ? "0.0" : "0";
+    case ScanOperator::Min:
+        if (isFloat) {
+            return "3.40282347e+38";
+        }
+        return isSigned ? "2147483647" : "0xFFFFFFFFu";
+    case ScanOperator::Max:
+        if (isFloat) {
+            return "-3.40282347e+38";
+        }
+        return isSigned ? "i32(-2147483648)" : "0u";
+    }
+
+    return "0";
+}
+
+} // namespace nv
@@ -0,0 +1,75 @@
+#ifndef NV_GPUSCANKERNELS_H_
+#define NV_GPUSCANKERNELS_H_
+
+#include <gpu_common.h>
+
+namespace nv {
+
+enum class ScanElementType : U8 {
+    U32,
+    I32,
+    F32,
+    Vec2U,
+    Vec4U,
+    Vec2I,
+    Vec4I,
+    Vec2F,
+    Vec4F,
+};
+
+enum class ScanOperator : U8 {
+    Add,
+    Min,
+    Max,
+    /** Bitwise or (integer types only). */
+    Or,
+};
+
+struct ScanKernelDesc {
+    /** Element type of the input and output buffers. */
+    ScanElementType type{ScanElementType::U32};
+
+    /** Associative operator. */
+    ScanOperator op{ScanOperator::Add};
+
+    /** Workgroup size (64, 128, 256 or 512, cf. select_workgroup_size()). */
+    U32 workgroupSize{256};
+};
+
+/**
+ * Build the defines for the generic scan kernels (base/scan, scan_generic),
+ * so that all the type/operator/workgroup size variants are generated from
+ * the same shader sources.
+ */
+class NVGPU_EXPORT GPUScanKernels {
+  public:
+    /** Supported workgroup sizes. */
+    static constexpr U32 kWorkgroupSizes[] = {64, 128, 256, 512};
+
+    /** Check if a combination of type, operator and workgroup size is
+    supported (including the workgroup limits of the current device). */
+    static auto is_supported(const ScanKernelDesc& desc) -> bool;
+
+    /** Select the fastest supported workgroup size for a type and operator
+    on the current adapter: the candidates are timed once on count elements
+    and the result is memoized. */
+    static auto select_workgroup_size(ScanElementType type, ScanOperator op,
+                                      U32 count = 1 << 22) -> U32;
+
+    /** Build the SCAN_*, WG_SIZE defines for a kernel variant. */
+    static auto make_defs(const ScanKernelDesc& desc) -> StringVector;
+
+    /** Get the WGSL type name of an element type. */
+    static auto get_type_name(ScanElementType type) -> String;
+
+    /** Get the size in bytes of an element type. */
+    static auto get_element_size(ScanElementType type) -> U32;
+
+    /** Get the WGSL expression of the operator identity. */
+    static auto get_identity(ScanElementType type, ScanOperator op)
+        -> String;
+};
+
+} // namespace nv
+
+#endif
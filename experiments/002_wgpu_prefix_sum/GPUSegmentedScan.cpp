@@ -0,0 +1,130 @@
+#include <GPUReducer.h>
+#include <GPUSegmentedScan.h>
+
+using namespace wgpu;
+
+namespace nv {
+
+GPUSegmentedScan::GPUSegmentedScan(const GPUSegmentedScanDesc& desc)
+    : _desc(desc) {
+    NVCHK(_desc.input != nullptr, "GPUSegmentedScan: invalid input buffer.");
+    NVCHK(_desc.output != nullptr, "GPUSegmentedScan: invalid output buffer.");
+    NVCHK(_desc.count > 0, "GPUSegmentedScan: cannot scan empty input.");
+    NVCHK(_desc.flags != nullptr || _desc.offsets != nullptr,
+          "GPUSegmentedScan: flags or offsets required.");
+
+    _cpass = _desc.cpass != nullptr ? RefPtr<WGPUComputePass>(_desc.cpass)
+                                    : create_ref_object<WGPUComputePass>();
+
+    _flags = _desc.flags;
+    if (_flags == nullptr) {
+        NVCHK(_desc.numSegments > 0, "GPUSegmentedScan: invalid segments.");
+
+        U32 numGroups = (_desc.count + kWorkgroupSize - 1) / kWorkgroupSize;
+        U32 groupsX = 0;
+        U32 groupsY = 0;
+        GPUReducer::get_dispatch_size(
+            numGroups, _desc.maxWorkgroupsPerDimension, groupsX, groupsY);
+
+        U32 params[4] = {_desc.count, numGroups, groupsX, _desc.numSegments};
+        auto* paramsBuf = _buffers
+                              .emplace_back(std::make_unique<GPUBuffer>(
+                                  sizeof(params), BufferUsage::Storage, params))
+                              .get();
+
+        _ownedFlags = std::make_unique<GPUBuffer>(
+            (U64)_desc.count * sizeof(U32), BufferUsage::Storage);
+        _flags = _ownedFlags.get();
+
+        _cpass->add_simple_compute(
+            {.shaderFile = "tests/prefixsum/segscan_offsets_to_flags",
+             .entries = {_desc.offsets->as_sto(), _flags->as_rw_sto(),
+                         paramsBuf->as_sto()},
+             .defs = {"WG_SIZE=" + std::to_string(kWorkgroupSize)},
+             .dims = {groupsX, groupsY}});
+    }
+
+    build_level(_desc.input, _flags, _desc.output, _desc.count,
+                _desc.inclusive);
+};
+
+GPUSegmentedScan::~GPUSegmentedScan() = default;
+
+auto GPUSegmentedScan::create(const GPUSegmentedScanDesc& desc)
+    -> RefPtr<GPUSegmentedScan> {
+    return nv::create<GPUSegmentedScan>(desc);
+}
+
+void GPUSegmentedScan::build_level(GPUBuffer* input, GPUBuffer* flags,
+                                   GPUBuffer* output, U32 count,
+                                   bool inclusive) {
+    U32 numTiles = (U32)(((U64)count + kTileSize - 1) / kTileSize);
+
+    U32 groupsX = 0;
+    U32 groupsY = 0;
+    GPUReducer::get_dispatch_size(numTiles, _desc.maxWorkgroupsPerDimension,
+                                  groupsX, groupsY);
+
+    U32 params[3] = {count, numTiles, groupsX};
+    // Note: keep raw pointers since _buffers grows in the recursive calls.
+    GPUBuffer* paramsBuf = _buffers
+                               .emplace_back(std::make_unique<GPUBuffer>(
+                                   sizeof(params), BufferUsage::Storage, params))
+                               .get();
+
+    StringVector defs = {"WG_SIZE=" + std::to_string(kWorkgroupSize)};
+    if (!inclusive) {
+        defs.emplace_back("EXCLUSIVE");
+    }
+
+    logDEBUG("GPUSegmentedScan: level with {} elements in {} tiles", count,
+             numTiles);
+
+    if (numTiles == 1) {
+        _cpass->add_simple_compute(
+            {.shaderFile = "tests/prefixsum/segscan_scan",
+             .entries = {input->as_sto(), flags->as_sto(), output->as_rw_sto(),
+                         paramsBuf->as_sto()},
+             .defs = defs,
+             .dims = {groupsX, groupsY}});
+        return;
+    }
+
+    U64 tilesSize = (U64)numTiles * sizeof(U32);
+    GPUBuffer* tileSums = _buffers
+                              .emplace_back(std::make_unique<GPUBuffer>(
+                                  tilesSize, BufferUsage::Storage))
+                              .get();
+    GPUBuffer* tileFlags = _buffers
+                               .emplace_back(std::make_unique<GPUBuffer>(
+                                   tilesSize, BufferUsage::Storage))
+                               .get();
+    GPUBuffer* tileCarry = _buffers
+                               .emplace_back(std::make_unique<GPUBuffer>(
+                                   tilesSize, BufferUsage::Storage))
+                               .get();
+
+    // Phase 1: (flag, value) aggregate of each tile:
+    _cpass->add_simple_compute(
+        {.shaderFile = "tests/prefixsum/segscan_tiles",
+         .entries = {input->as_sto(), flags->as_sto(), tileSums->as_rw_sto(),
+                     tileFlags->as_rw_sto(), paramsBuf->as_sto()},
+         .defs = {"WG_SIZE=" + std::to_string(kWorkgroupSize)},
+         .dims = {groupsX, groupsY}});
+
+    // Phase 2: inclusive segmented scan of the tile aggregates:
+    build_level(tileSums, tileFlags, tileCarry, numTiles, true);
+
+    // Phase 3: scan each tile with the carry from the previous tiles:
+    defs.emplace_back("TILE_CARRY");
+    _cpass->add_simple_compute(
+        {.shaderFile = "tests/prefixsum/segscan_scan",
+         .entries = {input->as_sto(), flags->as_sto(), output->as_rw_sto(),
+                     paramsBuf->as_sto(), tileCarry->as_sto()},
+         .defs = defs,
+         .dims = {groupsX, groupsY}});
+}
+
+void GPUSegmentedScan::execute() { _cpass->execute(); }
+
+} // namespace nv
@@ -0,0 +1,87 @@
+#ifndef NV_GPUSEGMENTEDSCAN_H_
+#define NV_GPUSEGMENTEDSCAN_H_
+
+#include <GPUReducer.h>
+
+namespace nv {
+
+struct GPUSegmentedScanDesc {
+    /** Input buffer containing the u32 values to scan. */
+    GPUBuffer* input{nullptr};
+
+    /** Output buffer receiving the scanned values. */
+    GPUBuffer* output{nullptr};
+
+    /** Number of elements to scan. */
+    U32 count{0};
+
+    /** Head flags (one u32 per element, non zero at the start of a
+    segment). */
+    GPUBuffer* flags{nullptr};
+
+    /** Sorted segment start offsets, used if no flags are provided. */
+    GPUBuffer* offsets{nullptr};
+
+    /** Number of segment offsets. */
+    U32 numSegments{0};
+
+    /** Compute an inclusive (or exclusive) scan. */
+    bool inclusive{true};
+
+    /** Max number of workgroups per dispatch dimension. */
+    U32 maxWorkgroupsPerDimension{kDefaultMaxWorkgroupsPerDimension};
+
+    /** Optional compute pass to append the scan steps to. */
+    WGPUComputePass* cpass{nullptr};
+};
+
+/**
+ * Device-wide segmented prefix sum over a packed buffer of variable length
+ * segments, described by head flags or by segment start offsets. Uses a
+ * Hillis-Steele block scan on (flag, value) pairs and the same hierarchical
+ * tile reduction as the reduce-then-scan prefix sum, so the whole buffer is
+ * processed with a few dispatches whatever the number of segments.
+ */
+class NVGPU_EXPORT GPUSegmentedScan : public RefObject {
+  public:
+    static constexpr U32 kWorkgroupSize = 256;
+
+    /** Number of elements per tile. */
+    static constexpr U32 kTileSize = kWorkgroupSize * 4;
+
+    explicit GPUSegmentedScan(const GPUSegmentedScanDesc& desc);
+    ~GPUSegmentedScan() override;
+
+    static auto create(const GPUSegmentedScanDesc& desc)
+        -> RefPtr<GPUSegmentedScan>;
+
+    /** Get the compute pass performing the scan. */
+    auto get_compute_pass() -> WGPUComputePass& { return *_cpass; }
+
+    /** Get the output buffer. */
+    auto get_output() -> GPUBuffer& { return *_desc.output; }
+
+    /** Get the head flags buffer (provided or computed from offsets). */
+    auto get_flags() -> GPUBuffer& { return *_flags; }
+
+    /** Execute the scan immediately. */
+    void execute();
+
+  protected:
+    GPUSegmentedScanDesc _desc;
+    RefPtr<WGPUComputePass> _cpass;
+    GPUBuffer* _flags{nullptr};
+
+    std::unique_ptr<GPUBuffer> _ownedFlags;
+
+    /** Intermediate buffers for the tile levels. */
+    Vector<std::unique_ptr<GPUBuffer>> _buffers;
+
+    /** Recursively build the segmented scan phases for one level. */
+    void build_level(GPUBuffer* input, GPUBuffer* flags, GPUBuffer* output,
+                     U32 count, bool inclusive);
+};
+
+} // namespace nv
+
+#endif
@@ -0,0 +1,85 @@
+#include <GPUReducer.h>
+#include <GPUStreamCompactor.h>
+
+using namespace wgpu;
+
+namespace nv {
+
+GPUStreamCompactor::GPUStreamCompactor(const GPUStreamCompactorDesc& desc)
+    : _desc(desc) {
+    NVCHK(_desc.input != nullptr, "GPUStreamCompactor: invalid input buffer.");
+    NVCHK(_desc.output != nullptr,
+          "GPUStreamCompactor: invalid output buffer.");
+    NVCHK(_desc.count > 0, "GPUStreamCompactor: cannot filter empty input.");
+
+    U32 numGroups = (_desc.count + kWorkgroupSize - 1) / kWorkgroupSize;
+    U32 groupsX = 0;
+    U32 groupsY = 0;
+    GPUReducer::get_dispatch_size(numGroups, _desc.maxWorkgroupsPerDimension,
+                                  groupsX, groupsY);
+
+    U32 params[3] = {_desc.count, numGroups, groupsX};
+    _params = std::make_unique<GPUBuffer>(sizeof(params), BufferUsage::Storage,
+                                          params);
+
+    U64 size = (U64)_desc.count * sizeof(U32);
+    _offsets = std::make_unique<GPUBuffer>(size, BufferUsage::Storage);
+    _counts = std::make_unique<GPUBuffer>(
+        8 * sizeof(U32),
+        BufferUsage::Storage | BufferUsage::Indirect | BufferUsage::CopySrc);
+
+    _cpass = create_ref_object<WGPUComputePass>();
+    StringVector defs = {"WG_SIZE=" + std::to_string(kWorkgroupSize)};
+
+    // Phase 1: evaluate the predicate, or normalize the provided flags to
+    // 0/1 (the scan offsets and the count assume unit flags):
+    _ownedFlags = std::make_unique<GPUBuffer>(size, BufferUsage::Storage);
+    GPUBuffer* flags = _ownedFlags.get();
+
+    bool provided = _desc.flags != nullptr;
+    StringVector flagDefs = defs;
+    flagDefs.push_back("PREDICATE(x)=" +
+                       (provided ? String("(x != 0u)") : _desc.predicate));
+    _cpass->add_simple_compute(
+        {.shaderFile = "tests/prefixsum/compact_flags",
+         .entries = {provided ? _desc.flags->as_sto() : _desc.input->as_sto(),
+                     flags->as_rw_sto(), _params->as_sto()},
+         .defs = flagDefs,
+         .dims = {groupsX, groupsY}});
+
+    // Phase 2: exclusive scan of the flags, appended to our pass:
+    _scan = GPUPrefixSum::create(
+        {.input = flags,
+         .output = _offsets.get(),
+         .count = _desc.count,
+         .inclusive = false,
+         .maxWorkgroupsPerDimension = _desc.maxWorkgroupsPerDimension,
+         .mode = _desc.scanMode,
+         .cpass = _cpass.get(),
+         .maxTotal = _desc.count});
+
+    // Phase 3: scatter the selected elements and write the counts:
+    StringVector scatterDefs = defs;
+    scatterDefs.push_back("INDIRECT_WG_SIZE=" +
+                          std::to_string(_desc.indirectWorkgroupSize));
+    scatterDefs.push_back("VERTICES_PER_ELEMENT=" +
+                          std::to_string(_desc.verticesPerElement));
+    _cpass->add_simple_compute(
+        {.shaderFile = "tests/prefixsum/compact_scatter",
+         .entries = {_desc.input->as_sto(), flags->as_sto(),
+                     _offsets->as_sto(), _desc.output->as_rw_sto(),
+                     _counts->as_rw_sto(), _params->as_sto()},
+         .defs = scatterDefs,
+         .dims = {groupsX, groupsY}});
+};
+
+GPUStreamCompactor::~GPUStreamCompactor() = default;
+
+auto GPUStreamCompactor::create(const GPUStreamCompactorDesc& desc)
+    -> RefPtr<GPUStreamCompactor> {
+    return nv::create<GPUStreamCompactor>(desc);
+}
+
+void GPUStreamCompactor::execute() { _cpass->execute(); }
+
+} // namespace nv
@@ -0,0 +1,85 @@
+#ifndef NV_GPUSTREAMCOMPACTOR_H_
+#define NV_GPUSTREAMCOMPACTOR_H_
+
+#include <GPUPrefixSum.h>
+
+namespace nv {
+
+struct GPUStreamCompactorDesc {
+    /** Input buffer containing the u32 values to filter. */
+    GPUBuffer* input{nullptr};
+
+    /** Number of input elements. */
+    U32 count{0};
+
+    /** Output buffer receiving the selected elements (densely packed). */
+    GPUBuffer* output{nullptr};
+
+    /** Optional precomputed flags (one u32 per element, 0 to drop and any
+    other value to keep, normalized to 0/1 before the scan). */
+    GPUBuffer* flags{nullptr};
+
+    /** WGSL predicate on the u32 value x, used if no flags are provided. */
+    String predicate{"(x != 0u)"};
+
+    /** Workgroup size used to compute the indirect dispatch arguments. */
+    U32 indirectWorkgroupSize{64};
+
+    /** Number of vertices per element for the indirect draw arguments. */
+    U32 verticesPerElement{1};
+
+    /** Max number of workgroups per dispatch dimension. */
+    U32 maxWorkgroupsPerDimension{kDefaultMaxWorkgroupsPerDimension};
+
+    /** Scan algorithm to use. */
+    PrefixSumMode scanMode{PrefixSumMode::Auto};
+};
+
+/**
+ * Stream compaction on the GPU: evaluate a predicate on each element, scan
+ * the flags and scatter the selected elements in a dense output buffer.
+ * The count buffer contains [count, dispatchX, 1, 1, verticesPerElement,
+ * count, 0, 0], usable for indirect dispatch (offset 4) or draw (offset 16).
+ */
+class NVGPU_EXPORT GPUStreamCompactor : public RefObject {
+  public:
+    /** Byte offset of the indirect dispatch arguments in the count buffer. */
+    static constexpr U64 kDispatchArgsOffset = 4;
+
+    /** Byte offset of the indirect draw arguments in the count buffer. */
+    static constexpr U64 kDrawArgsOffset = 16;
+
+    explicit GPUStreamCompactor(const GPUStreamCompactorDesc& desc);
+    ~GPUStreamCompactor() override;
+
+    static auto create(const GPUStreamCompactorDesc& desc)
+        -> RefPtr<GPUStreamCompactor>;
+
+    /** Get the compute pass performing the compaction. */
+    auto get_compute_pass() -> WGPUComputePass& { return *_cpass; }
+
+    /** Get the output buffer. */
+    auto get_output() -> GPUBuffer& { return *_desc.output; }
+
+    /** Get the count and indirect arguments buffer. */
+    auto get_count_buffer() -> GPUBuffer& { return *_counts; }
+
+    /** Execute the compaction immediately. */
+    void execute();
+
+  protected:
+    static constexpr U32 kWorkgroupSize = 256;
+
+    GPUStreamCompactorDesc _desc;
+    RefPtr<WGPUComputePass> _cpass;
+    RefPtr<GPUPrefixSum> _scan;
+
+    std::unique_ptr<GPUBuffer> _params;
+    std::unique_ptr<GPUBuffer> _ownedFlags;
+    std::unique_ptr<GPUBuffer> _offsets;
+    std::unique_ptr<GPUBuffer> _counts;
+};
+
+} // namespace nv
+
+#endif
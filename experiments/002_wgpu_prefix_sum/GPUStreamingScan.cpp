@@ -0,0 +1,164 @@
+#include <GPUReducer.h>
+#include <GPUStreamingScan.h>
+#include <WGPUEngine.h>
+
+using namespace wgpu;
+
+namespace nv {
+
+GPUStreamingScan::GPUStreamingScan(const GPUStreamingScanDesc& desc)
+    : _desc(desc) {
+    NVCHK(_desc.chunkSize > 0, "GPUStreamingScan: invalid chunk size.");
+
+    _numGroups = (_desc.chunkSize + kWorkgroupSize - 1) / kWorkgroupSize;
+    U32 groupsY = 0;
+    GPUReducer::get_dispatch_size(_numGroups, _desc.maxWorkgroupsPerDimension,
+                                  _groupsX, groupsY);
+
+    auto* eng = WGPUEngine::instance();
+    U64 size = (U64)_desc.chunkSize * sizeof(U32);
+
+    _carry = std::make_unique<GPUBuffer>(2 * sizeof(U32),
+                                         BufferUsage::Storage |
+                                             BufferUsage::CopyDst);
+
+    StringVector defs = {"WG_SIZE=" + std::to_string(kWorkgroupSize)};
+    if (!_desc.inclusive) {
+        defs.emplace_back("EXCLUSIVE");
+    }
+
+    for (U32 p = 0; p < 2; ++p) {
+        _inputs[p] = std::make_unique<GPUBuffer>(
+            size, BufferUsage::Storage | BufferUsage::CopyDst);
+        _scanned[p] = std::make_unique<GPUBuffer>(size, BufferUsage::Storage);
+        _outputs[p] = std::make_unique<GPUBuffer>(
+            size, BufferUsage::Storage | BufferUsage::CopySrc);
+        _params[p] = std::make_unique<GPUBuffer>(
+            4 * sizeof(U32), BufferUsage::Storage | BufferUsage::CopyDst);
+
+        BufferDescriptor rbDesc{.usage = BufferUsage::MapRead |
+                                         BufferUsage::CopyDst,
+                                .size = size};
+        _readbacks[p] = eng->get_device().CreateBuffer(&rbDesc);
+
+        // Inclusive scan of the chunk, followed by the carry propagation:
+        _passes[p] = create_ref_object<WGPUComputePass>();
+        _scans[p] = GPUPrefixSum::create(
+            {.input = _inputs[p].get(),
+             .output = _scanned[p].get(),
+             .count = _desc.chunkSize,
+             .inclusive = true,
+             .maxWorkgroupsPerDimension = _desc.maxWorkgroupsPerDimension,
+             .mode = _desc.mode,
+             .cpass = _passes[p].get(),
+             .maxTotal = _desc.maxChunkTotal});
+
+        _passes[p]->add_simple_compute(
+            {.shaderFile = "tests/prefixsum/streamscan_carry",
+             .entries = {_inputs[p]->as_sto(), _scanned[p]->as_sto(),
+                         _outputs[p]->as_rw_sto(), _carry->as_rw_sto(),
+                         _params[p]->as_sto()},
+             .defs = defs,
+             .dims = {_groupsX, groupsY}});
+    }
+};
+
+GPUStreamingScan::~GPUStreamingScan() = default;
+
+auto GPUStreamingScan::create(const GPUStreamingScanDesc& desc)
+    -> RefPtr<GPUStreamingScan> {
+    return nv::create<GPUStreamingScan>(desc);
+}
+
+void GPUStreamingScan::submit_chunk(U32 parity, const U32* input, U32 count) {
+    auto* eng = WGPUEngine::instance();
+    auto queue = eng->get_queue();
+    U64 size = (U64)count * sizeof(U32);
+
+    // Note: the queue writes are staged and ordered with the submits, so we
+    // can overwrite the buffers of chunk k-2 while chunk k-1 is running. The
+    // tail of a partial chunk keeps stale data, which doesn't change the
+    // inclusive scan of the valid elements.
+    U32 params[4] = {count, _numGroups, _groupsX, parity};
+    queue.WriteBuffer(_params[parity]->get_buffer(), 0, params,
+                      sizeof(params));
+    queue.WriteBuffer(_inputs[parity]->get_buffer(), 0, input, size);
+
+    auto& bld = eng->build_commands();
+    bld.execute_compute_pass(*_passes[parity]).submit(false);
+
+    CommandEncoder encoder = eng->get_device().CreateCommandEncoder();
+    encoder.CopyBufferToBuffer(_outputs[parity]->get_buffer(), 0,
+                               _readbacks[parity], 0, size);
+    CommandBuffer commands = encoder.Finish();
+    queue.Submit(1, &commands);
+
+    _mapped[parity] = false;
+    _readbacks[parity].MapAsync(
+        MapMode::Read, 0, size,
+        [](WGPUBufferMapAsyncStatus status, void* userdata) {
+            if (status != WGPUBufferMapAsyncStatus_Success) {
+                logERROR("GPUStreamingScan: cannot map readback buffer.");
+            }
+            *(bool*)userdata = true;
+        },
+        &_mapped[parity]);
+}
+
+void GPUStreamingScan::finish_chunk(U32 parity, U32* output, U32 count) {
+    auto* eng = WGPUEngine::instance();
+    while (!_mapped[parity]) {
+        eng->get_instance().ProcessEvents();
+    }
+
+    U64 size = (U64)count * sizeof(U32);
+    const void* data = _readbacks[parity].GetConstMappedRange(0, size);
+    NVCHK(data != nullptr, "GPUStreamingScan: invalid mapped range.");
+    memcpy(output, data, size);
+    _readbacks[parity].Unmap();
+}
+
+void GPUStreamingScan::scan(const U32* input, U32* output, U64 count) {
+    NVCHK(input != nullptr && output != nullptr,
+          "GPUStreamingScan: invalid host buffers.");
+    if (count == 0) {
+        return;
+    }
+
+    auto* eng = WGPUEngine::instance();
+    auto startTick = SystemTime::tick();
+
+    // Reset the running sum:
+    U32 zeros[2] = {0, 0};
+    eng->get_queue().WriteBuffer(_carry->get_buffer(), 0, zeros,
+                                 sizeof(zeros));
+
+    U64 chunkSize = _desc.chunkSize;
+    U64 numChunks = (count + chunkSize - 1) / chunkSize;
+    logDEBUG("GPUStreamingScan: scanning {} elements in {} chunks", count,
+             numChunks);
+
+    auto chunk_count = [&](U64 k) -> U32 {
+        return (U32)std::min(chunkSize, count - k * chunkSize);
+    };
+
+    for (U64 k = 0; k < numChunks; ++k) {
+        // Chunk k uses the buffers of chunk k-2, already finished below.
+        submit_chunk(k & 1, input + k * chunkSize, chunk_count(k));
+
+        // Read back the previous chunk while this one is running:
+        if (k > 0) {
+            finish_chunk((k - 1) & 1, output + (k - 1) * chunkSize,
+                         chunk_count(k - 1));
+        }
+    }
+    finish_chunk((numChunks - 1) & 1, output + (numChunks - 1) * chunkSize,
+                 chunk_count(numChunks - 1));
+
+    _lastDuration = SystemTime::delta_s(startTick, SystemTime::tick());
+    _lastBandwidth = 2.0 * (F64)count * sizeof(U32) /
+                     (std::pow(1024, 3) * _lastDuration);
+    logDEBUG("GPUStreamingScan: {:.3f} GB/s host to host", _lastBandwidth);
+}
+
+} // namespace nv
@@ -0,0 +1,84 @@
+#ifndef NV_GPUSTREAMINGSCAN_H_
+#define NV_GPUSTREAMINGSCAN_H_
+
+#include <GPUPrefixSum.h>
+
+namespace nv {
+
+struct GPUStreamingScanDesc {
+    /** Number of elements uploaded and scanned per chunk. */
+    U32 chunkSize{1 << 24};
+
+    /** Compute an inclusive (or exclusive) scan. */
+    bool inclusive{true};
+
+    /** Max number of workgroups per dispatch dimension. */
+    U32 maxWorkgroupsPerDimension{kDefaultMaxWorkgroupsPerDimension};
+
+    /** Scan algorithm used for each chunk. */
+    PrefixSumMode mode{PrefixSumMode::Auto};
+
+    /** Upper bound of the sum of the elements of one chunk, forwarded as
+    GPUPrefixSumDesc::maxTotal (0: unbounded u32 values, so the chunks are
+    scanned in reduce-then-scan mode). */
+    U64 maxChunkTotal{0};
+};
+
+/**
+ * Out-of-core prefix sum of a host array, for inputs larger than the storage
+ * binding size or the device memory. The input is streamed in chunks through
+ * 2 sets of buffers: the upload of chunk k and the readback of chunk k-1
+ * overlap with the scan of chunk k on the GPU, and the running sum is carried
+ * from chunk to chunk on the GPU, so the total may exceed the 30 bits limit of
+ * the single pass tile scan as long as each chunk stays below it (cf.
+ * GPUStreamingScanDesc::maxChunkTotal).
+ */
+class NVGPU_EXPORT GPUStreamingScan : public RefObject {
+  public:
+    static constexpr U32 kWorkgroupSize = 256;
+
+    explicit GPUStreamingScan(const GPUStreamingScanDesc& desc);
+    ~GPUStreamingScan() override;
+
+    static auto create(const GPUStreamingScanDesc& desc)
+        -> RefPtr<GPUStreamingScan>;
+
+    /** Scan count elements from input into output (both on the host). */
+    void scan(const U32* input, U32* output, U64 count);
+
+    /** Get the duration of the last scan (in seconds). */
+    auto get_last_duration() const -> F64 { return _lastDuration; }
+
+    /** Get the host to host throughput of the last scan (in GB/s). */
+    auto get_last_bandwidth() const -> F64 { return _lastBandwidth; }
+
+  protected:
+    GPUStreamingScanDesc _desc;
+    U32 _groupsX{0};
+    U32 _numGroups{0};
+
+    /** Per parity buffers and passes. */
+    std::unique_ptr<GPUBuffer> _inputs[2];
+    std::unique_ptr<GPUBuffer> _scanned[2];
+    std::unique_ptr<GPUBuffer> _outputs[2];
+    std::unique_ptr<GPUBuffer> _params[2];
+    wgpu::Buffer _readbacks[2];
+    RefPtr<WGPUComputePass> _passes[2];
+    RefPtr<GPUPrefixSum> _scans[2];
+    bool _mapped[2]{false, false};
+
+    std::unique_ptr<GPUBuffer> _carry;
+
+    F64 _lastDuration{0.0};
+    F64 _lastBandwidth{0.0};
+
+    /** Upload a chunk and submit its scan and readback. */
+    void submit_chunk(U32 parity, const U32* input, U32 count);
+
+    /** Wait for the readback of a chunk and copy it to the output. */
+    void finish_chunk(U32 parity, U32* output, U32 count);
+};
+
+} // namespace nv
+
+#endif
@@ -0,0 +1,72 @@
+// Reduce-then-scan workgroup prefix sum (one u32 element per thread).
+
+// cf. https://github.com/b0nes164/GPUPrefixSums?tab=readme-ov-file
+// Reduce-then-scan
+var<workgroup> rtsData: array<u32, WG_SIZE>;
+var<workgroup> rtsReduced: array<u32, WG_SIZE >> 3>;
+
+fn prefixsum_reducethenscan_u32(tid: u32, inputVal: u32) -> u32 {
+    rtsData[tid] = inputVal;
+    workgroupBarrier();
+
+    //cant be less than 2
+    var spillFactor: u32 = 3;
+    var spillSize: u32 = u32(WG_SIZE >> spillFactor); // spillSize will be 32 here if WG_SIZE=256
+    
+    //Upsweep until desired threshold
+    if tid < (WG_SIZE >> 1) {
+        rtsData[(tid << 1) + 1] += rtsData[(tid << 1)];
+    }
+    workgroupBarrier();
+
+    var offset: u32 = 1;
+    var j: u32 = 0;
+    for (j = WG_SIZE >> 2; j > spillSize; j >>= 1) {
+        if tid < j {
+            rtsData[(((tid << 1) + 2) << offset) - 1] += rtsData[(((tid << 1) + 1) << offset) - 1];
+        }
+        workgroupBarrier();
+        offset++;
+    }
+    
+    //Pass intermediates into secondary buffer
+    if tid < j {
+        let t: u32 = (((tid << 1) + 2) << offset) - 1;
+        rtsReduced[tid] = rtsData[t] + rtsData[(((tid << 1) + 1) << offset) - 1];
+        rtsData[t] = rtsReduced[tid];
+    }
+    workgroupBarrier();
+    
+    //Reduce intermediates
+    offset = 0;
+    for (var j: u32 = 1; j < spillSize; j <<= 1) {
+        if (tid & j) != 0 && tid < spillSize {
+            rtsReduced[tid] += rtsReduced[((tid >> offset) << offset) - 1];
+        }
+        workgroupBarrier();
+        offset++;
+    }
+    
+    //Pass in intermediates and downsweep
+    offset = spillFactor - 2;
+    let t: u32 = (((tid << 1) + 2) << offset) + u32(1 << (offset + 1)) - 1;
+    // The first block has no preceding intermediate:
+    if t < WG_SIZE && t >= (1u << spillFactor) {
+        // InterlockedAdd(rtsData[t], g_reduceValues[(t >> spillFactor) - 1]);
+        // No need for interlockedadd here in a workgroup (?)
+        rtsData[t] += rtsReduced[(t >> spillFactor) - 1];
+    }
+
+    // Complete the blocks of 2^spillFactor elements, with offset going from
+    // spillFactor - 2 down to 0:
+    for (var s: i32 = i32(offset); s >= 0; s--) {
+        workgroupBarrier();
+        let idx: u32 = (((tid << 1) + 3) << u32(s)) - 1;
+        if idx < WG_SIZE {
+            rtsData[idx] += rtsData[(((tid << 1) + 2) << u32(s)) - 1];
+        }
+    }
+    workgroupBarrier();
+
+    return rtsData[tid];
+}
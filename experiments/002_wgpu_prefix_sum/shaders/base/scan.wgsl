@@ -0,0 +1,73 @@
+// Generic workgroup scan and reduction, configured with the defines:
+// - SCAN_TYPE: element type (u32, i32, f32, vec2u, vec4u, vec2f, ...)
+// - SCAN_OP_ADD, SCAN_OP_MIN, SCAN_OP_MAX or SCAN_OP_OR: associative operator
+// - SCAN_IDENTITY: identity element of the operator for SCAN_TYPE
+// - WG_SIZE: any power of 2 (64, 128, 256 or 512 in practice)
+// cf. GPUScanKernels::make_defs() to generate consistent defines.
+
+alias scan_t = SCAN_TYPE;
+
+fn scan_op(a: scan_t, b: scan_t) -> scan_t {
+#ifdef SCAN_OP_ADD
+    return a + b;
+#endif
+#ifdef SCAN_OP_MIN
+    return min(a, b);
+#endif
+#ifdef SCAN_OP_MAX
+    return max(a, b);
+#endif
+#ifdef SCAN_OP_OR
+    return a | b;
+#endif
+}
+
+fn scan_identity() -> scan_t {
+    return scan_t(SCAN_IDENTITY);
+}
+
+var<workgroup> scanData: array<scan_t, WG_SIZE>;
+
+// Inclusive Sklansky scan: at step j, the threads in the upper half of each
+// block of 2*j slots accumulate the last slot of the lower half, so the reads
+// and writes never overlap within a step.
+fn scan_sklansky(tid: u32, inputVal: scan_t) -> scan_t {
+    scanData[tid] = inputVal;
+    workgroupBarrier();
+
+    for (var j: u32 = 1; j < WG_SIZE; j <<= 1) {
+        if (tid & j) != 0 {
+            scanData[tid] = scan_op(scanData[(tid & ~(j - 1)) - 1], scanData[tid]);
+        }
+        workgroupBarrier();
+    }
+
+    return scanData[tid];
+}
+
+// Exclusive Sklansky scan (the first thread gets the identity):
+fn scan_sklansky_exclusive(tid: u32, inputVal: scan_t) -> scan_t {
+    scan_sklansky(tid, inputVal);
+    let val = select(scan_identity(), scanData[max(tid, 1u) - 1], tid > 0);
+
+    // Other threads are reading our slot:
+    workgroupBarrier();
+    return val;
+}
+
+// Tree reduction, the result is returned to all the threads:
+fn scan_reduce(tid: u32, inputVal: scan_t) -> scan_t {
+    scanData[tid] = inputVal;
+    workgroupBarrier();
+
+    for (var s: u32 = WG_SIZE / 2; s > 0; s >>= 1) {
+        if tid < s {
+            scanData[tid] = scan_op(scanData[tid], scanData[tid + s]);
+        }
+        workgroupBarrier();
+    }
+
+    let total = scanData[0];
+    workgroupBarrier();
+    return total;
+}
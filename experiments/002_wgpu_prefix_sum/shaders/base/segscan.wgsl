@@ -0,0 +1,37 @@
+// Segmented scan on (flag, value) pairs, with one pair per thread.
+
+// A non zero flag marks the head of a segment: the combine operator restarts
+// the accumulation at each head, and is associative, so we can use it in a
+// regular Hillis-Steele scan.
+var<workgroup> segData: array<vec2u, WG_SIZE>;
+
+fn segscan_combine(a: vec2u, b: vec2u) -> vec2u {
+    return vec2u(a.x | b.x, select(a.y + b.y, b.y, b.x != 0));
+}
+
+// Inclusive segmented scan of the pairs in the workgroup:
+fn segscan_hillissteele_u32(tid: u32, inputVal: vec2u) -> vec2u {
+    var x = inputVal;
+
+    for (var i: u32 = 0; i < firstTrailingBit(u32(WG_SIZE)); i++) {
+        let d: u32 = 1u << i;
+        segData[tid] = x;
+        workgroupBarrier();
+        if tid >= d {
+            x = segscan_combine(segData[tid - d], x);
+        }
+        workgroupBarrier();
+    }
+
+    return x;
+}
+
+// Exclusive segmented scan of the pairs in the workgroup: the flag of the
+// result tells if a head was found in the previous threads.
+fn segscan_exclusive_u32(tid: u32, inputVal: vec2u) -> vec2u {
+    let x = segscan_hillissteele_u32(tid, inputVal);
+    segData[tid] = x;
+    workgroupBarrier();
+
+    return select(vec2u(0), segData[max(tid, 1u) - 1], tid > 0);
+}
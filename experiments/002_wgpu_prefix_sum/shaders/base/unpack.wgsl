@@ -0,0 +1,12 @@
+// Packed narrow integer input: ELEM_BITS (8 or 16) bits per element, stored
+// little-endian in u32 words. Expects an inputBuffer of u32 words.
+
+const ELEMS_PER_WORD: u32 = 32u / ELEM_BITS;
+const ELEM_MASK: u32 = (1u << ELEM_BITS) - 1u;
+
+// Read the element at index idx (the neighbouring threads read the same
+// word, so the memory traffic is divided by ELEMS_PER_WORD):
+fn unpack_element(idx: u32) -> u32 {
+    let word: u32 = inputBuffer[idx / ELEMS_PER_WORD];
+    return (word >> ((idx % ELEMS_PER_WORD) * ELEM_BITS)) & ELEM_MASK;
+}
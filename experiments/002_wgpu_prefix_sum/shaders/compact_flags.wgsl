@@ -0,0 +1,27 @@
+// Stream compaction, phase 1: evaluate the predicate on each element.
+// PREDICATE(x) is provided as a function-like define, for instance:
+// "PREDICATE(x)=(x > 2u)"
+
+struct Params {
+    // Number of valid elements in the input buffer:
+    count: u32,
+    // Number of workgroups actually needed:
+    numGroups: u32,
+    // Number of workgroups dispatched along X (for 2D folded dispatch):
+    groupsX: u32,
+}
+
+@group(0) @binding(0) var<storage,read> inputBuffer: array<u32>;
+@group(0) @binding(1) var<storage,read_write> flags: array<u32>;
+@group(0) @binding(2) var<storage,read> params: Params;
+
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(workgroup_id) gid: vec3<u32>, @builtin(local_invocation_id) local_id: vec3<u32>) {
+    let grp: u32 = gid.y * params.groupsX + gid.x;
+    let idx: u32 = grp * WG_SIZE + local_id.x;
+
+    if idx < params.count {
+        let x: u32 = inputBuffer[idx];
+        flags[idx] = select(0u, 1u, PREDICATE(x));
+    }
+}
@@ -0,0 +1,49 @@
+// Stream compaction, phase 3: write the selected elements at their scanned
+// offsets, and fill the count buffer with the number of selected elements,
+// followed by the indirect dispatch and draw arguments:
+// [count, dispatchX, 1, 1, verticesPerElement, count, 0, 0]
+
+struct Params {
+    // Number of valid elements in the input buffer:
+    count: u32,
+    // Number of workgroups actually needed:
+    numGroups: u32,
+    // Number of workgroups dispatched along X (for 2D folded dispatch):
+    groupsX: u32,
+}
+
+@group(0) @binding(0) var<storage,read> inputBuffer: array<u32>;
+@group(0) @binding(1) var<storage,read> flags: array<u32>;
+@group(0) @binding(2) var<storage,read> offsets: array<u32>;
+@group(0) @binding(3) var<storage,read_write> outputBuffer: array<u32>;
+@group(0) @binding(4) var<storage,read_write> counts: array<u32, 8>;
+@group(0) @binding(5) var<storage,read> params: Params;
+
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(workgroup_id) gid: vec3<u32>, @builtin(local_invocation_id) local_id: vec3<u32>) {
+    let grp: u32 = gid.y * params.groupsX + gid.x;
+    let idx: u32 = grp * WG_SIZE + local_id.x;
+
+    if idx >= params.count {
+        return;
+    }
+
+    let offset: u32 = offsets[idx];
+    let flag: u32 = flags[idx];
+    if flag != 0 {
+        outputBuffer[offset] = inputBuffer[idx];
+    }
+
+    // The last element knows the total count from the exclusive scan:
+    if idx == params.count - 1 {
+        let total: u32 = offset + flag;
+        counts[0] = total;
+        counts[1] = (total + INDIRECT_WG_SIZE - 1) / INDIRECT_WG_SIZE;
+        counts[2] = 1;
+        counts[3] = 1;
+        counts[4] = VERTICES_PER_ELEMENT;
+        counts[5] = total;
+        counts[6] = 0;
+        counts[7] = 0;
+    }
+}
@@ -0,0 +1,134 @@
+#include "base/prefixsum"
+
+// cf. https://github.com/b0nes164/GPUPrefixSums?tab=readme-ov-file
+// Chained scan with decoupled look-back: device-wide prefix sum in a single
+// pass, each tile of WG_SIZE*4 elements is read once and written once.
+// Note: the tile status values are packed on 30 bits with a 2 bits flag,
+// so the total sum of the input must stay below 2^30 (checked on the host
+// with GPUPrefixSumDesc::maxTotal).
+
+struct Params {
+    // Number of valid elements in the input buffer:
+    count: u32,
+    // Number of tiles to process:
+    numTiles: u32,
+}
+
+@group(0) @binding(0) var<storage,read> inputBuffer: array<u32>;
+@group(0) @binding(1) var<storage,read_write> outputBuffer: array<u32>;
+@group(0) @binding(2) var<storage,read> params: Params;
+// Slot 0 is the dynamic tile counter, then one status per tile:
+@group(0) @binding(3) var<storage,read_write> tileStatus: array<atomic<u32>>;
+
+const FLAG_NOT_READY: u32 = 0;
+const FLAG_AGGREGATE: u32 = 1;
+const FLAG_INCLUSIVE: u32 = 2;
+const FLAG_MASK: u32 = 3;
+
+var<workgroup> sharedTileId: u32;
+var<workgroup> tileTotals: vec4u;
+var<workgroup> tilePrefix: u32;
+
+#ifdef PACKED_INPUT
+#include "base/unpack"
+
+fn load_input(idx: u32) -> u32 {
+    // Note: select() would still evaluate the out of bounds load.
+    if idx < params.count {
+        return unpack_element(idx);
+    }
+    return 0u;
+}
+#else
+fn load_input(idx: u32) -> u32 {
+    if idx < params.count {
+        return inputBuffer[idx];
+    }
+    return 0u;
+}
+#endif
+
+fn store_output(idx: u32, value: u32) {
+    if idx < params.count {
+        outputBuffer[idx] = value;
+    }
+}
+
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(local_invocation_id) local_id: vec3<u32>) {
+    var tid: u32 = local_id.x;
+
+    // Tiles are assigned in launch order, so that all the predecessors of a
+    // tile are guaranteed to be already running when we look back:
+    if tid == 0 {
+        sharedTileId = atomicAdd(&tileStatus[0], 1u);
+    }
+    let tileId: u32 = workgroupUniformLoad(&sharedTileId);
+
+    // Extra workgroups from a 2D dispatch:
+    if tileId >= params.numTiles {
+        return;
+    }
+
+    // load input:
+    var gOff: u32 = tileId * WG_SIZE * 4;
+    let inVal = vec4u(
+        load_input(gOff + tid),
+        load_input(gOff + tid + WG_SIZE),
+        load_input(gOff + tid + 2 * WG_SIZE),
+        load_input(gOff + tid + 3 * WG_SIZE),
+    );
+
+    var val = prefixsum_sklansky_vec4u(tid, inVal);
+
+    // Each component is scanned separately, so we chain them to get the scan
+    // of the full tile:
+    if tid == WG_SIZE - 1 {
+        tileTotals = val;
+    }
+    workgroupBarrier();
+    let t = tileTotals;
+    val += vec4u(0, t.x, t.x + t.y, t.x + t.y + t.z);
+    let aggregate: u32 = t.x + t.y + t.z + t.w;
+
+    // Publish our aggregate and look back for the exclusive tile prefix:
+    if tid == 0 {
+        var prefix: u32 = 0;
+        if tileId == 0 {
+            atomicStore(&tileStatus[1], (aggregate << 2) | FLAG_INCLUSIVE);
+        } else {
+            atomicStore(&tileStatus[tileId + 1], (aggregate << 2) | FLAG_AGGREGATE);
+
+            // Walk the predecessors until we find an inclusive prefix
+            // (tile 0 always publishes one directly):
+            var slot: u32 = tileId;
+            loop {
+                let status: u32 = atomicLoad(&tileStatus[slot]);
+                let flag: u32 = status & FLAG_MASK;
+                if flag == FLAG_NOT_READY {
+                    continue;
+                }
+
+                prefix += status >> 2;
+                if flag == FLAG_INCLUSIVE {
+                    break;
+                }
+                slot -= 1;
+            }
+
+            atomicStore(&tileStatus[tileId + 1], ((prefix + aggregate) << 2) | FLAG_INCLUSIVE);
+        }
+        tilePrefix = prefix;
+    }
+    let prefix: u32 = workgroupUniformLoad(&tilePrefix);
+
+    val += vec4u(prefix);
+#ifdef EXCLUSIVE
+    val -= inVal;
+#endif
+
+    store_output(gOff + tid, val.x);
+    store_output(gOff + tid + WG_SIZE, val.y);
+    store_output(gOff + tid + 2 * WG_SIZE, val.z);
+    store_output(gOff + tid + 3 * WG_SIZE, val.w);
+}
@@ -0,0 +1,17 @@
+// Reset the tile counter and tile statuses before a decoupled look-back scan.
+
+struct Params {
+    count: u32,
+    numTiles: u32,
+}
+
+@group(0) @binding(0) var<storage,read> params: Params;
+@group(0) @binding(1) var<storage,read_write> tileStatus: array<u32>;
+
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(global_invocation_id) id: vec3<u32>) {
+    // Slot 0 is the tile counter, followed by numTiles statuses:
+    if id.x <= params.numTiles {
+        tileStatus[id.x] = 0;
+    }
+}
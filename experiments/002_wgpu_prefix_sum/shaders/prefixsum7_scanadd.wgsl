@@ -0,0 +1,90 @@
+#include "base/reducethenscan"
+
+// Last phase of the hierarchical reduce-then-scan:
+// Each workgroup scans a tile of WG_SIZE*4 elements (4 consecutive elements
+// per thread) and adds the exclusive prefix of the tile computed by the
+// previous phases. No inter-workgroup communication, so this is safe on
+// adapters without forward progress guarantees.
+
+struct Params {
+    // Number of valid elements in the input buffer:
+    count: u32,
+    // Number of tiles to process:
+    numTiles: u32,
+    // Number of workgroups dispatched along X (for 2D folded dispatch):
+    groupsX: u32,
+}
+
+@group(0) @binding(0) var<storage,read> inputBuffer: array<u32>;
+@group(0) @binding(1) var<storage,read_write> outputBuffer: array<u32>;
+@group(0) @binding(2) var<storage,read> params: Params;
+#ifdef TILE_OFFSETS
+@group(0) @binding(3) var<storage,read> tileOffsets: array<u32>;
+#endif
+
+#ifdef PACKED_INPUT
+#include "base/unpack"
+
+fn load_input(idx: u32) -> u32 {
+    // Note: select() would still evaluate the out of bounds load.
+    if idx < params.count {
+        return unpack_element(idx);
+    }
+    return 0u;
+}
+#else
+fn load_input(idx: u32) -> u32 {
+    if idx < params.count {
+        return inputBuffer[idx];
+    }
+    return 0u;
+}
+#endif
+
+fn store_output(idx: u32, value: u32) {
+    if idx < params.count {
+        outputBuffer[idx] = value;
+    }
+}
+
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(workgroup_id) gid: vec3<u32>, @builtin(local_invocation_id) local_id: vec3<u32>) {
+    // Fold the 2D dispatch back into a linear tile index:
+    let tileId: u32 = gid.y * params.groupsX + gid.x;
+
+    // The last row of a 2D dispatch may contain some extra workgroups:
+    if tileId >= params.numTiles {
+        return;
+    }
+
+    var tid: u32 = local_id.x;
+    var gOff: u32 = tileId * WG_SIZE * 4 + tid * 4;
+
+    // Serial inclusive scan of our 4 elements:
+    let inVal = vec4u(
+        load_input(gOff),
+        load_input(gOff + 1),
+        load_input(gOff + 2),
+        load_input(gOff + 3),
+    );
+    var val = inVal;
+    val.y += val.x;
+    val.z += val.y;
+    val.w += val.z;
+
+    // Scan the thread totals in the workgroup:
+    var offset: u32 = prefixsum_reducethenscan_u32(tid, val.w) - val.w;
+#ifdef TILE_OFFSETS
+    offset += tileOffsets[tileId];
+#endif
+
+    val += vec4u(offset);
+#ifdef EXCLUSIVE
+    val -= inVal;
+#endif
+
+    store_output(gOff, val.x);
+    store_output(gOff + 1, val.y);
+    store_output(gOff + 2, val.z);
+    store_output(gOff + 3, val.w);
+}
@@ -0,0 +1,45 @@
+// LSD radix sort, step 1: per-tile histogram of the current digit.
+// The counts are stored digit-major (digit * numTiles + tileId), so that an
+// exclusive scan of this buffer gives the stable global scatter offsets.
+
+struct Params {
+    // Number of keys to sort:
+    count: u32,
+    // Number of tiles of WG_SIZE * ITEMS_PER_THREAD keys:
+    numTiles: u32,
+    // Number of workgroups dispatched along X (for 2D folded dispatch):
+    groupsX: u32,
+    // Bit offset of the current digit:
+    shift: u32,
+}
+
+@group(0) @binding(0) var<storage,read> keysIn: array<u32>;
+@group(0) @binding(1) var<storage,read_write> tileHist: array<u32>;
+@group(0) @binding(2) var<storage,read> params: Params;
+
+const RADIX: u32 = 16;
+var<workgroup> hist: array<atomic<u32>, RADIX>;
+
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(workgroup_id) gid: vec3<u32>, @builtin(local_invocation_id) local_id: vec3<u32>) {
+    let tileId: u32 = gid.y * params.groupsX + gid.x;
+    if tileId >= params.numTiles {
+        return;
+    }
+
+    var tid: u32 = local_id.x;
+    var idx: u32 = tileId * WG_SIZE * ITEMS_PER_THREAD + tid;
+    for (var i: u32 = 0; i < ITEMS_PER_THREAD; i++) {
+        if idx < params.count {
+            let digit: u32 = (keysIn[idx] >> params.shift) & (RADIX - 1);
+            atomicAdd(&hist[digit], 1u);
+        }
+        idx += WG_SIZE;
+    }
+
+    workgroupBarrier();
+
+    if tid < RADIX {
+        tileHist[tid * params.numTiles + tileId] = atomicLoad(&hist[tid]);
+    }
+}
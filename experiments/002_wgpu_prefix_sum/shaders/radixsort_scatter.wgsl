@@ -0,0 +1,99 @@
+#include "base/prefixsum"
+
+// LSD radix sort, step 3: stable scatter of the keys (and values).
+// The tile is processed in chunks of WG_SIZE keys in order. For each chunk,
+// the rank of a key among the keys with the same digit is computed with
+// a vec4 Sklansky scan of one-hot 16 bit counters (2 digits per u32, so
+// 8 u32 for the 16 digits).
+
+struct Params {
+    // Number of keys to sort:
+    count: u32,
+    // Number of tiles of WG_SIZE * ITEMS_PER_THREAD keys:
+    numTiles: u32,
+    // Number of workgroups dispatched along X (for 2D folded dispatch):
+    groupsX: u32,
+    // Bit offset of the current digit:
+    shift: u32,
+}
+
+@group(0) @binding(0) var<storage,read> keysIn: array<u32>;
+@group(0) @binding(1) var<storage,read_write> keysOut: array<u32>;
+@group(0) @binding(2) var<storage,read> digitOffsets: array<u32>;
+@group(0) @binding(3) var<storage,read> params: Params;
+#ifdef WITH_VALUES
+@group(0) @binding(4) var<storage,read> valuesIn: array<u32>;
+@group(0) @binding(5) var<storage,read_write> valuesOut: array<u32>;
+#endif
+
+const RADIX: u32 = 16;
+var<workgroup> tileOffsets: array<u32, RADIX>;
+var<workgroup> chunkTotals: array<vec4u, 2>;
+
+fn get_packed_count(lo: vec4u, hi: vec4u, digit: u32) -> u32 {
+    let word: u32 = digit >> 1;
+    let w: u32 = select(lo[word & 3], hi[word & 3], word >= 4);
+    return (w >> ((digit & 1) * 16)) & 0xFFFF;
+}
+
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(workgroup_id) gid: vec3<u32>, @builtin(local_invocation_id) local_id: vec3<u32>) {
+    let tileId: u32 = gid.y * params.groupsX + gid.x;
+    if tileId >= params.numTiles {
+        return;
+    }
+
+    var tid: u32 = local_id.x;
+    if tid < RADIX {
+        tileOffsets[tid] = digitOffsets[tid * params.numTiles + tileId];
+    }
+    workgroupBarrier();
+
+    for (var chunk: u32 = 0; chunk < ITEMS_PER_THREAD; chunk++) {
+        let idx: u32 = (tileId * ITEMS_PER_THREAD + chunk) * WG_SIZE + tid;
+        let valid: bool = idx < params.count;
+        var key: u32 = 0;
+        if valid {
+            key = keysIn[idx];
+        }
+        let digit: u32 = (key >> params.shift) & (RADIX - 1);
+
+        var lo = vec4u(0);
+        var hi = vec4u(0);
+        if valid {
+            let word: u32 = digit >> 1;
+            let bit: u32 = 1u << ((digit & 1) * 16);
+            if word < 4 {
+                lo[word] = bit;
+            } else {
+                hi[word - 4] = bit;
+            }
+        }
+
+        let inclLo = prefixsum_sklansky_vec4u(tid, lo);
+        workgroupBarrier();
+        let inclHi = prefixsum_sklansky_vec4u(tid, hi);
+
+        if tid == WG_SIZE - 1 {
+            chunkTotals[0] = inclLo;
+            chunkTotals[1] = inclHi;
+        }
+
+        if valid {
+            // Our own key is included in the scan:
+            let rank: u32 = get_packed_count(inclLo, inclHi, digit) - 1;
+            let dst: u32 = tileOffsets[digit] + rank;
+            keysOut[dst] = key;
+#ifdef WITH_VALUES
+            valuesOut[dst] = valuesIn[idx];
+#endif
+        }
+        workgroupBarrier();
+
+        // Move the offsets past the keys of this chunk:
+        if tid < RADIX {
+            tileOffsets[tid] += get_packed_count(chunkTotals[0], chunkTotals[1], tid);
+        }
+        workgroupBarrier();
+    }
+}
@@ -0,0 +1,44 @@
+// Reduce-by-key, last phase: the last element of each run writes its key and
+// the segmented sum of the run at the run index, and the very last element
+// writes the number of runs.
+
+struct Params {
+    // Number of elements:
+    count: u32,
+    // Number of workgroups actually needed:
+    numGroups: u32,
+    // Number of workgroups dispatched along X (for 2D folded dispatch):
+    groupsX: u32,
+}
+
+@group(0) @binding(0) var<storage,read> keys: array<u32>;
+@group(0) @binding(1) var<storage,read> flags: array<u32>;
+// Inclusive scan of the flags (run index + 1):
+@group(0) @binding(2) var<storage,read> runIds: array<u32>;
+// Inclusive segmented scan of the values:
+@group(0) @binding(3) var<storage,read> runSums: array<u32>;
+@group(0) @binding(4) var<storage,read_write> outputKeys: array<u32>;
+@group(0) @binding(5) var<storage,read_write> outputValues: array<u32>;
+@group(0) @binding(6) var<storage,read_write> numRuns: array<u32, 1>;
+@group(0) @binding(7) var<storage,read> params: Params;
+
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(workgroup_id) gid: vec3<u32>, @builtin(local_invocation_id) local_id: vec3<u32>) {
+    let grp: u32 = gid.y * params.groupsX + gid.x;
+    let idx: u32 = grp * WG_SIZE + local_id.x;
+
+    if idx >= params.count {
+        return;
+    }
+
+    let isLast: bool = idx == params.count - 1;
+    if isLast || flags[min(idx + 1, params.count - 1)] != 0 {
+        let run: u32 = runIds[idx] - 1;
+        outputKeys[run] = keys[idx];
+        outputValues[run] = runSums[idx];
+    }
+
+    if isLast {
+        numRuns[0] = runIds[idx];
+    }
+}
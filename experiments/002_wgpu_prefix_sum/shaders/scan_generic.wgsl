@@ -0,0 +1,44 @@
+#include "base/scan"
+
+// Generic block scan: each workgroup scans WG_SIZE consecutive elements of
+// type SCAN_TYPE with the selected operator.
+
+struct Params {
+    // Number of valid elements in the input buffer:
+    count: u32,
+    // Number of workgroups actually needed:
+    numGroups: u32,
+    // Number of workgroups dispatched along X (for 2D folded dispatch):
+    groupsX: u32,
+}
+
+@group(0) @binding(0) var<storage,read> inputBuffer: array<scan_t>;
+@group(0) @binding(1) var<storage,read_write> outputBuffer: array<scan_t>;
+@group(0) @binding(2) var<storage,read> params: Params;
+
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(workgroup_id) gid: vec3<u32>, @builtin(local_invocation_id) local_id: vec3<u32>) {
+    let grp: u32 = gid.y * params.groupsX + gid.x;
+    if grp >= params.numGroups {
+        return;
+    }
+
+    var tid: u32 = local_id.x;
+    let idx: u32 = grp * WG_SIZE + tid;
+    let valid: bool = idx < params.count;
+
+    var val = scan_identity();
+    if valid {
+        val = inputBuffer[idx];
+    }
+
+#ifdef EXCLUSIVE
+    val = scan_sklansky_exclusive(tid, val);
+#else
+    val = scan_sklansky(tid, val);
+#endif
+
+    if valid {
+        outputBuffer[idx] = val;
+    }
+}
@@ -0,0 +1,42 @@
+// Segmented scan: convert a sorted list of segment start offsets into head
+// flags, with a binary search for each element (no clear pass needed).
+
+struct Params {
+    // Number of elements:
+    count: u32,
+    // Number of workgroups actually needed:
+    numGroups: u32,
+    // Number of workgroups dispatched along X (for 2D folded dispatch):
+    groupsX: u32,
+    // Number of segments:
+    numSegments: u32,
+}
+
+@group(0) @binding(0) var<storage,read> offsets: array<u32>;
+@group(0) @binding(1) var<storage,read_write> flags: array<u32>;
+@group(0) @binding(2) var<storage,read> params: Params;
+
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(workgroup_id) gid: vec3<u32>, @builtin(local_invocation_id) local_id: vec3<u32>) {
+    let grp: u32 = gid.y * params.groupsX + gid.x;
+    let idx: u32 = grp * WG_SIZE + local_id.x;
+
+    if idx >= params.count {
+        return;
+    }
+
+    // lower bound of idx in the offsets:
+    var lo: u32 = 0;
+    var hi: u32 = params.numSegments;
+    while lo < hi {
+        let mid: u32 = (lo + hi) >> 1;
+        if offsets[mid] < idx {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    let isHead: bool = lo < params.numSegments && offsets[lo] == idx;
+    flags[idx] = select(0u, 1u, isHead);
+}
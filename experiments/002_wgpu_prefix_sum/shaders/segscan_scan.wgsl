@@ -0,0 +1,83 @@
+#include "base/segscan"
+
+// Segmented scan, last phase: scan each tile of WG_SIZE*4 elements (4
+// consecutive elements per thread) and carry in the inclusive scan of the
+// previous tile aggregates for the elements before the first head.
+
+struct Params {
+    // Number of valid elements in the input buffer:
+    count: u32,
+    // Number of tiles to process:
+    numTiles: u32,
+    // Number of workgroups dispatched along X (for 2D folded dispatch):
+    groupsX: u32,
+}
+
+@group(0) @binding(0) var<storage,read> inputBuffer: array<u32>;
+@group(0) @binding(1) var<storage,read> flags: array<u32>;
+@group(0) @binding(2) var<storage,read_write> outputBuffer: array<u32>;
+@group(0) @binding(3) var<storage,read> params: Params;
+#ifdef TILE_CARRY
+@group(0) @binding(4) var<storage,read> tileCarry: array<u32>;
+#endif
+
+fn load_pair(idx: u32) -> vec2u {
+    if idx >= params.count {
+        return vec2u(0);
+    }
+    return vec2u(select(0u, 1u, flags[idx] != 0), inputBuffer[idx]);
+}
+
+fn store_output(idx: u32, value: u32) {
+    if idx < params.count {
+        outputBuffer[idx] = value;
+    }
+}
+
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(workgroup_id) gid: vec3<u32>, @builtin(local_invocation_id) local_id: vec3<u32>) {
+    let tileId: u32 = gid.y * params.groupsX + gid.x;
+    if tileId >= params.numTiles {
+        return;
+    }
+
+    var tid: u32 = local_id.x;
+    var gOff: u32 = tileId * WG_SIZE * 4 + tid * 4;
+
+    let p0 = load_pair(gOff);
+    let p1 = load_pair(gOff + 1);
+    let p2 = load_pair(gOff + 2);
+    let p3 = load_pair(gOff + 3);
+
+    var agg = segscan_combine(segscan_combine(p0, p1), segscan_combine(p2, p3));
+    var carry = segscan_exclusive_u32(tid, agg);
+
+#ifdef TILE_CARRY
+    // Entry i of tileCarry is the inclusive scan up to the end of tile i:
+    if tileId > 0 {
+        carry = segscan_combine(vec2u(1, tileCarry[tileId - 1]), carry);
+    }
+#endif
+
+    // Serial scan of our 4 elements:
+    var val = vec4u(0);
+    var run = segscan_combine(carry, p0);
+    val.x = run.y;
+    run = segscan_combine(run, p1);
+    val.y = run.y;
+    run = segscan_combine(run, p2);
+    val.z = run.y;
+    run = segscan_combine(run, p3);
+    val.w = run.y;
+
+#ifdef EXCLUSIVE
+    // The inclusive value at a head is the element itself, so this gives 0
+    // on the heads:
+    val -= vec4u(p0.y, p1.y, p2.y, p3.y);
+#endif
+
+    store_output(gOff, val.x);
+    store_output(gOff + 1, val.y);
+    store_output(gOff + 2, val.z);
+    store_output(gOff + 3, val.w);
+}
@@ -0,0 +1,49 @@
+#include "base/segscan"
+
+// Segmented scan, phase 1: compute the (flag, value) aggregate of each tile
+// of WG_SIZE*4 elements, the flag is set if the tile contains a head.
+
+struct Params {
+    // Number of valid elements in the input buffer:
+    count: u32,
+    // Number of tiles to process:
+    numTiles: u32,
+    // Number of workgroups dispatched along X (for 2D folded dispatch):
+    groupsX: u32,
+}
+
+@group(0) @binding(0) var<storage,read> inputBuffer: array<u32>;
+@group(0) @binding(1) var<storage,read> flags: array<u32>;
+@group(0) @binding(2) var<storage,read_write> tileSums: array<u32>;
+@group(0) @binding(3) var<storage,read_write> tileFlags: array<u32>;
+@group(0) @binding(4) var<storage,read> params: Params;
+
+fn load_pair(idx: u32) -> vec2u {
+    if idx >= params.count {
+        return vec2u(0);
+    }
+    return vec2u(select(0u, 1u, flags[idx] != 0), inputBuffer[idx]);
+}
+
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(workgroup_id) gid: vec3<u32>, @builtin(local_invocation_id) local_id: vec3<u32>) {
+    let tileId: u32 = gid.y * params.groupsX + gid.x;
+    if tileId >= params.numTiles {
+        return;
+    }
+
+    var tid: u32 = local_id.x;
+    var gOff: u32 = tileId * WG_SIZE * 4 + tid * 4;
+
+    // Serial reduction of our 4 elements:
+    var agg = load_pair(gOff);
+    agg = segscan_combine(agg, load_pair(gOff + 1));
+    agg = segscan_combine(agg, load_pair(gOff + 2));
+    agg = segscan_combine(agg, load_pair(gOff + 3));
+
+    let total = segscan_hillissteele_u32(tid, agg);
+    if tid == WG_SIZE - 1 {
+        tileSums[tileId] = total.y;
+        tileFlags[tileId] = total.x;
+    }
+}
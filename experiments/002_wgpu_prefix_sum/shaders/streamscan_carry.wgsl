@@ -0,0 +1,46 @@
+// Streaming scan: add the running sum of the previous chunks to the scanned
+// chunk, and compute the running sum for the next chunk.
+// The carry is ping-ponged between 2 slots (read from slot parity, written
+// to slot 1 - parity), so that all the threads can read the current value
+// while the next one is written.
+
+struct Params {
+    // Number of valid elements in this chunk:
+    count: u32,
+    // Number of workgroups actually needed:
+    numGroups: u32,
+    // Number of workgroups dispatched along X (for 2D folded dispatch):
+    groupsX: u32,
+    // Carry slot to read:
+    parity: u32,
+}
+
+@group(0) @binding(0) var<storage,read> inputBuffer: array<u32>;
+// Inclusive scan of the chunk:
+@group(0) @binding(1) var<storage,read> scanBuffer: array<u32>;
+@group(0) @binding(2) var<storage,read_write> outputBuffer: array<u32>;
+@group(0) @binding(3) var<storage,read_write> carry: array<u32, 2>;
+@group(0) @binding(4) var<storage,read> params: Params;
+
+@compute @workgroup_size(WG_SIZE)
+fn main(@builtin(workgroup_id) gid: vec3<u32>, @builtin(local_invocation_id) local_id: vec3<u32>) {
+    let grp: u32 = gid.y * params.groupsX + gid.x;
+    let idx: u32 = grp * WG_SIZE + local_id.x;
+
+    if idx >= params.count {
+        return;
+    }
+
+    let prev: u32 = carry[params.parity];
+    let incl: u32 = scanBuffer[idx] + prev;
+
+#ifdef EXCLUSIVE
+    outputBuffer[idx] = incl - inputBuffer[idx];
+#else
+    outputBuffer[idx] = incl;
+#endif
+
+    if idx == params.count - 1 {
+        carry[1 - params.parity] = incl;
+    }
+}
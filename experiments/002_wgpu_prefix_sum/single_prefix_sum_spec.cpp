@@ -1,6 +1,17 @@
 #include <nv_tests_framework.h>
 
+#include <BenchmarkRunner.h>
+#include <GPUPrefixSum.h>
+#include <GPURadixSort.h>
+#include <GPURandomFill.h>
+#include <GPUReduceByKey.h>
+#include <GPUScanKernels.h>
+#include <GPUSegmentedScan.h>
+#include <GPUStreamCompactor.h>
+#include <GPUStreamingScan.h>
+#include <PhiloxRNG.h>
 #include <WGPUEngine.h>
+#include <limits>
 #include <numeric>
 
 using namespace nv;
@@ -115,8 +126,697 @@ static void run_prefix_sum(const char* code, U32 reducFactor,
     // For ref. max RTX 3090 bandwidth is 936.2 GB/s.
 }
 
+static void run_global_prefix_sum(U32 num, bool inclusive,
+                                  PrefixSumMode mode = PrefixSumMode::Auto,
+                                  InputFormat format = InputFormat::U32) {
+    logNOTE("Running global prefix sum on {} elements", num);
+    auto* eng = WGPUEngine::instance();
+
+    RandGen rnd;
+    auto in_data = rnd.uniform_int_vector<U32>(num, 0, 4);
+
+    // Pack the elements in u32 words if needed:
+    U32 elemsPerWord = GPUReducer::get_elements_per_word(format);
+    U32 bits = 32 / elemsPerWord;
+    U32 numWords = (num + elemsPerWord - 1) / elemsPerWord;
+    Vector<U32> packed(numWords, 0);
+    for (U32 i = 0; i < num; ++i) {
+        packed[i / elemsPerWord] |= in_data[i] << ((i % elemsPerWord) * bits);
+    }
+
+    GPUBuffer input(numWords * sizeof(U32), BufferUsage::Storage,
+                    packed.data());
+    GPUBuffer output(num * sizeof(U32),
+                     BufferUsage::Storage | BufferUsage::CopySrc);
+
+    // No reset between tiles here:
+    Vector<U32> expected(num);
+    if (inclusive) {
+        std::inclusive_scan(in_data.begin(), in_data.end(), expected.begin());
+    } else {
+        std::exclusive_scan(in_data.begin(), in_data.end(), expected.begin(),
+                            0U);
+    }
+
+    auto scan = GPUPrefixSum::create({.input = &input,
+                                      .output = &output,
+                                      .count = num,
+                                      .inclusive = inclusive,
+                                      .mode = mode,
+                                      .inputFormat = format,
+                                      .maxTotal = (U64)num * 4});
+    logNOTE("Using scan mode {}", (I32)scan->get_mode());
+
+    auto& bld = eng->build_commands();
+
+    // Dry-run:
+    bld.execute_compute_pass(scan->get_compute_pass()).submit();
+
+    U32 niters = 200;
+    bld.reset_all();
+    bld.write_timestamp(0);
+    for (I32 i = 0; i < niters; ++i) {
+        bld.execute_compute_pass(scan->get_compute_pass());
+    }
+    bld.write_timestamp(1);
+    bld.submit(false);
+
+    const U32* data2 = (U32*)output.copy_to_staged().read_sync();
+    BOOST_REQUIRE(data2 != nullptr);
+
+    for (U32 i = 0; i < num; ++i) {
+        BOOST_REQUIRE_EQUAL(data2[i], expected[i]);
+    }
+
+    F64 elapsed = eng->get_timestamp_delta_ns(0, 1);
+    F64 bw = niters * num * sizeof(U32) / (std::pow(1024, 3) * elapsed * 1e-9);
+    logNOTE("Compute shader took {} ns, bandwidth: {:.3f} GB/s", elapsed, bw);
+
+    eng->wait_idle();
+}
+
+static void run_stream_compaction(U32 num, const char* predicate,
+                                  const std::function<bool(U32)>& pred,
+                                  bool withFlags = false) {
+    logNOTE("Running stream compaction on {} elements", num);
+    auto* eng = WGPUEngine::instance();
+
+    RandGen rnd;
+    auto in_data = rnd.uniform_int_vector<U32>(num, 0, 4);
+
+    Vector<U32> expected;
+    std::copy_if(in_data.begin(), in_data.end(), std::back_inserter(expected),
+                 pred);
+
+    GPUBuffer input(num * sizeof(U32), BufferUsage::Storage, in_data.data());
+    GPUBuffer output(num * sizeof(U32),
+                     BufferUsage::Storage | BufferUsage::CopySrc);
+
+    // Provided flags may use any non zero value to keep an element:
+    Vector<U32> flag_data(num, 0);
+    for (U32 i = 0; i < num; ++i) {
+        if (pred(in_data[i])) {
+            flag_data[i] = i % 3 == 0 ? 1 : i % 3 == 1 ? 2 : 0xFFFFFFFF;
+        }
+    }
+    GPUBuffer flags(num * sizeof(U32), BufferUsage::Storage, flag_data.data());
+
+    auto compactor =
+        GPUStreamCompactor::create({.input = &input,
+                                    .count = num,
+                                    .output = &output,
+                                    .flags = withFlags ? &flags : nullptr,
+                                    .predicate = predicate});
+
+    auto& bld = eng->build_commands();
+    bld.execute_compute_pass(compactor->get_compute_pass()).submit();
+
+    const U32* counts =
+        (U32*)compactor->get_count_buffer().copy_to_staged().read_sync();
+    BOOST_REQUIRE(counts != nullptr);
+    BOOST_REQUIRE_EQUAL(counts[0], (U32)expected.size());
+    BOOST_CHECK_EQUAL(counts[1], ((U32)expected.size() + 63) / 64);
+    BOOST_CHECK_EQUAL(counts[5], (U32)expected.size());
+
+    const U32* data2 = (U32*)output.copy_to_staged().read_sync();
+    BOOST_REQUIRE(data2 != nullptr);
+    for (U32 i = 0; i < expected.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(data2[i], expected[i]);
+    }
+
+    eng->wait_idle();
+}
+
+static void run_radix_sort(U32 num, bool withValues) {
+    logNOTE("Running radix sort on {} keys (values: {})", num, withValues);
+    auto* eng = WGPUEngine::instance();
+
+    // The keys are generated on the GPU (no upload), and the same sequence
+    // on the CPU for the expected result:
+    PhiloxRNG rng(num);
+    auto keys = rng.uniform_int_vector(num, 0, 0xFFFFFFFF);
+    Vector<U32> values(num);
+    std::iota(values.begin(), values.end(), 0U);
+
+    // Stable sort of the indices gives the expected keys and values:
+    Vector<U32> expected(values);
+    std::stable_sort(expected.begin(), expected.end(),
+                     [&keys](U32 a, U32 b) { return keys[a] < keys[b]; });
+
+    GPUBuffer keysBuf(num * sizeof(U32),
+                      BufferUsage::Storage | BufferUsage::CopySrc);
+    GPURandomFill::create({.output = &keysBuf, .count = num, .seed = num})
+        ->execute();
+    GPUBuffer valuesBuf(num * sizeof(U32),
+                        BufferUsage::Storage | BufferUsage::CopySrc,
+                        values.data());
+
+    auto sorter = GPURadixSort::create(
+        {.keys = &keysBuf,
+         .values = withValues ? &valuesBuf : nullptr,
+         .count = num});
+
+    auto& bld = eng->build_commands();
+
+    // Dry-run:
+    bld.execute_compute_pass(sorter->get_compute_pass()).submit();
+
+    const U32* data2 = (U32*)keysBuf.copy_to_staged().read_sync();
+    BOOST_REQUIRE(data2 != nullptr);
+    for (U32 i = 0; i < num; ++i) {
+        BOOST_REQUIRE_EQUAL(data2[i], keys[expected[i]]);
+    }
+
+    if (withValues) {
+        const U32* data3 = (U32*)valuesBuf.copy_to_staged().read_sync();
+        BOOST_REQUIRE(data3 != nullptr);
+        for (U32 i = 0; i < num; ++i) {
+            BOOST_REQUIRE_EQUAL(data3[i], expected[i]);
+        }
+    }
+
+    // The keys are sorted now, and the scatter coherence and histogram
+    // contention depend on the key distribution, so each timed sort runs on
+    // fresh random keys (the fill itself is not timed):
+    U32 niters = 20;
+    F64 elapsed = 0.0;
+    for (U32 i = 0; i < niters; ++i) {
+        auto fill = GPURandomFill::create(
+            {.output = &keysBuf, .count = num, .seed = num, .stream = i + 1});
+        bld.reset_all();
+        bld.execute_compute_pass(fill->get_compute_pass());
+        bld.write_timestamp(0);
+        bld.execute_compute_pass(sorter->get_compute_pass());
+        bld.write_timestamp(1);
+        bld.submit(false);
+        eng->wait_idle();
+        elapsed += eng->get_timestamp_delta_ns(0, 1);
+    }
+
+    F64 rate = niters * (F64)num * 1e3 / elapsed;
+    logNOTE("Radix sort took {} ns, rate: {:.3f} Mkeys/s", elapsed / niters,
+            rate);
+
+    eng->wait_idle();
+}
+
+static void run_segmented_scan(U32 num, U32 maxSegmentSize, bool inclusive,
+                               bool useOffsets) {
+    logNOTE("Running segmented scan on {} elements (offsets: {})", num,
+            useOffsets);
+    auto* eng = WGPUEngine::instance();
+
+    RandGen rnd;
+    auto in_data = rnd.uniform_int_vector<U32>(num, 0, 4);
+
+    // Random segment lengths in [1, maxSegmentSize]:
+    auto lengths = rnd.uniform_int_vector<U32>(num, 1, maxSegmentSize);
+    Vector<U32> flags(num, 0);
+    Vector<U32> offsets;
+    for (U32 i = 0, s = 0; i < num; i += lengths[s++]) {
+        flags[i] = 1;
+        offsets.push_back(i);
+    }
+
+    Vector<U32> expected(num);
+    U32 count = 0;
+    for (U32 i = 0; i < num; ++i) {
+        if (flags[i] != 0) {
+            count = 0;
+        }
+        expected[i] = inclusive ? count + in_data[i] : count;
+        count += in_data[i];
+    }
+
+    GPUBuffer input(num * sizeof(U32), BufferUsage::Storage, in_data.data());
+    GPUBuffer flagsBuf(num * sizeof(U32), BufferUsage::Storage, flags.data());
+    GPUBuffer offsetsBuf(offsets.size() * sizeof(U32), BufferUsage::Storage,
+                         offsets.data());
+    GPUBuffer output(num * sizeof(U32),
+                     BufferUsage::Storage | BufferUsage::CopySrc);
+
+    auto scan = GPUSegmentedScan::create(
+        {.input = &input,
+         .output = &output,
+         .count = num,
+         .flags = useOffsets ? nullptr : &flagsBuf,
+         .offsets = useOffsets ? &offsetsBuf : nullptr,
+         .numSegments = (U32)offsets.size(),
+         .inclusive = inclusive});
+
+    auto& bld = eng->build_commands();
+
+    // Dry-run:
+    bld.execute_compute_pass(scan->get_compute_pass()).submit();
+
+    U32 niters = 200;
+    bld.reset_all();
+    bld.write_timestamp(0);
+    for (I32 i = 0; i < niters; ++i) {
+        bld.execute_compute_pass(scan->get_compute_pass());
+    }
+    bld.write_timestamp(1);
+    bld.submit(false);
+
+    const U32* data2 = (U32*)output.copy_to_staged().read_sync();
+    BOOST_REQUIRE(data2 != nullptr);
+
+    for (U32 i = 0; i < num; ++i) {
+        BOOST_REQUIRE_EQUAL(data2[i], expected[i]);
+    }
+
+    F64 elapsed = eng->get_timestamp_delta_ns(0, 1);
+    F64 bw = niters * num * sizeof(U32) / (std::pow(1024, 3) * elapsed * 1e-9);
+    logNOTE("Segmented scan of {} segments took {} ns, bandwidth: {:.3f} GB/s",
+            offsets.size(), elapsed, bw);
+
+    eng->wait_idle();
+}
+
+static void run_reduce_by_key(U32 num, U32 maxRunLength) {
+    logNOTE("Running reduce-by-key on {} elements", num);
+    auto* eng = WGPUEngine::instance();
+
+    RandGen rnd;
+    auto values = rnd.uniform_int_vector<U32>(num, 0, 4);
+    auto lengths = rnd.uniform_int_vector<U32>(num, 1, maxRunLength);
+
+    // Consecutive runs with different keys:
+    Vector<U32> keys(num);
+    Vector<U32> expectedKeys;
+    Vector<U32> expectedValues;
+    for (U32 i = 0, r = 0; i < num; ++r) {
+        U32 end = std::min(i + lengths[r], num);
+        U32 sum = 0;
+        for (; i < end; ++i) {
+            keys[i] = r * 3 + 1;
+            sum += values[i];
+        }
+        expectedKeys.push_back(r * 3 + 1);
+        expectedValues.push_back(sum);
+    }
+
+    GPUBuffer keysBuf(num * sizeof(U32), BufferUsage::Storage, keys.data());
+    GPUBuffer valuesBuf(num * sizeof(U32), BufferUsage::Storage,
+                        values.data());
+    GPUBuffer outKeys(num * sizeof(U32),
+                      BufferUsage::Storage | BufferUsage::CopySrc);
+    GPUBuffer outValues(num * sizeof(U32),
+                        BufferUsage::Storage | BufferUsage::CopySrc);
+
+    auto rbk = GPUReduceByKey::create({.keys = &keysBuf,
+                                       .values = &valuesBuf,
+                                       .count = num,
+                                       .outputKeys = &outKeys,
+                                       .outputValues = &outValues});
+
+    auto& bld = eng->build_commands();
+    bld.execute_compute_pass(rbk->get_compute_pass()).submit();
+
+    const U32* count = (U32*)rbk->get_count_buffer().copy_to_staged().read_sync();
+    BOOST_REQUIRE(count != nullptr);
+    BOOST_REQUIRE_EQUAL(count[0], (U32)expectedKeys.size());
+
+    const U32* data2 = (U32*)outKeys.copy_to_staged().read_sync();
+    BOOST_REQUIRE(data2 != nullptr);
+    for (U32 i = 0; i < expectedKeys.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(data2[i], expectedKeys[i]);
+    }
+
+    const U32* data3 = (U32*)outValues.copy_to_staged().read_sync();
+    BOOST_REQUIRE(data3 != nullptr);
+    for (U32 i = 0; i < expectedValues.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(data3[i], expectedValues[i]);
+    }
+
+    eng->wait_idle();
+}
+
+template <typename T>
+static auto apply_scan_op(ScanOperator op, T a, T b) -> T {
+    switch (op) {
+    case ScanOperator::Add:
+        return a + b;
+    case ScanOperator::Min:
+        return std::min(a, b);
+    case ScanOperator::Max:
+        return std::max(a, b);
+    case ScanOperator::Or:
+        if constexpr (std::is_integral_v<T>) {
+            return a | b;
+        }
+    }
+    return a;
+}
+
+template <typename T>
+static void run_generic_scan(const ScanKernelDesc& desc, bool exclusive) {
+    logNOTE("Running generic scan (type={}, op={}, WG_SIZE={})",
+            GPUScanKernels::get_type_name(desc.type), (I32)desc.op,
+            desc.workgroupSize);
+    auto* eng = WGPUEngine::instance();
+
+    // Number of scalar lanes per element (each lane is scanned separately):
+    U32 lanes = GPUScanKernels::get_element_size(desc.type) / sizeof(U32);
+    U32 num = 1000003;
+    U32 wgSize = desc.workgroupSize;
+
+    // Small values, so that float sums stay exact:
+    RandGen rnd;
+    auto rnd_data = rnd.uniform_int_vector<U32>(num * lanes, 0, 8);
+    Vector<T> in_data(num * lanes);
+    for (U32 i = 0; i < num * lanes; ++i) {
+        in_data[i] = (T)rnd_data[i] - (std::is_signed_v<T> ? (T)4 : (T)0);
+    }
+
+    // Identity of the operator:
+    T identity = 0;
+    if (desc.op == ScanOperator::Min) {
+        identity = std::numeric_limits<T>::max();
+    } else if (desc.op == ScanOperator::Max) {
+        identity = std::numeric_limits<T>::lowest();
+    }
+
+    Vector<T> expected(num * lanes);
+    for (U32 l = 0; l < lanes; ++l) {
+        T acc = identity;
+        for (U32 i = 0; i < num; ++i) {
+            if (i % wgSize == 0) {
+                acc = identity;
+            }
+            T val = in_data[i * lanes + l];
+            T next = apply_scan_op(desc.op, acc, val);
+            expected[i * lanes + l] = exclusive ? acc : next;
+            acc = next;
+        }
+    }
+
+    U64 size = (U64)num * lanes * sizeof(T);
+    GPUBuffer input(size, BufferUsage::Storage, in_data.data());
+    GPUBuffer output(size, BufferUsage::Storage | BufferUsage::CopySrc);
+
+    U32 numGroups = (num + wgSize - 1) / wgSize;
+    U32 params[3] = {num, numGroups, numGroups};
+    GPUBuffer paramsBuf(sizeof(params), BufferUsage::Storage, params);
+
+    auto defs = GPUScanKernels::make_defs(desc);
+    if (exclusive) {
+        defs.emplace_back("EXCLUSIVE");
+    }
+
+    auto cpass = create_ref_object<WGPUComputePass>();
+    cpass->add_simple_compute(
+        {.shaderFile = "tests/prefixsum/scan_generic",
+         .entries = {input.as_sto(), output.as_rw_sto(), paramsBuf.as_sto()},
+         .defs = defs,
+         .dims = {numGroups}});
+
+    auto& bld = eng->build_commands();
+
+    // Dry-run:
+    bld.execute_compute_pass(*cpass).submit();
+
+    U32 niters = 100;
+    bld.reset_all();
+    bld.write_timestamp(0);
+    for (I32 i = 0; i < niters; ++i) {
+        bld.execute_compute_pass(*cpass);
+    }
+    bld.write_timestamp(1);
+    bld.submit(false);
+
+    const T* data2 = (T*)output.copy_to_staged().read_sync();
+    BOOST_REQUIRE(data2 != nullptr);
+    for (U32 i = 0; i < num * lanes; ++i) {
+        BOOST_REQUIRE_EQUAL(data2[i], expected[i]);
+    }
+
+    F64 elapsed = eng->get_timestamp_delta_ns(0, 1);
+    F64 bw = niters * (F64)size / (std::pow(1024, 3) * elapsed * 1e-9);
+    logNOTE("Generic scan took {} ns, bandwidth: {:.3f} GB/s", elapsed, bw);
+
+    eng->wait_idle();
+}
+
+static void run_streaming_scan(U64 num, U32 chunkSize, bool inclusive,
+                               PrefixSumMode mode = PrefixSumMode::Auto) {
+    logNOTE("Running streaming scan on {} elements with chunks of {}", num,
+            chunkSize);
+
+    RandGen rnd;
+    auto in_data = rnd.uniform_int_vector<U32>(num, 0, 4);
+
+    Vector<U32> expected(num);
+    if (inclusive) {
+        std::inclusive_scan(in_data.begin(), in_data.end(), expected.begin());
+    } else {
+        std::exclusive_scan(in_data.begin(), in_data.end(), expected.begin(),
+                            0U);
+    }
+
+    // The chunk totals fit in the single pass tile statuses:
+    auto scan =
+        GPUStreamingScan::create({.chunkSize = chunkSize,
+                                  .inclusive = inclusive,
+                                  .mode = mode,
+                                  .maxChunkTotal = (U64)chunkSize * 4});
+
+    Vector<U32> output(num);
+    scan->scan(in_data.data(), output.data(), num);
+
+    for (U64 i = 0; i < num; ++i) {
+        BOOST_REQUIRE_EQUAL(output[i], expected[i]);
+    }
+
+    logNOTE("Streaming scan took {:.3f} ms, throughput: {:.3f} GB/s",
+            scan->get_last_duration() * 1000.0, scan->get_last_bandwidth());
+}
+
 BOOST_AUTO_TEST_SUITE(single_prefix_sum)
 
+BOOST_AUTO_TEST_CASE(test_prefixsum6_global) {
+    run_global_prefix_sum(4194304, true);
+    run_global_prefix_sum(4194304, false);
+    run_global_prefix_sum(1000003, true);
+    run_global_prefix_sum(1, false);
+
+    // Unbounded u32 totals don't fit in the single pass tile statuses:
+    U32 num = 1 << 20;
+    GPUBuffer input(num * sizeof(U32), BufferUsage::Storage);
+    GPUBuffer output(num * sizeof(U32), BufferUsage::Storage);
+    auto scan =
+        GPUPrefixSum::create({.input = &input, .output = &output, .count = num});
+    BOOST_CHECK(scan->get_mode() == PrefixSumMode::ReduceThenScan);
+    BOOST_CHECK_EQUAL(GPUPrefixSum::get_max_total(
+                          {.count = num, .inputFormat = InputFormat::PackedU8}),
+                      (U64)num * 255);
+}
+
+BOOST_AUTO_TEST_CASE(test_prefixsum_packed) {
+    for (auto mode :
+         {PrefixSumMode::SinglePass, PrefixSumMode::ReduceThenScan}) {
+        run_global_prefix_sum(4194304, true, mode, InputFormat::PackedU8);
+        run_global_prefix_sum(4194304, false, mode, InputFormat::PackedU16);
+        run_global_prefix_sum(1000003, true, mode, InputFormat::PackedU8);
+        run_global_prefix_sum(1000003, false, mode, InputFormat::PackedU16);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_stream_compaction) {
+    run_stream_compaction(4194304, "(x > 1u)", [](U32 x) { return x > 1; });
+    run_stream_compaction(1000003, "(x == 0u)", [](U32 x) { return x == 0; });
+
+    // Provided non unit flags:
+    run_stream_compaction(
+        1000003, "", [](U32 x) { return x > 1; }, true);
+}
+
+BOOST_AUTO_TEST_CASE(test_prefixsum7_reducethenscan) {
+    auto mode = PrefixSumMode::ReduceThenScan;
+    run_global_prefix_sum(4194304, true, mode);
+    run_global_prefix_sum(4194304, false, mode);
+    run_global_prefix_sum(1000003, true, mode);
+    run_global_prefix_sum(1024, false, mode);
+}
+
+BOOST_AUTO_TEST_CASE(test_radix_sort) {
+    run_radix_sort(1000003, false);
+    run_radix_sort(1000003, true);
+    run_radix_sort(37, true);
+}
+
+BOOST_AUTO_TEST_CASE(test_segmented_scan) {
+    run_segmented_scan(4194304, 64, true, false);
+    run_segmented_scan(4194304, 64, false, false);
+    run_segmented_scan(4194304, 100000, true, true);
+    run_segmented_scan(1000003, 3, false, true);
+}
+
+BOOST_AUTO_TEST_CASE(test_reduce_by_key) {
+    run_reduce_by_key(4194304, 32);
+    run_reduce_by_key(1000003, 5000);
+    run_reduce_by_key(1, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_generic_scan) {
+    // Workgroup size sweep on the u32 sum (512 is above the default
+    // limits):
+    for (U32 wgSize : GPUScanKernels::kWorkgroupSizes) {
+        if (!GPUScanKernels::is_supported({.workgroupSize = wgSize})) {
+            logNOTE("Skipping unsupported WG_SIZE={}", wgSize);
+            continue;
+        }
+        run_generic_scan<U32>({.workgroupSize = wgSize}, false);
+        run_generic_scan<U32>({.workgroupSize = wgSize}, true);
+    }
+
+    // Per device selection of the workgroup size:
+    U32 bestSize = GPUScanKernels::select_workgroup_size(ScanElementType::F32,
+                                                         ScanOperator::Add);
+    BOOST_CHECK(GPUScanKernels::is_supported({.type = ScanElementType::F32,
+                                              .workgroupSize = bestSize}));
+    run_generic_scan<F32>({.type = ScanElementType::F32,
+                           .op = ScanOperator::Add,
+                           .workgroupSize = bestSize},
+                          true);
+
+    // Types and operators:
+    run_generic_scan<I32>({.type = ScanElementType::I32,
+                           .op = ScanOperator::Min,
+                           .workgroupSize = 128},
+                          false);
+    run_generic_scan<I32>({.type = ScanElementType::Vec4I,
+                           .op = ScanOperator::Max,
+                           .workgroupSize = 64},
+                          true);
+    run_generic_scan<F32>(
+        {.type = ScanElementType::F32, .op = ScanOperator::Add}, false);
+    ScanKernelDesc vec2Max{.type = ScanElementType::Vec2F,
+                           .op = ScanOperator::Max,
+                           .workgroupSize = 512};
+    if (GPUScanKernels::is_supported(vec2Max)) {
+        run_generic_scan<F32>(vec2Max, false);
+    }
+    run_generic_scan<U32>(
+        {.type = ScanElementType::Vec4U, .op = ScanOperator::Add}, false);
+    run_generic_scan<U32>({.type = ScanElementType::Vec2U,
+                           .op = ScanOperator::Or,
+                           .workgroupSize = 64},
+                          true);
+}
+
+BOOST_AUTO_TEST_CASE(test_streaming_scan) {
+    // Multiple chunks with a partial tail chunk:
+    run_streaming_scan(4194304 * 4 + 12345, 4194304, true);
+    run_streaming_scan(4194304 * 4 + 12345, 4194304, false);
+    run_streaming_scan(1000, 4194304, true);
+
+    // Larger input in a few chunks of the default size (keeping the host
+    // input, output and reference under 1 GiB):
+    run_streaming_scan(67108864, 1 << 24, true);
+
+    // Chunks scanned with the single pass look-back:
+    if (GPUPrefixSum::is_single_pass_safe()) {
+        run_streaming_scan(67108864, 1 << 24, true,
+                           PrefixSumMode::SinglePass);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_radix_sort_benchmark) {
+    // 2^20 to 2^26 keys, within the storage binding limit (2^26 keys need
+    // 256 MiB buffers, above the default 128 MiB):
+    U64 maxBinding =
+        GPUReducer::get_device_limits().maxStorageBufferBindingSize;
+    for (U32 num = 1048576; num <= 67108864; num *= 4) {
+        if ((U64)num * sizeof(U32) > maxBinding) {
+            logNOTE("Skipping radix sort on {} keys (binding size limit)", num);
+            continue;
+        }
+        run_radix_sort(num, false);
+        run_radix_sort(num, true);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_prefixsum_variants_benchmark) {
+    // All the block scan variants, instead of toggling them with RUN_ALL:
+    auto runner = BenchmarkRunner::create(
+        {.baselineFile = "prefixsum_benchmark.baseline"});
+
+    StringVector wgDefs = {"WG_SIZE=256"};
+    Vector<U32> sizes = {4194304, 16777216};
+    // With one element per thread, 2^24 elements would need 65536
+    // workgroups, above the default limit of 65535 per dimension:
+    Vector<U32> sizesFactor1 = {4194304, 8388608};
+    runner->add_matrix({.kernels = {"tests/prefixsum/prefixsum1_hillissteele",
+                                    "tests/prefixsum/prefixsum1b_hillissteele",
+                                    "tests/prefixsum/prefixsum2_custom",
+                                    "tests/prefixsum/prefixsum2b_custom",
+                                    "tests/prefixsum/prefixsum2c_custom",
+                                    "tests/prefixsum/prefixsum3_sklansky",
+                                    "tests/prefixsum/prefixsum4_brentkung",
+                                    "tests/prefixsum/prefixsum5_reducethenscan"},
+                        .defs = {wgDefs},
+                        .sizes = sizesFactor1});
+    runner->add_matrix({.kernels = {"tests/prefixsum/prefixsum0_nvidia"},
+                        .defs = {{"WG_SIZE=256", "GRID_SIZE=512",
+                                  "SDATA_SIZE=513",
+                                  "CONFLICT_FREE_OFFSET(ai)=((ai >> 16) + "
+                                  "(ai >> 8))",
+                                  "CONFLICT_FREE_OFFSET(bi)=((bi >> 16) + "
+                                  "(bi >> 8))"}},
+                        .sizes = sizes,
+                        .reductionFactors = {2}});
+    runner->add_matrix({.kernels = {"tests/prefixsum/prefixsum1d_hillissteele"},
+                        .defs = {wgDefs},
+                        .sizes = sizes,
+                        .reductionFactors = {2}});
+    runner->add_matrix({.kernels = {"tests/prefixsum/prefixsum1c_hillissteele",
+                                    "tests/prefixsum/prefixsum3b_sklansky",
+                                    "tests/prefixsum/prefixsum3c_sklansky"},
+                        .defs = {wgDefs},
+                        .sizes = sizes,
+                        .reductionFactors = {4}});
+    runner->add_matrix({.kernels = {"tests/prefixsum/prefixsum1e_hillissteele"},
+                        .defs = {wgDefs},
+                        .sizes = sizes,
+                        .reductionFactors = {8}});
+
+    runner->run([](const BenchmarkCase& bcase) {
+        BenchmarkPass pass;
+        U32 num = bcase.size;
+
+        auto* input = pass.buffers
+                          .emplace_back(std::make_unique<GPUBuffer>(
+                              num * sizeof(U32), BufferUsage::Storage))
+                          .get();
+        auto* output = pass.buffers
+                           .emplace_back(std::make_unique<GPUBuffer>(
+                               num * sizeof(U32), BufferUsage::Storage))
+                           .get();
+        GPURandomFill::create({.output = input, .count = num, .maxInt = 4})
+            ->execute();
+
+        U32 ngrps = ((num + 255) / 256) / bcase.reductionFactor;
+        pass.cpass = create_ref_object<WGPUComputePass>();
+        pass.cpass->add_simple_compute(
+            {.shaderFile = bcase.kernel.c_str(),
+             .entries = {input->as_sto(), output->as_rw_sto()},
+             .defs = bcase.defs,
+             .dims = {ngrps}});
+        pass.bytesPerDispatch = (U64)num * sizeof(U32);
+        pass.maxWorkgroups = ngrps;
+        return pass;
+    });
+
+    runner->write_json("prefixsum_benchmark.json");
+    runner->write_csv("prefixsum_benchmark.csv");
+    BOOST_CHECK_EQUAL(runner->get_num_skipped(), 0);
+    // Real timings are too noisy to fail a unit test, the regressions are
+    // only reported:
+    logNOTE("{} regression(s) against the baseline",
+            runner->get_num_regressions());
+}
+
 #if RUN_ALL
 BOOST_AUTO_TEST_CASE(test_prefixsum0) {
     // cf.
@@ -169,9 +169,21 @@ void CreateRenderPipeline() {
         .vertex = {.module = shaderModule, .entryPoint = "vertexMain"},
         .fragment = &fragmentState};
 
+    // Create the pipeline asynchronously: the frames are only cleared until
+    // it is ready.
     DEBUG_MSG("Creating pipeline");
-    pipeline = device.CreateRenderPipeline(&descriptor);
-    DEBUG_MSG("Done creating pipeline");
+    device.CreateRenderPipelineAsync(
+        &descriptor,
+        [](WGPUCreatePipelineAsyncStatus status, WGPURenderPipeline cPipeline,
+           const char* message, void* userdata) {
+            if (status != WGPUCreatePipelineAsyncStatus_Success) {
+                DEBUG_MSG("ERROR: Cannot create pipeline: " << message);
+                return;
+            }
+            pipeline = wgpu::RenderPipeline::Acquire(cPipeline);
+            DEBUG_MSG("Done creating pipeline");
+        },
+        nullptr);
 }
 
 void InitGraphics(wgpu::Surface surface) {
@@ -192,8 +204,10 @@ void Render() {
 
     wgpu::CommandEncoder encoder = device.CreateCommandEncoder();
     wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&renderpass);
-    pass.SetPipeline(pipeline);
-    pass.Draw(3);
+    if (pipeline != nullptr) {
+        pass.SetPipeline(pipeline);
+        pass.Draw(3);
+    }
     pass.End();
     wgpu::CommandBuffer commands = encoder.Finish();
     device.GetQueue().Submit(1, &commands);
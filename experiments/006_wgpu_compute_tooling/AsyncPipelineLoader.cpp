@@ -0,0 +1,216 @@
+#include <AsyncPipelineLoader.h>
+#include <WGPUEngine.h>
+
+using namespace wgpu;
+
+namespace nv {
+
+AsyncPipelineLoader::AsyncPipelineLoader(const AsyncPipelineLoaderDesc& desc)
+    : _desc(desc) {
+    U32 numThreads = _desc.numThreads;
+    if (numThreads == 0) {
+        numThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    for (U32 i = 0; i < numThreads; ++i) {
+        _workers.emplace_back([this]() { worker_loop(); });
+    }
+};
+
+AsyncPipelineLoader::~AsyncPipelineLoader() {
+    // The device callbacks reference the requests, so complete them first:
+    wait_all();
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _cond.notify_all();
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+}
+
+auto AsyncPipelineLoader::create(const AsyncPipelineLoaderDesc& desc)
+    -> RefPtr<AsyncPipelineLoader> {
+    return nv::create<AsyncPipelineLoader>(desc);
+}
+
+void AsyncPipelineLoader::worker_loop() {
+    while (true) {
+        Request* req = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cond.wait(lock,
+                       [this]() { return _stopping || !_toPreprocess.empty(); });
+            if (_stopping && _toPreprocess.empty()) {
+                return;
+            }
+            req = _toPreprocess.front();
+            _toPreprocess.pop_front();
+        }
+
+        try {
+            req->code = req->source();
+        } catch (const std::exception& e) {
+            req->error = e.what();
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _toCreate.push_back(req);
+    }
+}
+
+void AsyncPipelineLoader::enqueue(std::unique_ptr<Request> req) {
+    req->loader = this;
+    _numPending++;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _toPreprocess.push_back(req.get());
+        _requests[req.get()] = std::move(req);
+    }
+    _cond.notify_one();
+}
+
+auto AsyncPipelineLoader::request_compute_pipeline(
+    const AsyncComputeRequest& req)
+    -> std::shared_future<ComputePipeline> {
+    NVCHK(req.source != nullptr, "AsyncPipelineLoader: no source for {}",
+          req.label);
+
+    auto request = std::make_unique<Request>();
+    request->label = req.label;
+    request->source = req.source;
+    request->defs = req.defs;
+    request->entryPoint = req.entryPoint;
+
+    auto future = request->computePromise.get_future().share();
+    enqueue(std::move(request));
+    return future;
+}
+
+auto AsyncPipelineLoader::request_render_pipeline(const AsyncRenderRequest& req)
+    -> std::shared_future<RenderPipeline> {
+    NVCHK(req.source != nullptr && req.describe != nullptr,
+          "AsyncPipelineLoader: invalid render request {}", req.label);
+
+    auto request = std::make_unique<Request>();
+    request->label = req.label;
+    request->source = req.source;
+    request->describe = req.describe;
+    request->isRender = true;
+
+    auto future = request->renderPromise.get_future().share();
+    enqueue(std::move(request));
+    return future;
+}
+
+void AsyncPipelineLoader::create_pipeline(Request* req) {
+    if (!req->error.empty()) {
+        logERROR("AsyncPipelineLoader: cannot preprocess {}: {}", req->label,
+                 req->error);
+        complete(req);
+        return;
+    }
+
+    if (!req->isRender && _desc.cache != nullptr) {
+        req->cacheKey = PipelineCache::get_key({.shaderFile = req->label,
+                                      .source = req->code,
+                                      .defs = req->defs,
+                                      .entryPoint = req->entryPoint});
+        auto pipeline = _desc.cache->find_compute_pipeline(req->cacheKey);
+        if (pipeline != nullptr) {
+            req->computePromise.set_value(pipeline);
+            complete(req);
+            return;
+        }
+    }
+
+    auto device = WGPUEngine::instance()->get_device();
+
+    ShaderModuleWGSLDescriptor wgslDesc{};
+    wgslDesc.code = req->code.c_str();
+    ShaderModuleDescriptor smDesc{.nextInChain = &wgslDesc,
+                                  .label = req->label.c_str()};
+    ShaderModule module = device.CreateShaderModule(&smDesc);
+
+    if (req->isRender) {
+        req->describe(module, [device, req](const RenderPipelineDescriptor& d) {
+            device.CreateRenderPipelineAsync(
+                &d,
+                [](WGPUCreatePipelineAsyncStatus status,
+                   WGPURenderPipeline pipeline, const char* message,
+                   void* userdata) {
+                    auto* r = (Request*)userdata;
+                    if (status != WGPUCreatePipelineAsyncStatus_Success) {
+                        logERROR("AsyncPipelineLoader: cannot create {}: {}",
+                                 r->label, message);
+                    }
+                    r->renderPromise.set_value(
+                        RenderPipeline::Acquire(pipeline));
+                    r->loader->complete(r);
+                },
+                req);
+        });
+        return;
+    }
+
+    ComputePipelineDescriptor cpDesc{
+        .label = req->label.c_str(),
+        .compute = {.module = module, .entryPoint = req->entryPoint.c_str()}};
+
+    device.CreateComputePipelineAsync(
+        &cpDesc,
+        [](WGPUCreatePipelineAsyncStatus status, WGPUComputePipeline pipeline,
+           const char* message, void* userdata) {
+            auto* r = (Request*)userdata;
+            auto res = ComputePipeline::Acquire(pipeline);
+            if (status != WGPUCreatePipelineAsyncStatus_Success) {
+                logERROR("AsyncPipelineLoader: cannot create {}: {}",
+                         r->label, message);
+            } else if (r->cacheKey != 0) {
+                r->loader->_desc.cache->add_compute_pipeline(r->cacheKey, res);
+            }
+            r->computePromise.set_value(res);
+            r->loader->complete(r);
+        },
+        req);
+}
+
+void AsyncPipelineLoader::complete(Request* req) {
+    // Failed preprocessing: resolve the futures with null pipelines.
+    if (!req->error.empty()) {
+        if (req->isRender) {
+            req->renderPromise.set_value(nullptr);
+        } else {
+            req->computePromise.set_value(nullptr);
+        }
+    }
+
+    _numPending--;
+    std::lock_guard<std::mutex> lock(_mutex);
+    _requests.erase(req);
+}
+
+void AsyncPipelineLoader::poll() {
+    std::deque<Request*> ready;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ready.swap(_toCreate);
+    }
+
+    for (auto* req : ready) {
+        create_pipeline(req);
+    }
+
+    WGPUEngine::instance()->get_instance().ProcessEvents();
+}
+
+void AsyncPipelineLoader::wait_all() {
+    while (_numPending > 0) {
+        poll();
+        std::this_thread::yield();
+    }
+}
+
+} // namespace nv
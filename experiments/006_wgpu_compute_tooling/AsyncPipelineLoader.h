@@ -0,0 +1,179 @@
+#ifndef NV_ASYNCPIPELINELOADER_H_
+#define NV_ASYNCPIPELINELOADER_H_
+
+#include <PipelineCache.h>
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <thread>
+
+namespace nv {
+
+/**
+ * Pipeline slot used by a pass while its pipeline is being created: get()
+ * returns the placeholder until the real pipeline is ready, then swaps it in.
+ */
+template <typename T> class AsyncPipeline {
+  public:
+    AsyncPipeline() = default;
+    AsyncPipeline(std::shared_future<T> future, T placeholder = nullptr)
+        : _future(std::move(future)), _current(std::move(placeholder)) {}
+
+    /** Get the real pipeline if ready, or the placeholder. */
+    auto get() -> const T& {
+        if (!_ready && _future.valid() &&
+            _future.wait_for(std::chrono::seconds(0)) ==
+                std::future_status::ready) {
+            _current = _future.get();
+            _ready = true;
+        }
+        return _current;
+    }
+
+    /** Check if the real pipeline is available. */
+    auto is_ready() -> bool {
+        get();
+        return _ready;
+    }
+
+    /** Replace the placeholder (ignored once the pipeline is ready). */
+    void set_placeholder(T placeholder) {
+        if (!_ready) {
+            _current = std::move(placeholder);
+        }
+    }
+
+  protected:
+    std::shared_future<T> _future;
+    T _current;
+    bool _ready{false};
+};
+
+/** Produce the WGSL source of a pipeline (called on a worker thread). */
+using ShaderSourceProvider = std::function<String()>;
+
+struct AsyncComputeRequest {
+    /** Label of the pipeline (eg. the shader file). */
+    String label;
+
+    /** Preprocessing of the shader source. */
+    ShaderSourceProvider source;
+
+    /** Defines used by the source provider (part of the cache key). */
+    StringVector defs;
+
+    String entryPoint{"main"};
+};
+
+struct AsyncRenderRequest {
+    using DescriptorCallback =
+        std::function<void(const wgpu::RenderPipelineDescriptor&)>;
+
+    /** Label of the pipeline. */
+    String label;
+
+    /** Preprocessing of the shader source. */
+    ShaderSourceProvider source;
+
+    /** Called with the shader module on the main thread: should call create()
+    with the full descriptor (the referenced states only need to stay valid
+    during the call). */
+    std::function<void(const wgpu::ShaderModule& module,
+                       const DescriptorCallback& create)>
+        describe;
+};
+
+struct AsyncPipelineLoaderDesc {
+    /** Number of preprocessing threads (0 to use the hardware threads). */
+    U32 numThreads{0};
+
+    /** Optional cache receiving the compute pipelines (and checked before
+    compiling them). */
+    PipelineCache* cache{nullptr};
+};
+
+/**
+ * Asynchronous pipeline creation: the shader sources are preprocessed on a
+ * thread pool, then the modules and pipelines are created with the
+ * Create*PipelineAsync() device methods, so many pipelines compile in
+ * parallel without blocking the main thread. The device calls are only
+ * issued from poll() (on the thread owning the device), and each request
+ * returns a future, or an AsyncPipeline slot with a placeholder.
+ */
+class NVGPU_EXPORT AsyncPipelineLoader : public RefObject {
+  public:
+    explicit AsyncPipelineLoader(const AsyncPipelineLoaderDesc& desc);
+    ~AsyncPipelineLoader() override;
+
+    static auto create(const AsyncPipelineLoaderDesc& desc = {})
+        -> RefPtr<AsyncPipelineLoader>;
+
+    /** Queue the creation of a compute pipeline. */
+    auto request_compute_pipeline(const AsyncComputeRequest& req)
+        -> std::shared_future<wgpu::ComputePipeline>;
+
+    /** Queue the creation of a render pipeline. */
+    auto request_render_pipeline(const AsyncRenderRequest& req)
+        -> std::shared_future<wgpu::RenderPipeline>;
+
+    /** Create the modules/pipelines of the preprocessed requests and process
+    the device events (non blocking). */
+    void poll();
+
+    /** Poll until all the requests are completed. */
+    void wait_all();
+
+    /** Get the number of requests not completed yet. */
+    auto get_num_pending() const -> U32 { return _numPending; }
+
+  protected:
+    struct Request {
+        String label;
+        ShaderSourceProvider source;
+        StringVector defs;
+        String entryPoint;
+        std::function<void(const wgpu::ShaderModule&,
+                           const AsyncRenderRequest::DescriptorCallback&)>
+            describe;
+        bool isRender{false};
+
+        /** Preprocessed source (written by the worker). */
+        String code;
+        String error;
+
+        /** Pipeline cache key (0 when not cached). */
+        U64 cacheKey{0};
+
+        std::promise<wgpu::ComputePipeline> computePromise;
+        std::promise<wgpu::RenderPipeline> renderPromise;
+        AsyncPipelineLoader* loader{nullptr};
+    };
+
+    AsyncPipelineLoaderDesc _desc;
+    Vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    bool _stopping{false};
+
+    /** Requests waiting for preprocessing. */
+    std::deque<Request*> _toPreprocess;
+
+    /** Preprocessed requests waiting for the device calls. */
+    std::deque<Request*> _toCreate;
+
+    /** All the requests in flight (owned). */
+    std::map<Request*, std::unique_ptr<Request>> _requests;
+    U32 _numPending{0};
+
+    void worker_loop();
+    void enqueue(std::unique_ptr<Request> req);
+    void create_pipeline(Request* req);
+
+    /** Called from the device callbacks. */
+    void complete(Request* req);
+};
+
+} // namespace nv
+
+#endif
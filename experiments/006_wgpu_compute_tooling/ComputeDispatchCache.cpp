@@ -0,0 +1,152 @@
+#include <ComputeDispatchCache.h>
+#include <WGPUEngine.h>
+
+#include <algorithm>
+
+using namespace wgpu;
+
+namespace nv {
+
+ComputeDispatchCache::ComputeDispatchCache(const ComputeDispatchCacheDesc& desc)
+    : _desc(desc) {
+    NVCHK(_desc.maxBindGroups > 0, "ComputeDispatchCache: invalid size.");
+};
+
+ComputeDispatchCache::~ComputeDispatchCache() = default;
+
+auto ComputeDispatchCache::create(const ComputeDispatchCacheDesc& desc)
+    -> RefPtr<ComputeDispatchCache> {
+    return nv::create<ComputeDispatchCache>(desc);
+}
+
+auto ComputeDispatchCache::get_key(const ComputeDispatch& dispatch) -> String {
+    // The raw handles identify the objects (they are kept alive by the
+    // cache entries):
+    Vector<U64> words;
+    words.reserve(1 + dispatch.buffers.size() * 3);
+    words.push_back((U64)(uintptr_t)dispatch.pipeline.Get());
+    for (const auto& buf : dispatch.buffers) {
+        words.push_back((U64)(uintptr_t)buf.buffer.Get());
+        words.push_back(buf.offset);
+        words.push_back(buf.size);
+    }
+    return {(const char*)words.data(), words.size() * sizeof(U64)};
+}
+
+void ComputeDispatchCache::evict_oldest() {
+    auto oldest = _bindGroups.begin();
+    for (auto it = _bindGroups.begin(); it != _bindGroups.end(); ++it) {
+        if (it->second.lastUse < oldest->second.lastUse) {
+            oldest = it;
+        }
+    }
+    _bindGroups.erase(oldest);
+}
+
+auto ComputeDispatchCache::get_bind_group(const ComputeDispatch& dispatch)
+    -> BindGroup {
+    NVCHK(dispatch.pipeline != nullptr, "ComputeDispatchCache: no pipeline.");
+
+    String key = get_key(dispatch);
+    auto it = _bindGroups.find(key);
+    if (it != _bindGroups.end()) {
+        _numHits++;
+        it->second.lastUse = ++_useCounter;
+        return it->second.bindGroup;
+    }
+
+    _numMisses++;
+    if (_bindGroups.size() >= _desc.maxBindGroups) {
+        evict_oldest();
+    }
+
+    Vector<BindGroupEntry> entries(dispatch.buffers.size());
+    Vector<WGPUBuffer> buffers(dispatch.buffers.size());
+    for (U32 i = 0; i < entries.size(); ++i) {
+        const auto& buf = dispatch.buffers[i];
+        entries[i] = {.binding = i,
+                      .buffer = buf.buffer,
+                      .offset = buf.offset,
+                      .size = buf.size};
+        buffers[i] = buf.buffer.Get();
+    }
+
+    BindGroupDescriptor bgDesc{
+        .layout = dispatch.pipeline.GetBindGroupLayout(0),
+        .entryCount = entries.size(),
+        .entries = entries.data()};
+    auto bindGroup =
+        WGPUEngine::instance()->get_device().CreateBindGroup(&bgDesc);
+
+    _bindGroups[key] = {.bindGroup = bindGroup,
+                        .pipeline = dispatch.pipeline,
+                        .buffers = std::move(buffers),
+                        .lastUse = ++_useCounter};
+    return bindGroup;
+}
+
+void ComputeDispatchCache::encode(ComputePassEncoder& pass,
+                                  const Vector<ComputeDispatch>& dispatches,
+                                  U32 repeat) {
+    // Resolve the bind groups once for all the repetitions:
+    Vector<BindGroup> bindGroups;
+    bindGroups.reserve(dispatches.size());
+    for (const auto& dispatch : dispatches) {
+        bindGroups.push_back(get_bind_group(dispatch));
+    }
+
+    WGPUComputePipeline curPipeline = nullptr;
+    WGPUBindGroup curBindGroup = nullptr;
+    for (U32 r = 0; r < repeat; ++r) {
+        for (U32 i = 0; i < dispatches.size(); ++i) {
+            const auto& dispatch = dispatches[i];
+            if (dispatch.pipeline.Get() != curPipeline) {
+                pass.SetPipeline(dispatch.pipeline);
+                curPipeline = dispatch.pipeline.Get();
+            } else {
+                _numSkipped++;
+            }
+            if (bindGroups[i].Get() != curBindGroup) {
+                pass.SetBindGroup(0, bindGroups[i]);
+                curBindGroup = bindGroups[i].Get();
+            } else {
+                _numSkipped++;
+            }
+            pass.DispatchWorkgroups(dispatch.dims.x, dispatch.dims.y,
+                                    dispatch.dims.z);
+        }
+    }
+}
+
+void ComputeDispatchCache::execute(const Vector<ComputeDispatch>& dispatches,
+                                   U32 repeat) {
+    auto* eng = WGPUEngine::instance();
+
+    // Keep the ordering with the work recorded in the builder:
+    eng->build_commands().submit(false);
+
+    CommandEncoder encoder = eng->get_device().CreateCommandEncoder();
+    ComputePassEncoder pass = encoder.BeginComputePass();
+    encode(pass, dispatches, repeat);
+    pass.End();
+    CommandBuffer commands = encoder.Finish();
+    eng->get_queue().Submit(1, &commands);
+}
+
+auto ComputeDispatchCache::invalidate(const Buffer& buffer) -> U32 {
+    U32 count = 0;
+    for (auto it = _bindGroups.begin(); it != _bindGroups.end();) {
+        const auto& bufs = it->second.buffers;
+        if (std::find(bufs.begin(), bufs.end(), buffer.Get()) != bufs.end()) {
+            it = _bindGroups.erase(it);
+            count++;
+        } else {
+            ++it;
+        }
+    }
+    return count;
+}
+
+void ComputeDispatchCache::clear() { _bindGroups.clear(); }
+
+} // namespace nv
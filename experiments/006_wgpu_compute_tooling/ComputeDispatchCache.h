@@ -0,0 +1,105 @@
+#ifndef NV_COMPUTEDISPATCHCACHE_H_
+#define NV_COMPUTEDISPATCHCACHE_H_
+
+#include <gpu_common.h>
+
+namespace nv {
+
+struct ComputeDispatchCacheDesc {
+    /** Max number of cached bind groups (least recently used ones are
+    released first). */
+    U32 maxBindGroups{1024};
+};
+
+/** Storage buffer range bound to a dispatch. */
+struct DispatchBuffer {
+    wgpu::Buffer buffer;
+    U64 offset{0};
+    U64 size{wgpu::kWholeSize};
+};
+
+struct ComputeDispatch {
+    wgpu::ComputePipeline pipeline;
+
+    /** Buffers bound to group 0, at the bindings 0..N-1 (same layout as the
+    entries of add_simple_compute()). */
+    Vector<DispatchBuffer> buffers;
+
+    /** Number of workgroups in each dimension. */
+    Vec3u dims{1, 1, 1};
+};
+
+/**
+ * Bind group and dispatch state cache for compute passes executed many
+ * times with the same resources: the bind groups are keyed on the pipeline
+ * and buffer handles, so they are only created again when a bound buffer is
+ * recreated. When encoding, the pipeline and bind group of a dispatch are
+ * only set if they differ from the current pass state, so N consecutive runs
+ * of the same dispatches bind the resources once.
+ * Note: the cached bind groups keep their buffers alive, and the cache isn't
+ * notified when a GPUBuffer is recreated: calling invalidate() on the old
+ * buffer when releasing or recreating it is the caller's job. A missed call
+ * pins the old buffer in memory until its bind group is evicted (LRU).
+ */
+class NVGPU_EXPORT ComputeDispatchCache : public RefObject {
+  public:
+    explicit ComputeDispatchCache(const ComputeDispatchCacheDesc& desc);
+    ~ComputeDispatchCache() override;
+
+    static auto create(const ComputeDispatchCacheDesc& desc = {})
+        -> RefPtr<ComputeDispatchCache>;
+
+    /** Get the bind group of a dispatch (created on first use). */
+    auto get_bind_group(const ComputeDispatch& dispatch) -> wgpu::BindGroup;
+
+    /** Record the dispatches repeat times in a compute pass, skipping the
+    redundant pipeline/bind group changes. */
+    void encode(wgpu::ComputePassEncoder& pass,
+                const Vector<ComputeDispatch>& dispatches, U32 repeat = 1);
+
+    /** Flush the builder commands, then encode and submit the dispatches
+    repeat times in a single compute pass. */
+    void execute(const Vector<ComputeDispatch>& dispatches, U32 repeat = 1);
+
+    /** Release the cached bind groups referencing a buffer (to call when
+    the buffer is released or recreated). Returns the number of released
+    bind groups. */
+    auto invalidate(const wgpu::Buffer& buffer) -> U32;
+
+    /** Release all the cached bind groups. */
+    void clear();
+
+    auto get_num_bind_groups() const -> U32 { return (U32)_bindGroups.size(); }
+    auto get_num_hits() const -> U32 { return _numHits; }
+    auto get_num_misses() const -> U32 { return _numMisses; }
+
+    /** Number of SetPipeline/SetBindGroup calls skipped by the state
+    tracking. */
+    auto get_num_skipped_bindings() const -> U32 { return _numSkipped; }
+
+  protected:
+    struct Entry {
+        wgpu::BindGroup bindGroup;
+        wgpu::ComputePipeline pipeline;
+        /** Bound buffer handles (for invalidate()). */
+        Vector<WGPUBuffer> buffers;
+        U64 lastUse{0};
+    };
+
+    ComputeDispatchCacheDesc _desc;
+    std::map<String, Entry> _bindGroups;
+    U64 _useCounter{0};
+
+    U32 _numHits{0};
+    U32 _numMisses{0};
+    U32 _numSkipped{0};
+
+    static auto get_key(const ComputeDispatch& dispatch) -> String;
+
+    /** Release the least recently used bind group. */
+    void evict_oldest();
+};
+
+} // namespace nv
+
+#endif
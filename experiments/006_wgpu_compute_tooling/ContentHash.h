@@ -0,0 +1,44 @@
+#ifndef NV_CONTENTHASH_H_
+#define NV_CONTENTHASH_H_
+
+#include <gpu_common.h>
+
+namespace nv {
+
+/** 64 bits FNV-1a hash, stable across runs and platforms (used for the
+cache keys persisted on disk). */
+constexpr U64 kFNVOffsetBasis = 0xcbf29ce484222325ULL;
+constexpr U64 kFNVPrime = 0x100000001b3ULL;
+
+inline auto hash_bytes(const void* data, size_t size,
+                       U64 seed = kFNVOffsetBasis) -> U64 {
+    const auto* bytes = (const U8*)data;
+    U64 h = seed;
+    for (size_t i = 0; i < size; ++i) {
+        h ^= bytes[i];
+        h *= kFNVPrime;
+    }
+    return h;
+}
+
+inline auto hash_string(const String& str, U64 seed = kFNVOffsetBasis)
+    -> U64 {
+    // Also hash the length so that ("ab", "c") and ("a", "bc") differ:
+    U64 size = str.size();
+    return hash_bytes(str.data(), str.size(),
+                      hash_bytes(&size, sizeof(size), seed));
+}
+
+inline auto hash_to_string(U64 hash) -> String {
+    static const char* digits = "0123456789abcdef";
+    String res(16, '0');
+    for (I32 i = 15; i >= 0; --i) {
+        res[i] = digits[hash & 0xF];
+        hash >>= 4;
+    }
+    return res;
+}
+
+} // namespace nv
+
+#endif
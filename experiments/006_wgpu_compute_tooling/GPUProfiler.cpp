@@ -0,0 +1,278 @@
+#include <GPUProfiler.h>
+#include <WGPUEngine.h>
+
+#include <algorithm>
+
+using namespace wgpu;
+
+namespace nv {
+
+GPUProfiler::GPUProfiler(const GPUProfilerDesc& desc) : _desc(desc) {
+    NVCHK(_desc.numFrames > 0, "GPUProfiler: invalid number of frames.");
+    NVCHK(_desc.maxScopesPerFrame > 0 && _desc.historySize > 0,
+          "GPUProfiler: invalid sizes.");
+    NVCHK(is_supported(), "GPUProfiler: timestamp queries not supported.");
+
+    auto* eng = WGPUEngine::instance();
+    auto device = eng->get_device();
+
+    U32 numQueries = _desc.maxScopesPerFrame * 2;
+    U64 size = (U64)numQueries * sizeof(U64);
+
+    _frames.resize(_desc.numFrames);
+    for (auto& frame : _frames) {
+        QuerySetDescriptor qsDesc{.type = QueryType::Timestamp,
+                                  .count = numQueries};
+        frame.querySet = device.CreateQuerySet(&qsDesc);
+
+        BufferDescriptor resolveDesc{.usage = BufferUsage::QueryResolve |
+                                              BufferUsage::CopySrc,
+                                     .size = size};
+        frame.resolveBuffer = device.CreateBuffer(&resolveDesc);
+
+        BufferDescriptor rbDesc{.usage = BufferUsage::MapRead |
+                                         BufferUsage::CopyDst,
+                                .size = size};
+        frame.readback = device.CreateBuffer(&rbDesc);
+    }
+};
+
+GPUProfiler::~GPUProfiler() {
+    // Make sure no map callback is pending on the frames:
+    auto* eng = WGPUEngine::instance();
+    eng->wait_idle();
+    for (auto& frame : _frames) {
+        while (frame.pending && !frame.mapped) {
+            eng->get_instance().ProcessEvents();
+        }
+    }
+}
+
+auto GPUProfiler::create(const GPUProfilerDesc& desc) -> RefPtr<GPUProfiler> {
+    return nv::create<GPUProfiler>(desc);
+}
+
+auto GPUProfiler::is_supported() -> bool {
+    auto* eng = WGPUEngine::instance();
+    return eng->get_device().HasFeature(FeatureName::TimestampQuery);
+}
+
+void GPUProfiler::begin_frame() {
+    NVCHK(!_recording, "GPUProfiler: frame already started.");
+    collect();
+
+    auto& frame = _frames[_current];
+    if (frame.pending) {
+        // All the frames are still in flight, skip this one:
+        _numDropped++;
+        return;
+    }
+
+    frame.scopes.clear();
+    frame.numQueries = 0;
+    _stack.clear();
+    _recording = true;
+}
+
+void GPUProfiler::write_timestamp(U32 query, CommandEncoder* encoder) {
+    if (encoder != nullptr) {
+        encoder->WriteTimestamp(_frames[_current].querySet, query);
+        return;
+    }
+
+    auto* eng = WGPUEngine::instance();
+
+    // Flush the work recorded so far, so that it's ordered before the
+    // timestamp on the queue:
+    eng->build_commands().submit(false);
+
+    CommandEncoder encoder = eng->get_device().CreateCommandEncoder();
+    encoder.WriteTimestamp(_frames[_current].querySet, query);
+    CommandBuffer commands = encoder.Finish();
+    eng->get_queue().Submit(1, &commands);
+}
+
+auto GPUProfiler::push_scope(const String& name) -> U32 {
+    if (!_recording) {
+        return U32(-1);
+    }
+
+    auto& frame = _frames[_current];
+    if (frame.numQueries + 2 > _desc.maxScopesPerFrame * 2) {
+        logWARN("GPUProfiler: too many scopes in frame, ignoring {}", name);
+        // Keep the stack balanced for end_scope():
+        _stack.push_back(U32(-1));
+        return U32(-1);
+    }
+
+    String path = name;
+    for (auto it = _stack.rbegin(); it != _stack.rend(); ++it) {
+        if (*it != U32(-1)) {
+            path = frame.scopes[*it].path + "/" + name;
+            break;
+        }
+    }
+
+    ScopeRecord scope{.path = path,
+                      .depth = (U32)_stack.size(),
+                      .beginQuery = frame.numQueries++,
+                      .endQuery = frame.numQueries++};
+    _stack.push_back((U32)frame.scopes.size());
+    frame.scopes.push_back(scope);
+    return scope.beginQuery;
+}
+
+auto GPUProfiler::pop_scope() -> U32 {
+    if (!_recording) {
+        return U32(-1);
+    }
+    NVCHK(!_stack.empty(), "GPUProfiler: no scope to end.");
+
+    U32 idx = _stack.back();
+    _stack.pop_back();
+    return idx != U32(-1) ? _frames[_current].scopes[idx].endQuery : U32(-1);
+}
+
+void GPUProfiler::begin_scope(const String& name) {
+    U32 query = push_scope(name);
+    if (query != U32(-1)) {
+        write_timestamp(query, nullptr);
+    }
+}
+
+void GPUProfiler::end_scope() {
+    U32 query = pop_scope();
+    if (query != U32(-1)) {
+        write_timestamp(query, nullptr);
+    }
+}
+
+void GPUProfiler::begin_scope(const String& name, CommandEncoder& encoder) {
+    U32 query = push_scope(name);
+    if (query != U32(-1)) {
+        write_timestamp(query, &encoder);
+    }
+}
+
+void GPUProfiler::end_scope(CommandEncoder& encoder) {
+    U32 query = pop_scope();
+    if (query != U32(-1)) {
+        write_timestamp(query, &encoder);
+    }
+}
+
+void GPUProfiler::end_frame() {
+    if (!_recording) {
+        return;
+    }
+    NVCHK(_stack.empty(), "GPUProfiler: {} scope(s) not closed.",
+          _stack.size());
+    _recording = false;
+
+    auto& frame = _frames[_current];
+    _current = (_current + 1) % (U32)_frames.size();
+    if (frame.numQueries == 0) {
+        return;
+    }
+
+    auto* eng = WGPUEngine::instance();
+    U64 size = (U64)frame.numQueries * sizeof(U64);
+
+    CommandEncoder encoder = eng->get_device().CreateCommandEncoder();
+    encoder.ResolveQuerySet(frame.querySet, 0, frame.numQueries,
+                            frame.resolveBuffer, 0);
+    encoder.CopyBufferToBuffer(frame.resolveBuffer, 0, frame.readback, 0,
+                               size);
+    CommandBuffer commands = encoder.Finish();
+    eng->get_queue().Submit(1, &commands);
+
+    frame.mapped = false;
+    frame.pending = true;
+    frame.readback.MapAsync(
+        MapMode::Read, 0, size,
+        [](WGPUBufferMapAsyncStatus status, void* userdata) {
+            if (status != WGPUBufferMapAsyncStatus_Success) {
+                logERROR("GPUProfiler: cannot map readback buffer.");
+            }
+            *(bool*)userdata = true;
+        },
+        &frame.mapped);
+}
+
+void GPUProfiler::collect() {
+    WGPUEngine::instance()->get_instance().ProcessEvents();
+
+    for (auto& frame : _frames) {
+        if (frame.pending && frame.mapped) {
+            read_frame(frame);
+            frame.readback.Unmap();
+            frame.pending = false;
+        }
+    }
+}
+
+void GPUProfiler::read_frame(Frame& frame) {
+    U64 size = (U64)frame.numQueries * sizeof(U64);
+    const auto* ts = (const U64*)frame.readback.GetConstMappedRange(0, size);
+    if (ts == nullptr) {
+        return;
+    }
+
+    for (const auto& scope : frame.scopes) {
+        U64 t0 = ts[scope.beginQuery];
+        U64 t1 = ts[scope.endQuery];
+        F64 ns = t1 >= t0 ? (F64)(t1 - t0) : 0.0;
+
+        auto& hist = _history[scope.path];
+        hist.depth = scope.depth;
+        hist.lastNs = ns;
+        if (hist.samples.size() < _desc.historySize) {
+            hist.samples.push_back(ns);
+        } else {
+            hist.samples[hist.next] = ns;
+        }
+        hist.next = (hist.next + 1) % _desc.historySize;
+    }
+}
+
+auto GPUProfiler::get_scope_stats(const String& path) const
+    -> GPUProfileStats {
+    GPUProfileStats stats{.name = path};
+    auto it = _history.find(path);
+    if (it == _history.end() || it->second.samples.empty()) {
+        return stats;
+    }
+
+    Vector<F64> sorted = it->second.samples;
+    std::sort(sorted.begin(), sorted.end());
+    auto n = sorted.size();
+
+    stats.depth = it->second.depth;
+    stats.numSamples = (U32)n;
+    stats.minNs = sorted.front();
+    stats.medianNs = sorted[n / 2];
+    stats.p99Ns = sorted[std::min(n - 1, (size_t)((F64)n * 0.99))];
+    stats.lastNs = it->second.lastNs;
+    return stats;
+}
+
+auto GPUProfiler::get_stats() const -> Vector<GPUProfileStats> {
+    Vector<GPUProfileStats> res;
+    for (const auto& it : _history) {
+        res.push_back(get_scope_stats(it.first));
+    }
+    return res;
+}
+
+void GPUProfiler::log_report() const {
+    logNOTE("GPUProfiler: {} scopes, {} dropped frames", _history.size(),
+            _numDropped);
+    for (const auto& stats : get_stats()) {
+        logNOTE("{:>{}}{}: min {:.3f} us, median {:.3f} us, p99 {:.3f} us "
+                "({} samples)",
+                "", stats.depth * 2, stats.name, stats.minNs * 1e-3,
+                stats.medianNs * 1e-3, stats.p99Ns * 1e-3, stats.numSamples);
+    }
+}
+
+} // namespace nv
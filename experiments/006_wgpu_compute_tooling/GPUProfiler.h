@@ -0,0 +1,174 @@
+#ifndef NV_GPUPROFILER_H_
+#define NV_GPUPROFILER_H_
+
+#include <gpu_common.h>
+
+namespace nv {
+
+struct GPUProfilerDesc {
+    /** Number of frames in flight (one query set per frame). */
+    U32 numFrames{3};
+
+    /** Max number of scopes per frame. */
+    U32 maxScopesPerFrame{128};
+
+    /** Number of samples kept per scope for the statistics. */
+    U32 historySize{256};
+};
+
+/** Aggregated timings of a scope (in ns). */
+struct GPUProfileStats {
+    String name;
+    U32 depth{0};
+    U32 numSamples{0};
+    F64 minNs{0.0};
+    F64 medianNs{0.0};
+    F64 p99Ns{0.0};
+    F64 lastNs{0.0};
+};
+
+/**
+ * GPU timestamp profiler with named, nestable scopes: each scope writes a
+ * begin/end timestamp pair in the query set of the current frame, and the
+ * query sets are used as a ring, resolved and mapped asynchronously, so
+ * reading the results never stalls the submissions. When all the frames of
+ * the ring are still in flight the new frame is skipped (and counted as
+ * dropped). Scope names are joined with '/' to identify nested scopes.
+ * The engine builder doesn't expose its command encoder, so a builder scope
+ * costs two extra queue submits: at each boundary the recorded builder
+ * commands are flushed, then the timestamp is written from its own small
+ * command buffer (it also splits the builder work into more submits, which
+ * adds some CPU overhead and may hide overlaps between scopes). When the
+ * caller records its own commands, the encoder overloads write the
+ * timestamps directly in the caller's encoder without any submit: the caller
+ * must then finish and submit that encoder before end_frame(), which queues
+ * the resolve of the query set (otherwise the resolve runs before the
+ * timestamps are written and the scope timings are invalid).
+ */
+class NVGPU_EXPORT GPUProfiler : public RefObject {
+  public:
+    explicit GPUProfiler(const GPUProfilerDesc& desc);
+    ~GPUProfiler() override;
+
+    static auto create(const GPUProfilerDesc& desc = {})
+        -> RefPtr<GPUProfiler>;
+
+    /** Start recording a new frame. */
+    void begin_frame();
+
+    /** Finish the current frame and queue the resolve of its timestamps
+    (the encoders passed to the scopes must already be submitted). */
+    void end_frame();
+
+    /** Open a named scope (nested in the current one). */
+    void begin_scope(const String& name);
+
+    /** Close the current scope. */
+    void end_scope();
+
+    /** Open a named scope with its timestamp written in an encoder (to be
+    submitted before end_frame()). */
+    void begin_scope(const String& name, wgpu::CommandEncoder& encoder);
+
+    /** Close the current scope with its timestamp written in an encoder. */
+    void end_scope(wgpu::CommandEncoder& encoder);
+
+    /** Process the resolved frames (non blocking). */
+    void collect();
+
+    /** Get the statistics of all the scopes seen so far (sorted by path). */
+    auto get_stats() const -> Vector<GPUProfileStats>;
+
+    /** Get the statistics of one scope path (eg. "frame/scan/reduce"). */
+    auto get_scope_stats(const String& path) const -> GPUProfileStats;
+
+    /** Log the per-scope breakdown. */
+    void log_report() const;
+
+    /** Number of frames skipped because the ring was full. */
+    auto get_num_dropped_frames() const -> U32 { return _numDropped; }
+
+    /** Check if the current device supports timestamp queries. */
+    static auto is_supported() -> bool;
+
+  protected:
+    struct ScopeRecord {
+        String path;
+        U32 depth{0};
+        U32 beginQuery{0};
+        U32 endQuery{0};
+    };
+
+    struct Frame {
+        wgpu::QuerySet querySet;
+        wgpu::Buffer resolveBuffer;
+        wgpu::Buffer readback;
+        Vector<ScopeRecord> scopes;
+        U32 numQueries{0};
+        /** Set from the map callback. */
+        bool mapped{false};
+        bool pending{false};
+    };
+
+    struct ScopeHistory {
+        U32 depth{0};
+        Vector<F64> samples;
+        U32 next{0};
+        F64 lastNs{0.0};
+    };
+
+    GPUProfilerDesc _desc;
+    Vector<Frame> _frames;
+    U32 _current{0};
+    bool _recording{false};
+    U32 _numDropped{0};
+
+    /** Indices of the open scopes in the current frame. */
+    Vector<U32> _stack;
+    std::map<String, ScopeHistory> _history;
+
+    /** Write a timestamp in the encoder, or (if null) submit the pending
+    builder commands then the timestamp. */
+    void write_timestamp(U32 query, wgpu::CommandEncoder* encoder);
+
+    /** Push a scope, returns its begin query (or U32(-1) if ignored). */
+    auto push_scope(const String& name) -> U32;
+
+    /** Pop a scope, returns its end query (or U32(-1) if ignored). */
+    auto pop_scope() -> U32;
+
+    /** Add the timings of a mapped frame to the history. */
+    void read_frame(Frame& frame);
+};
+
+/** RAII helper opening a profiler scope. */
+class GPUProfileScope {
+  public:
+    GPUProfileScope(GPUProfiler& profiler, const String& name)
+        : _profiler(profiler) {
+        _profiler.begin_scope(name);
+    }
+    GPUProfileScope(GPUProfiler& profiler, const String& name,
+                    wgpu::CommandEncoder& encoder)
+        : _profiler(profiler), _encoder(&encoder) {
+        _profiler.begin_scope(name, encoder);
+    }
+    ~GPUProfileScope() {
+        if (_encoder != nullptr) {
+            _profiler.end_scope(*_encoder);
+        } else {
+            _profiler.end_scope();
+        }
+    }
+
+    GPUProfileScope(const GPUProfileScope&) = delete;
+    auto operator=(const GPUProfileScope&) -> GPUProfileScope& = delete;
+
+  protected:
+    GPUProfiler& _profiler;
+    wgpu::CommandEncoder* _encoder{nullptr};
+};
+
+} // namespace nv
+
+#endif
@@ -0,0 +1,275 @@
+#include <PipelineCache.h>
+#include <WGPUEngine.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace wgpu;
+
+namespace fs = std::filesystem;
+
+namespace nv {
+
+PipelineCache::PipelineCache(const PipelineCacheDesc& desc) : _desc(desc) {
+    if (!_desc.cacheDir.empty()) {
+        std::error_code ec;
+        fs::create_directories(_desc.cacheDir, ec);
+        if (ec) {
+            logWARN("PipelineCache: cannot create {}, disk cache disabled.",
+                    _desc.cacheDir);
+            _desc.cacheDir.clear();
+        }
+    }
+};
+
+PipelineCache::~PipelineCache() = default;
+
+auto PipelineCache::create(const PipelineCacheDesc& desc)
+    -> RefPtr<PipelineCache> {
+    return nv::create<PipelineCache>(desc);
+}
+
+auto PipelineCache::get_adapter_key() -> String {
+    auto* eng = WGPUEngine::instance();
+    AdapterInfo info{};
+    eng->get_adapter().GetInfo(&info);
+
+    std::ostringstream os;
+    os << std::hex << info.vendorID << ":" << info.deviceID << ":" << std::dec
+       << (U32)info.backendType;
+    return os.str();
+}
+
+auto PipelineCache::get_key(const ComputePipelineKey& key) -> U64 {
+    U64 h = key.contentHash;
+    if (h == 0) {
+        h = hash_string(key.source);
+        for (const auto& def : key.defs) {
+            h = hash_string(def, h);
+        }
+    }
+    h = hash_string(key.entryPoint, h);
+    return hash_string(get_adapter_key(), h);
+}
+
+auto PipelineCache::find_compute_pipeline(U64 key) -> ComputePipeline {
+    auto it = _pipelines.find(key);
+    if (it == _pipelines.end()) {
+        return nullptr;
+    }
+    _numHits++;
+    return it->second;
+}
+
+auto PipelineCache::get_compute_pipeline(const ComputePipelineKey& key)
+    -> ComputePipeline {
+    U64 h = get_key(key);
+    auto found = find_compute_pipeline(h);
+    if (found != nullptr) {
+        return found;
+    }
+
+    _numMisses++;
+    auto startTick = SystemTime::tick();
+    auto pipeline =
+        create_compute_pipeline(WGPUEngine::instance()->get_device(), key);
+
+    logDEBUG("PipelineCache: created pipeline {} for {} in {:.3f} ms",
+             hash_to_string(h), key.shaderFile,
+             SystemTime::delta_s(startTick, SystemTime::tick()) * 1e3);
+
+    _pipelines[h] = pipeline;
+    return pipeline;
+}
+
+auto PipelineCache::create_compute_pipeline(const Device& device,
+                                            const ComputePipelineKey& key)
+    -> ComputePipeline {
+    // Dawn always returns a pipeline object (invalid on errors), so the
+    // validation errors are captured with an error scope:
+    device.PushErrorScope(ErrorFilter::Validation);
+
+    ShaderModuleWGSLDescriptor wgslDesc{};
+    wgslDesc.code = key.source.c_str();
+    ShaderModuleDescriptor smDesc{.nextInChain = &wgslDesc,
+                                  .label = key.shaderFile.c_str()};
+    ShaderModule module = device.CreateShaderModule(&smDesc);
+
+    ComputePipelineDescriptor cpDesc{
+        .label = key.shaderFile.c_str(),
+        .compute = {.module = module, .entryPoint = key.entryPoint.c_str()}};
+    ComputePipeline pipeline = device.CreateComputePipeline(&cpDesc);
+
+    struct ScopeResult {
+        bool done{false};
+        WGPUErrorType type{WGPUErrorType_NoError};
+        String message;
+    } result;
+    device.PopErrorScope(
+        [](WGPUErrorType type, const char* message, void* userdata) {
+            auto* res = (ScopeResult*)userdata;
+            res->type = type;
+            res->message = message != nullptr ? message : "";
+            res->done = true;
+        },
+        &result);
+    auto* eng = WGPUEngine::instance();
+    while (!result.done) {
+        eng->get_instance().ProcessEvents();
+    }
+
+    if (result.type != WGPUErrorType_NoError) {
+        THROW_MSG("PipelineCache: cannot create pipeline for {}: {}",
+                  key.shaderFile, result.message);
+    }
+    return pipeline;
+}
+
+void PipelineCache::setup_device_cache(DawnCacheDeviceDescriptor& desc) {
+    if (_desc.cacheDir.empty()) {
+        return;
+    }
+
+    desc.loadDataFunction = [](const void* key, size_t keySize, void* value,
+                               size_t valueSize, void* userdata) -> size_t {
+        return ((PipelineCache*)userdata)
+            ->load_blob(key, keySize, value, valueSize);
+    };
+    desc.storeDataFunction = [](const void* key, size_t keySize,
+                                const void* value, size_t valueSize,
+                                void* userdata) {
+        ((PipelineCache*)userdata)->store_blob(key, keySize, value, valueSize);
+    };
+    desc.functionUserdata = this;
+}
+
+auto PipelineCache::get_blob_file(const void* key, size_t keySize) const
+    -> String {
+    // The Dawn keys are already specific to the adapter and toggles:
+    return (fs::path(_desc.cacheDir) /
+            (hash_to_string(hash_bytes(key, keySize)) + ".bin"))
+        .string();
+}
+
+auto PipelineCache::load_blob(const void* key, size_t keySize, void* value,
+                              size_t valueSize) -> size_t {
+    if (_desc.cacheDir.empty()) {
+        return 0;
+    }
+
+    // Note: the callbacks may be called from the Dawn worker threads:
+    std::lock_guard<std::mutex> lock(_blobMutex);
+    std::ifstream file(get_blob_file(key, keySize), std::ios::binary);
+    if (!file.is_open()) {
+        return 0;
+    }
+
+    // Each blob file starts with the full key, to detect hash collisions:
+    U64 storedKeySize = 0;
+    file.read((char*)&storedKeySize, sizeof(storedKeySize));
+    if (!file || storedKeySize != keySize) {
+        return 0;
+    }
+    Vector<U8> storedKey(keySize);
+    file.read((char*)storedKey.data(), (std::streamsize)keySize);
+    if (!file || memcmp(storedKey.data(), key, keySize) != 0) {
+        return 0;
+    }
+
+    U64 blobSize = 0;
+    file.read((char*)&blobSize, sizeof(blobSize));
+    if (!file) {
+        return 0;
+    }
+    if (value == nullptr || valueSize == 0) {
+        return blobSize;
+    }
+    if (valueSize < blobSize) {
+        return 0;
+    }
+
+    file.read((char*)value, (std::streamsize)blobSize);
+    if (!file) {
+        return 0;
+    }
+    _numBlobHits++;
+    return blobSize;
+}
+
+void PipelineCache::store_blob(const void* key, size_t keySize,
+                               const void* value, size_t valueSize) {
+    if (_desc.cacheDir.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_blobMutex);
+    String filename = get_blob_file(key, keySize);
+
+    // Write to a temporary file first, so that a crash never leaves a
+    // truncated blob:
+    String tmpFile = filename + ".tmp";
+    {
+        std::ofstream file(tmpFile, std::ios::binary);
+        if (!file.is_open()) {
+            logWARN("PipelineCache: cannot write blob file {}", tmpFile);
+            return;
+        }
+        U64 size = keySize;
+        file.write((const char*)&size, sizeof(size));
+        file.write((const char*)key, (std::streamsize)keySize);
+        size = valueSize;
+        file.write((const char*)&size, sizeof(size));
+        file.write((const char*)value, (std::streamsize)valueSize);
+    }
+
+    std::error_code ec;
+    fs::rename(tmpFile, filename, ec);
+    if (ec) {
+        logWARN("PipelineCache: cannot store blob file {}", filename);
+        fs::remove(tmpFile, ec);
+        return;
+    }
+    _numBlobStores++;
+
+    trim_disk_cache();
+}
+
+void PipelineCache::trim_disk_cache() {
+    if (_desc.maxDiskSize == 0) {
+        return;
+    }
+
+    struct Entry {
+        fs::path path;
+        fs::file_time_type time;
+        U64 size;
+    };
+    Vector<Entry> entries;
+    U64 total = 0;
+    std::error_code ec;
+    for (const auto& it : fs::directory_iterator(_desc.cacheDir, ec)) {
+        if (it.is_regular_file(ec) && it.path().extension() == ".bin") {
+            U64 size = it.file_size(ec);
+            entries.push_back({it.path(), it.last_write_time(ec), size});
+            total += size;
+        }
+    }
+    if (total <= _desc.maxDiskSize) {
+        return;
+    }
+
+    // Remove the oldest blobs first:
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) { return a.time < b.time; });
+    for (const auto& entry : entries) {
+        if (total <= _desc.maxDiskSize) {
+            break;
+        }
+        fs::remove(entry.path, ec);
+        total -= entry.size;
+    }
+}
+
+} // namespace nv
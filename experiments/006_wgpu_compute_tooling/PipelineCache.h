@@ -0,0 +1,116 @@
+#ifndef NV_PIPELINECACHE_H_
+#define NV_PIPELINECACHE_H_
+
+#include <ContentHash.h>
+
+#include <mutex>
+
+namespace nv {
+
+struct PipelineCacheDesc {
+    /** Folder for the compiled blobs (disk cache disabled if empty). */
+    String cacheDir{"pipeline_cache"};
+
+    /** Max total size of the blobs kept on disk (0 for no limit). */
+    U64 maxDiskSize{256ULL * 1024 * 1024};
+};
+
+struct ComputePipelineKey {
+    /** Shader file (only used for logging). */
+    String shaderFile;
+
+    /** Preprocessed WGSL source. */
+    String source;
+
+    /** Defines used to preprocess the source. */
+    StringVector defs;
+
+    /** Entry point of the compute shader. */
+    String entryPoint{"main"};
+
+    /** Optional precomputed content hash of (source, defs), 0 to compute
+    it from the fields above. */
+    U64 contentHash{0};
+};
+
+/**
+ * Compute pipeline cache: pipelines are deduplicated in memory with a key
+ * built from the hash of the preprocessed source, the defines and the
+ * adapter identity. The compiled backend blobs are persisted on disk through
+ * the Dawn cache callbacks (cf. setup_device_cache(), to be chained to the
+ * device descriptor), so a cold start doesn't recompile the shaders seen in a
+ * previous run.
+ */
+class NVGPU_EXPORT PipelineCache : public RefObject {
+  public:
+    explicit PipelineCache(const PipelineCacheDesc& desc);
+    ~PipelineCache() override;
+
+    static auto create(const PipelineCacheDesc& desc = {})
+        -> RefPtr<PipelineCache>;
+
+    /** Get a compute pipeline, creating it on the first request. */
+    auto get_compute_pipeline(const ComputePipelineKey& key)
+        -> wgpu::ComputePipeline;
+
+    /** Create a compute pipeline on a device (without caching it in
+    memory), throws if the shader or pipeline is invalid. */
+    static auto create_compute_pipeline(const wgpu::Device& device,
+                                        const ComputePipelineKey& key)
+        -> wgpu::ComputePipeline;
+
+    /** Find a pipeline in the memory cache (null if not found). */
+    auto find_compute_pipeline(U64 key) -> wgpu::ComputePipeline;
+
+    /** Add a pipeline created elsewhere (eg. asynchronously). */
+    void add_compute_pipeline(U64 key, wgpu::ComputePipeline pipeline) {
+        _pipelines[key] = std::move(pipeline);
+    }
+
+    /** Compute the cache key of a pipeline for the current adapter. */
+    static auto get_key(const ComputePipelineKey& key) -> U64;
+
+    /** Get a string identifying the current adapter (vendor, device and
+    backend). */
+    static auto get_adapter_key() -> String;
+
+    /** Fill the Dawn cache descriptor so that the device stores and loads
+    its compiled blobs with this cache. */
+    void setup_device_cache(wgpu::DawnCacheDeviceDescriptor& desc);
+
+    /** Load a blob from disk (same semantic as the Dawn load callback:
+    returns the blob size if value is null). */
+    auto load_blob(const void* key, size_t keySize, void* value,
+                   size_t valueSize) -> size_t;
+
+    /** Store a blob on disk. */
+    void store_blob(const void* key, size_t keySize, const void* value,
+                    size_t valueSize);
+
+    /** Remove all the pipelines from the memory cache. */
+    void clear() { _pipelines.clear(); }
+
+    auto get_num_hits() const -> U32 { return _numHits; }
+    auto get_num_misses() const -> U32 { return _numMisses; }
+    auto get_num_blob_hits() const -> U32 { return _numBlobHits; }
+    auto get_num_blob_stores() const -> U32 { return _numBlobStores; }
+
+  protected:
+    PipelineCacheDesc _desc;
+    std::map<U64, wgpu::ComputePipeline> _pipelines;
+    std::mutex _blobMutex;
+    U32 _numHits{0};
+    U32 _numMisses{0};
+    U32 _numBlobHits{0};
+    U32 _numBlobStores{0};
+
+    /** Get the file of a blob key. */
+    auto get_blob_file(const void* key, size_t keySize) const -> String;
+
+    /** Remove the oldest blobs when the disk cache is too large. */
+    void trim_disk_cache();
+};
+
+} // namespace nv
+
+#endif
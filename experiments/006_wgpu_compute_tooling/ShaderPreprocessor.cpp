@@ -0,0 +1,682 @@
+#include <ShaderPreprocessor.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace nv {
+
+static auto trim(const String& str) -> String {
+    size_t start = str.find_first_not_of(" \t\r");
+    if (start == String::npos) {
+        return {};
+    }
+    size_t end = str.find_last_not_of(" \t\r");
+    return str.substr(start, end - start + 1);
+}
+
+static auto is_ident_start(char c) -> bool {
+    return std::isalpha((U8)c) != 0 || c == '_';
+}
+
+static auto is_ident_char(char c) -> bool {
+    return std::isalnum((U8)c) != 0 || c == '_';
+}
+
+/** Split a macro head "NAME" or "NAME(a, b)" into name and parameters. */
+static auto parse_macro_head(const String& head, String& name,
+                             StringVector& params) -> bool {
+    size_t pos = head.find('(');
+    name = trim(head.substr(0, pos));
+    if (pos == String::npos) {
+        return false;
+    }
+
+    size_t end = head.find(')', pos);
+    NVCHK(end != String::npos, "ShaderPreprocessor: invalid macro {}", head);
+    std::istringstream is(head.substr(pos + 1, end - pos - 1));
+    String param;
+    while (std::getline(is, param, ',')) {
+        param = trim(param);
+        if (!param.empty()) {
+            params.push_back(param);
+        }
+    }
+    return true;
+}
+
+namespace {
+
+/** Recursive descent evaluation of an expanded #if expression: integers,
+with the C operators !, -, ==, !=, <, <=, >, >=, && and || and parentheses.
+Undefined identifiers evaluate to 0 as in C, anything else is rejected. */
+class ConditionParser {
+  public:
+    explicit ConditionParser(const String& text) : _text(text) {}
+
+    auto parse() -> I64 {
+        I64 res = parse_or();
+        skip_spaces();
+        if (_pos != _text.size()) {
+            fail();
+        }
+        return res;
+    }
+
+  private:
+    const String& _text;
+    size_t _pos{0};
+
+    void fail() const {
+        THROW_MSG("ShaderPreprocessor: unsupported #if expression '{}'",
+                  _text);
+    }
+
+    void skip_spaces() {
+        while (_pos < _text.size() && std::isspace((U8)_text[_pos]) != 0) {
+            ++_pos;
+        }
+    }
+
+    auto accept(const String& op) -> bool {
+        skip_spaces();
+        if (_text.compare(_pos, op.size(), op) != 0) {
+            return false;
+        }
+        _pos += op.size();
+        return true;
+    }
+
+    auto parse_or() -> I64 {
+        I64 res = parse_and();
+        while (accept("||")) {
+            I64 rhs = parse_and();
+            res = res != 0 || rhs != 0 ? 1 : 0;
+        }
+        return res;
+    }
+
+    auto parse_and() -> I64 {
+        I64 res = parse_equality();
+        while (accept("&&")) {
+            I64 rhs = parse_equality();
+            res = res != 0 && rhs != 0 ? 1 : 0;
+        }
+        return res;
+    }
+
+    auto parse_equality() -> I64 {
+        I64 res = parse_relational();
+        while (true) {
+            if (accept("==")) {
+                res = res == parse_relational() ? 1 : 0;
+            } else if (accept("!=")) {
+                res = res != parse_relational() ? 1 : 0;
+            } else {
+                return res;
+            }
+        }
+    }
+
+    auto parse_relational() -> I64 {
+        I64 res = parse_unary();
+        while (true) {
+            if (accept("<=")) {
+                res = res <= parse_unary() ? 1 : 0;
+            } else if (accept(">=")) {
+                res = res >= parse_unary() ? 1 : 0;
+            } else if (accept("<")) {
+                res = res < parse_unary() ? 1 : 0;
+            } else if (accept(">")) {
+                res = res > parse_unary() ? 1 : 0;
+            } else {
+                return res;
+            }
+        }
+    }
+
+    auto parse_unary() -> I64 {
+        if (accept("!")) {
+            return parse_unary() == 0 ? 1 : 0;
+        }
+        if (accept("-")) {
+            return -parse_unary();
+        }
+        return parse_primary();
+    }
+
+    auto parse_primary() -> I64 {
+        if (accept("(")) {
+            I64 res = parse_or();
+            if (!accept(")")) {
+                fail();
+            }
+            return res;
+        }
+
+        skip_spaces();
+        if (_pos < _text.size() && is_ident_start(_text[_pos])) {
+            while (_pos < _text.size() && is_ident_char(_text[_pos])) {
+                ++_pos;
+            }
+            return 0;
+        }
+        if (_pos >= _text.size() || std::isdigit((U8)_text[_pos]) == 0) {
+            fail();
+            return 0;
+        }
+
+        size_t len = 0;
+        I64 res = 0;
+        try {
+            res = std::stoll(_text.substr(_pos), &len, 0);
+        } catch (const std::exception&) {
+            fail();
+        }
+        _pos += len;
+        // WGSL integer suffixes:
+        if (_pos < _text.size() && (_text[_pos] == 'u' || _text[_pos] == 'i')) {
+            ++_pos;
+        }
+        if (_pos < _text.size() &&
+            (is_ident_char(_text[_pos]) || _text[_pos] == '.')) {
+            fail();
+        }
+        return res;
+    }
+};
+
+} // namespace
+
+ShaderPreprocessor::ShaderPreprocessor(const ShaderPreprocessorDesc& desc)
+    : _desc(desc){};
+
+ShaderPreprocessor::~ShaderPreprocessor() = default;
+
+auto ShaderPreprocessor::create(const ShaderPreprocessorDesc& desc)
+    -> RefPtr<ShaderPreprocessor> {
+    return nv::create<ShaderPreprocessor>(desc);
+}
+
+auto ShaderPreprocessor::tokenize(const String& text) -> TokenList {
+    TokenList tokens;
+    size_t i = 0;
+    size_t n = text.size();
+    while (i < n) {
+        size_t j = i + 1;
+        char c = text[i];
+        bool ident = is_ident_start(c);
+        if (ident) {
+            while (j < n && is_ident_char(text[j])) {
+                ++j;
+            }
+        } else if (std::isdigit((U8)c) != 0) {
+            // Keep the suffixes with the numbers (eg. 0x1Fu, 1.5f):
+            while (j < n && (is_ident_char(text[j]) || text[j] == '.')) {
+                ++j;
+            }
+        } else if (c == ' ' || c == '\t') {
+            while (j < n && (text[j] == ' ' || text[j] == '\t')) {
+                ++j;
+            }
+        }
+        tokens.push_back({text.substr(i, j - i), ident});
+        i = j;
+    }
+    return tokens;
+}
+
+auto ShaderPreprocessor::parse_define(const String& def)
+    -> std::pair<String, Macro> {
+    size_t pos = def.find('=');
+    Macro macro;
+    String name;
+    macro.function = parse_macro_head(def.substr(0, pos), name, macro.params);
+    NVCHK(!name.empty(), "ShaderPreprocessor: invalid define {}", def);
+
+    // Like "-DNAME", a define without value is 1:
+    macro.body = tokenize(pos == String::npos ? "1" : def.substr(pos + 1));
+    return {name, macro};
+}
+
+auto ShaderPreprocessor::resolve(const String& file, const String& fromDir)
+    -> String {
+    String name = file;
+    if (!_desc.extension.empty() &&
+        (name.size() < _desc.extension.size() ||
+         name.compare(name.size() - _desc.extension.size(),
+                      _desc.extension.size(), _desc.extension) != 0)) {
+        name += _desc.extension;
+    }
+
+    // The folder of the including file comes first:
+    Vector<fs::path> candidates;
+    if (!fromDir.empty()) {
+        candidates.emplace_back(fs::path(fromDir) / name);
+    }
+    for (const auto& dir : _desc.includeDirs) {
+        candidates.emplace_back(fs::path(dir) / name);
+    }
+    candidates.emplace_back(name);
+
+    for (const auto& path : candidates) {
+        std::error_code ec;
+        if (fs::is_regular_file(path, ec)) {
+            return fs::weakly_canonical(path).string();
+        }
+    }
+
+    THROW_MSG("ShaderPreprocessor: cannot find shader file {}", file);
+    return {};
+}
+
+auto ShaderPreprocessor::parse_file(const String& path) -> ParsedFilePtr {
+    std::ifstream is(path, std::ios::binary);
+    NVCHK(is.is_open(), "ShaderPreprocessor: cannot open {}", path);
+    std::ostringstream content;
+    content << is.rdbuf();
+
+    auto file = std::make_shared<ParsedFile>();
+    file->path = path;
+    file->hash = hash_string(content.str());
+    file->mtime = fs::last_write_time(path);
+
+    std::istringstream lines(content.str());
+    String line;
+    I32 depth = 0;
+    U32 lineNum = 0;
+    while (std::getline(lines, line)) {
+        ++lineNum;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+
+        String stripped = trim(line);
+        if (stripped.empty() || stripped[0] != '#') {
+            file->lines.push_back({.tokens = tokenize(line)});
+            continue;
+        }
+
+        size_t start = stripped.find_first_not_of(" \t", 1);
+        size_t end = start;
+        while (end < stripped.size() && is_ident_char(stripped[end])) {
+            ++end;
+        }
+        String word =
+            start == String::npos ? "" : stripped.substr(start, end - start);
+        String rest = end < stripped.size() ? trim(stripped.substr(end)) : "";
+
+        ParsedLine parsed;
+        if (word == "include") {
+            size_t open = rest.find_first_of("\"<");
+            size_t close = rest.find_first_of("\">", open + 1);
+            NVCHK(open != String::npos && close != String::npos,
+                  "ShaderPreprocessor: invalid include at {}:{}", path,
+                  lineNum);
+            parsed.type = LineType::Include;
+            parsed.arg = rest.substr(open + 1, close - open - 1);
+        } else if (word == "ifdef" || word == "ifndef") {
+            parsed.type = word == "ifdef" ? LineType::Ifdef : LineType::Ifndef;
+            parsed.arg = rest.substr(0, rest.find_first_of(" \t"));
+            depth++;
+        } else if (word == "if") {
+            parsed.type = LineType::If;
+            parsed.tokens = tokenize(rest);
+            depth++;
+        } else if (word == "else") {
+            NVCHK(depth > 0, "ShaderPreprocessor: #else without #if at {}:{}",
+                  path, lineNum);
+            parsed.type = LineType::Else;
+        } else if (word == "endif") {
+            NVCHK(depth > 0, "ShaderPreprocessor: #endif without #if at {}:{}",
+                  path, lineNum);
+            parsed.type = LineType::Endif;
+            depth--;
+        } else if (word == "define") {
+            // Split "NAME(a, b) body" into head and body:
+            size_t headEnd = 0;
+            while (headEnd < rest.size() && is_ident_char(rest[headEnd])) {
+                ++headEnd;
+            }
+            if (headEnd < rest.size() && rest[headEnd] == '(') {
+                headEnd = rest.find(')', headEnd);
+                NVCHK(headEnd != String::npos,
+                      "ShaderPreprocessor: invalid #define at {}:{}", path,
+                      lineNum);
+                headEnd++;
+            }
+            String body = trim(rest.substr(headEnd));
+            parsed.type = LineType::Define;
+            parsed.arg = rest.substr(0, headEnd);
+            parsed.tokens = tokenize(body.empty() ? "1" : body);
+        } else {
+            THROW_MSG("ShaderPreprocessor: unsupported directive '{}' at {}:{}",
+                      stripped, path, lineNum);
+        }
+        file->lines.push_back(std::move(parsed));
+    }
+
+    NVCHK(depth == 0, "ShaderPreprocessor: missing #endif in {}", path);
+    _numParses++;
+    return file;
+}
+
+auto ShaderPreprocessor::get_file(const String& path) -> ParsedFilePtr {
+    auto it = _files.find(path);
+    if (it != _files.end()) {
+        return it->second;
+    }
+
+    auto file = parse_file(path);
+    _files[path] = file;
+    return file;
+}
+
+void ShaderPreprocessor::expand_tokens(const TokenList& tokens,
+                                       const MacroMap& macros,
+                                       std::set<String>& active, String& out) {
+    size_t n = tokens.size();
+    for (size_t i = 0; i < n; ++i) {
+        const auto& tok = tokens[i];
+        auto it = tok.ident && active.count(tok.text) == 0
+                      ? macros.find(tok.text)
+                      : macros.end();
+        if (it == macros.end()) {
+            out += tok.text;
+            continue;
+        }
+
+        const Macro& macro = it->second;
+        if (!macro.function) {
+            active.insert(tok.text);
+            expand_tokens(macro.body, macros, active, out);
+            active.erase(tok.text);
+            continue;
+        }
+
+        // Function-like macros are only expanded when called:
+        size_t j = i + 1;
+        while (j < n && (tokens[j].text[0] == ' ' || tokens[j].text[0] == '\t')) {
+            ++j;
+        }
+        if (j >= n || tokens[j].text != "(") {
+            out += tok.text;
+            continue;
+        }
+
+        Vector<TokenList> args(1);
+        I32 depth = 0;
+        for (++j; j < n; ++j) {
+            const auto& t = tokens[j].text;
+            if (t == ")" && depth == 0) {
+                break;
+            }
+            if (t == "," && depth == 0) {
+                args.emplace_back();
+                continue;
+            }
+            depth += t == "(" ? 1 : (t == ")" ? -1 : 0);
+            args.back().push_back(tokens[j]);
+        }
+        NVCHK(j < n, "ShaderPreprocessor: unterminated call to {}", tok.text);
+        if (macro.params.empty() && args.size() == 1 && args[0].empty()) {
+            args.clear();
+        }
+        NVCHK(args.size() == macro.params.size(),
+              "ShaderPreprocessor: {} expects {} arguments, got {}", tok.text,
+              macro.params.size(), args.size());
+
+        TokenList body;
+        for (const auto& bt : macro.body) {
+            auto pit = bt.ident ? std::find(macro.params.begin(),
+                                            macro.params.end(), bt.text)
+                                : macro.params.end();
+            if (pit == macro.params.end()) {
+                body.push_back(bt);
+            } else {
+                const auto& arg = args[pit - macro.params.begin()];
+                body.insert(body.end(), arg.begin(), arg.end());
+            }
+        }
+
+        active.insert(tok.text);
+        expand_tokens(body, macros, active, out);
+        active.erase(tok.text);
+        i = j;
+    }
+}
+
+auto ShaderPreprocessor::eval_condition(const TokenList& expr,
+                                        const MacroMap& macros) -> bool {
+    // Replace defined(NAME) and "defined NAME" before expanding the macros:
+    String text;
+    for (size_t i = 0; i < expr.size(); ++i) {
+        if (expr[i].text != "defined") {
+            text += expr[i].text;
+            continue;
+        }
+        bool paren = false;
+        String name;
+        for (++i; i < expr.size() && name.empty(); ++i) {
+            if (expr[i].ident) {
+                name = expr[i].text;
+                break;
+            }
+            if (expr[i].text == "(") {
+                paren = true;
+            } else if (trim(expr[i].text).empty()) {
+                continue;
+            } else {
+                break;
+            }
+        }
+        NVCHK(!name.empty(), "ShaderPreprocessor: invalid defined() in #if.");
+        if (paren) {
+            while (i < expr.size() && expr[i].text != ")") {
+                ++i;
+            }
+        }
+        text += macros.count(name) != 0 ? " 1 " : " 0 ";
+    }
+
+    std::set<String> active;
+    String value;
+    expand_tokens(tokenize(text), macros, active, value);
+    return ConditionParser(value).parse() != 0;
+}
+
+void ShaderPreprocessor::expand_file(const String& path, ExpandState& state) {
+    if (!state.included.insert(path).second) {
+        return;
+    }
+
+    auto file = get_file(path);
+    state.result->dependencies.push_back(path);
+    String dir = fs::path(path).parent_path().string();
+
+    // Each entry holds the enclosing active state and the branch condition:
+    Vector<std::pair<bool, bool>> conds;
+    bool active = true;
+    std::set<String> expanding;
+
+    for (const auto& line : file->lines) {
+        switch (line.type) {
+        case LineType::Ifdef:
+        case LineType::Ifndef:
+        case LineType::If: {
+            bool cond = false;
+            if (active) {
+                cond = line.type == LineType::If
+                           ? eval_condition(line.tokens, state.macros)
+                           : (state.macros.count(line.arg) != 0) ==
+                                 (line.type == LineType::Ifdef);
+            }
+            conds.emplace_back(active, cond);
+            active = active && cond;
+            break;
+        }
+        case LineType::Else:
+            active = conds.back().first && !conds.back().second;
+            break;
+        case LineType::Endif:
+            active = conds.back().first;
+            conds.pop_back();
+            break;
+        case LineType::Include:
+            if (active) {
+                expand_file(resolve(line.arg, dir), state);
+            }
+            break;
+        case LineType::Define:
+            if (active) {
+                Macro macro;
+                String name;
+                macro.function = parse_macro_head(line.arg, name, macro.params);
+                macro.body = line.tokens;
+                state.macros[name] = std::move(macro);
+            }
+            break;
+        case LineType::Text:
+            if (active) {
+                expand_tokens(line.tokens, state.macros, expanding,
+                              state.result->source);
+                state.result->source += '\n';
+            }
+            break;
+        }
+    }
+}
+
+auto ShaderPreprocessor::preprocess(const String& file, const StringVector& defs)
+    -> PreprocessedShaderPtr {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    String path = resolve(file, "");
+    String key = path;
+    for (const auto& def : defs) {
+        key += "\n" + def;
+    }
+
+    auto it = _variants.find(key);
+    if (it != _variants.end()) {
+        return it->second;
+    }
+
+    auto res = std::make_shared<PreprocessedShader>();
+    ExpandState state;
+    state.result = res.get();
+    for (const auto& def : defs) {
+        auto macro = parse_define(def);
+        state.macros[macro.first] = std::move(macro.second);
+    }
+
+    expand_file(path, state);
+    res->contentHash = hash_string(res->source);
+    _numExpansions++;
+
+    for (const auto& dep : res->dependencies) {
+        _dependents[dep].insert(key);
+    }
+    _variants[key] = res;
+    return res;
+}
+
+auto ShaderPreprocessor::get_pipeline_key(const String& file,
+                                          const StringVector& defs,
+                                          const String& entryPoint)
+    -> ComputePipelineKey {
+    auto shader = preprocess(file, defs);
+    return {.shaderFile = file,
+            .source = shader->source,
+            .defs = defs,
+            .entryPoint = entryPoint,
+            .contentHash = shader->contentHash};
+}
+
+auto ShaderPreprocessor::drop_variants(const String& path) -> U32 {
+    auto it = _dependents.find(path);
+    if (it == _dependents.end()) {
+        return 0;
+    }
+
+    U32 count = 0;
+    for (const auto& key : it->second) {
+        count += _variants.erase(key);
+    }
+    _dependents.erase(it);
+    return count;
+}
+
+auto ShaderPreprocessor::reload_file(const String& path) -> U32 {
+    auto it = _files.find(path);
+    if (it == _files.end()) {
+        return 0;
+    }
+    U64 prevHash = it->second->hash;
+    _files.erase(it);
+
+    std::error_code ec;
+    if (!fs::is_regular_file(path, ec)) {
+        return drop_variants(path);
+    }
+
+    try {
+        auto file = parse_file(path);
+        _files[path] = file;
+        if (file->hash == prevHash) {
+            // Only touched: the variants are still valid.
+            return 0;
+        }
+    } catch (const std::exception& e) {
+        // The error is reported again by the next preprocess() call.
+        logWARN("ShaderPreprocessor: cannot reload {}: {}", path, e.what());
+    }
+
+    U32 count = drop_variants(path);
+    logDEBUG("ShaderPreprocessor: {} changed, dropped {} variants", path,
+             count);
+    return count;
+}
+
+auto ShaderPreprocessor::invalidate_file(const String& path) -> U32 {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return reload_file(fs::weakly_canonical(path).string());
+}
+
+auto ShaderPreprocessor::check_for_changes() -> U32 {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    StringVector changed;
+    for (const auto& [path, file] : _files) {
+        std::error_code ec;
+        auto mtime = fs::last_write_time(path, ec);
+        if (ec || mtime != file->mtime) {
+            changed.push_back(path);
+        }
+    }
+
+    U32 count = 0;
+    for (const auto& path : changed) {
+        count += reload_file(path);
+    }
+    return count;
+}
+
+auto ShaderPreprocessor::get_dependents(const String& path) -> StringVector {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::set<String> roots;
+    auto it = _dependents.find(fs::weakly_canonical(path).string());
+    if (it != _dependents.end()) {
+        for (const auto& key : it->second) {
+            if (_variants.count(key) != 0) {
+                roots.insert(key.substr(0, key.find('\n')));
+            }
+        }
+    }
+    return {roots.begin(), roots.end()};
+}
+
+} // namespace nv
@@ -0,0 +1,162 @@
+#ifndef NV_SHADERPREPROCESSOR_H_
+#define NV_SHADERPREPROCESSOR_H_
+
+#include <PipelineCache.h>
+
+#include <filesystem>
+#include <memory>
+#include <set>
+
+namespace nv {
+
+struct ShaderPreprocessorDesc {
+    /** Root folders searched for the shader files and includes (in order,
+    after the folder of the including file). */
+    StringVector includeDirs;
+
+    /** Extension appended to the file names. */
+    String extension{".wgsl"};
+};
+
+struct PreprocessedShader {
+    /** Fully expanded WGSL source. */
+    String source;
+
+    /** Stable hash of the expanded source (usable as
+    ComputePipelineKey::contentHash). */
+    U64 contentHash{0};
+
+    /** Files used in the expansion (root file first). */
+    StringVector dependencies;
+};
+
+using PreprocessedShaderPtr = std::shared_ptr<const PreprocessedShader>;
+
+/**
+ * WGSL preprocessor supporting #include, #ifdef/#ifndef/#if/#else/#endif,
+ * #define, and the "NAME=value" or function-like "NAME(a,b)=body" defines.
+ * #if takes C integer expressions (defined(), !, comparisons, && and ||).
+ * Each file is tokenized once and the token streams are memoized, then each
+ * (file, defines) variant is expanded once and cached with its dependencies:
+ * when a file changes (cf. check_for_changes()), only the variants
+ * including it are expanded again. Each included file is only expanded once
+ * per variant. Thread safe.
+ */
+class NVGPU_EXPORT ShaderPreprocessor : public RefObject {
+  public:
+    explicit ShaderPreprocessor(const ShaderPreprocessorDesc& desc);
+    ~ShaderPreprocessor() override;
+
+    static auto create(const ShaderPreprocessorDesc& desc)
+        -> RefPtr<ShaderPreprocessor>;
+
+    /** Get the expanded variant of a shader file. */
+    auto preprocess(const String& file, const StringVector& defs = {})
+        -> PreprocessedShaderPtr;
+
+    /** Get the pipeline cache key of a variant (with its content hash). */
+    auto get_pipeline_key(const String& file, const StringVector& defs = {},
+                          const String& entryPoint = "main")
+        -> ComputePipelineKey;
+
+    /** Check the modification time of all the parsed files, and drop the
+    variants depending on the modified ones. Returns the number of dropped
+    variants. */
+    auto check_for_changes() -> U32;
+
+    /** Force reloading a file (absolute or resolved path). Returns the
+    number of dropped variants. */
+    auto invalidate_file(const String& path) -> U32;
+
+    /** Get the root files of the cached variants depending on a file. */
+    auto get_dependents(const String& path) -> StringVector;
+
+    /** Number of file tokenizations so far. */
+    auto get_num_parses() const -> U32 { return _numParses; }
+
+    /** Number of variant expansions so far. */
+    auto get_num_expansions() const -> U32 { return _numExpansions; }
+
+  protected:
+    struct Token {
+        String text;
+        bool ident{false};
+    };
+    using TokenList = Vector<Token>;
+
+    enum class LineType : U8 {
+        Text,
+        Include,
+        Ifdef,
+        Ifndef,
+        If,
+        Else,
+        Endif,
+        Define,
+    };
+
+    struct ParsedLine {
+        LineType type{LineType::Text};
+
+        /** Include path, or define/condition name. */
+        String arg;
+
+        /** Text tokens, #if expression or define body. */
+        TokenList tokens;
+    };
+
+    struct ParsedFile {
+        String path;
+        U64 hash{0};
+        std::filesystem::file_time_type mtime;
+        Vector<ParsedLine> lines;
+    };
+    using ParsedFilePtr = std::shared_ptr<const ParsedFile>;
+
+    struct Macro {
+        StringVector params;
+        TokenList body;
+        bool function{false};
+    };
+    using MacroMap = std::map<String, Macro>;
+
+    struct ExpandState {
+        MacroMap macros;
+        std::set<String> included;
+        PreprocessedShader* result{nullptr};
+    };
+
+    ShaderPreprocessorDesc _desc;
+    std::mutex _mutex;
+
+    /** Memoized token streams per resolved path. */
+    std::map<String, ParsedFilePtr> _files;
+
+    /** Expanded variants per (file, defines) key. */
+    std::map<String, PreprocessedShaderPtr> _variants;
+
+    /** Variant keys using each resolved path. */
+    std::map<String, std::set<String>> _dependents;
+
+    U32 _numParses{0};
+    U32 _numExpansions{0};
+
+    auto resolve(const String& file, const String& fromDir) -> String;
+    auto get_file(const String& path) -> ParsedFilePtr;
+    auto parse_file(const String& path) -> ParsedFilePtr;
+    auto reload_file(const String& path) -> U32;
+    auto drop_variants(const String& path) -> U32;
+
+    void expand_file(const String& path, ExpandState& state);
+    void expand_tokens(const TokenList& tokens, const MacroMap& macros,
+                       std::set<String>& active, String& out);
+    auto eval_condition(const TokenList& expr, const MacroMap& macros)
+        -> bool;
+
+    static auto tokenize(const String& text) -> TokenList;
+    static auto parse_define(const String& def) -> std::pair<String, Macro>;
+};
+
+} // namespace nv
+
+#endif
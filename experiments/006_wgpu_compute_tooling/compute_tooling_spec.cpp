@@ -0,0 +1,456 @@
+#include <nv_tests_framework.h>
+
+#include <AsyncPipelineLoader.h>
+#include <ComputeDispatchCache.h>
+#include <GPUPrefixSum.h>
+#include <GPUProfiler.h>
+#include <GPURandomFill.h>
+#include <GPUReducer.h>
+#include <PipelineCache.h>
+#include <ShaderPreprocessor.h>
+#include <WGPUEngine.h>
+#include <filesystem>
+#include <fstream>
+
+using namespace nv;
+using namespace wgpu;
+
+BOOST_AUTO_TEST_SUITE(compute_tooling)
+
+BOOST_AUTO_TEST_CASE(test_gpu_profiler) {
+    if (!GPUProfiler::is_supported()) {
+        logWARN("Timestamp queries not supported, skipping test.");
+        return;
+    }
+
+    auto* eng = WGPUEngine::instance();
+
+    U32 num = 1 << 24;
+    GPUBuffer input(num * sizeof(U32), BufferUsage::Storage);
+    GPUBuffer output(num * sizeof(U32), BufferUsage::Storage);
+    GPURandomFill::create({.output = &input, .count = num, .maxInt = 4})
+        ->execute();
+
+    auto reducer = GPUReducer::create({.input = &input, .count = num});
+    auto scan = GPUPrefixSum::create({.input = &input,
+                                      .output = &output,
+                                      .count = num,
+                                      .maxTotal = (U64)num * 4});
+
+    auto profiler = GPUProfiler::create({});
+    auto& bld = eng->build_commands();
+
+    U32 numFrames = 100;
+    for (U32 i = 0; i < numFrames; ++i) {
+        profiler->begin_frame();
+        {
+            GPUProfileScope frameScope(*profiler, "frame");
+            {
+                GPUProfileScope scope(*profiler, "reduce");
+                bld.execute_compute_pass(reducer->get_compute_pass());
+            }
+            {
+                GPUProfileScope scope(*profiler, "scan");
+                bld.execute_compute_pass(scan->get_compute_pass());
+            }
+        }
+        profiler->end_frame();
+    }
+
+    eng->wait_idle();
+    profiler->collect();
+    profiler->log_report();
+
+    // Nested scopes are identified by their path:
+    auto frame = profiler->get_scope_stats("frame");
+    auto reduce = profiler->get_scope_stats("frame/reduce");
+    auto scanStats = profiler->get_scope_stats("frame/scan");
+    BOOST_CHECK_EQUAL(reduce.depth, 1);
+    BOOST_CHECK_EQUAL(frame.numSamples + profiler->get_num_dropped_frames(),
+                      numFrames);
+    BOOST_CHECK_GT(reduce.numSamples, 0);
+    BOOST_CHECK_GT(scanStats.medianNs, 0.0);
+    BOOST_CHECK_LE(reduce.minNs, reduce.medianNs);
+    BOOST_CHECK_LE(reduce.medianNs, reduce.p99Ns);
+    BOOST_CHECK_GE(frame.medianNs, scanStats.medianNs);
+
+    // Scopes written in the caller's encoder (no extra submit):
+    BufferDescriptor copyDesc{.usage = BufferUsage::CopySrc |
+                                       BufferUsage::CopyDst,
+                              .size = (U64)num * sizeof(U32)};
+    Buffer src = eng->get_device().CreateBuffer(&copyDesc);
+    Buffer dst = eng->get_device().CreateBuffer(&copyDesc);
+    for (U32 i = 0; i < numFrames; ++i) {
+        profiler->begin_frame();
+        CommandEncoder encoder = eng->get_device().CreateCommandEncoder();
+        {
+            GPUProfileScope scope(*profiler, "copy", encoder);
+            encoder.CopyBufferToBuffer(src, 0, dst, 0, copyDesc.size);
+        }
+        CommandBuffer commands = encoder.Finish();
+        eng->get_queue().Submit(1, &commands);
+        profiler->end_frame();
+    }
+
+    eng->wait_idle();
+    profiler->collect();
+    auto copy = profiler->get_scope_stats("copy");
+    BOOST_CHECK_EQUAL(copy.depth, 0);
+    BOOST_CHECK_GT(copy.numSamples, 0);
+    BOOST_CHECK_GT(copy.medianNs, 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(test_pipeline_cache) {
+    auto cache = PipelineCache::create({.cacheDir = "test_pipeline_cache"});
+
+    String source = "@group(0) @binding(0) var<storage,read_write> data: "
+                    "array<u32>;\n"
+                    "@compute @workgroup_size(64)\n"
+                    "fn main(@builtin(global_invocation_id) id: vec3<u32>) {\n"
+                    "    data[id.x] += 1u;\n"
+                    "}\n";
+
+    ComputePipelineKey key{.shaderFile = "inline_add", .source = source};
+    auto p0 = cache->get_compute_pipeline(key);
+    auto p1 = cache->get_compute_pipeline(key);
+    BOOST_CHECK(p0.Get() == p1.Get());
+    BOOST_CHECK_EQUAL(cache->get_num_misses(), 1);
+    BOOST_CHECK_EQUAL(cache->get_num_hits(), 1);
+
+    // The defines are part of the key:
+    key.defs = {"WG_SIZE=64"};
+    auto p2 = cache->get_compute_pipeline(key);
+    BOOST_CHECK(p2.Get() != p0.Get());
+    BOOST_CHECK_EQUAL(cache->get_num_misses(), 2);
+
+    // The keys are stable:
+    BOOST_CHECK_EQUAL(PipelineCache::get_key(key), PipelineCache::get_key(key));
+
+    // Disk blob round trip, with the Dawn callback semantic:
+    const char blobKey[] = "some backend key";
+    Vector<U8> blob(1000);
+    for (U32 i = 0; i < blob.size(); ++i) {
+        blob[i] = (U8)(i * 7);
+    }
+    cache->store_blob(blobKey, sizeof(blobKey), blob.data(), blob.size());
+
+    auto cache2 = PipelineCache::create({.cacheDir = "test_pipeline_cache"});
+    BOOST_CHECK_EQUAL(cache2->load_blob(blobKey, sizeof(blobKey), nullptr, 0),
+                      blob.size());
+    Vector<U8> loaded(blob.size());
+    BOOST_CHECK_EQUAL(cache2->load_blob(blobKey, sizeof(blobKey),
+                                        loaded.data(), loaded.size()),
+                      blob.size());
+    BOOST_CHECK(loaded == blob);
+    BOOST_CHECK_EQUAL(cache2->get_num_blob_hits(), 1);
+
+    // Unknown keys are cache misses:
+    const char otherKey[] = "other key";
+    BOOST_CHECK_EQUAL(cache2->load_blob(otherKey, sizeof(otherKey), nullptr, 0),
+                      0);
+
+    // Invalid shaders are reported by the error scope:
+    BOOST_CHECK_THROW(cache->get_compute_pipeline(
+                          {.shaderFile = "invalid", .source = "fn main( {"}),
+                      std::exception);
+
+    std::filesystem::remove_all("test_pipeline_cache");
+}
+
+BOOST_AUTO_TEST_CASE(test_pipeline_cache_device) {
+    auto* eng = WGPUEngine::instance();
+    std::filesystem::remove_all("test_device_cache");
+
+    ComputePipelineKey key{
+        .shaderFile = "inline_mul",
+        .source = "@group(0) @binding(0) var<storage,read_write> data: "
+                  "array<u32>;\n"
+                  "@compute @workgroup_size(128)\n"
+                  "fn main(@builtin(global_invocation_id) id: vec3<u32>) {\n"
+                  "    data[id.x] *= 3u;\n"
+                  "}\n"};
+
+    // Each device gets the Dawn cache callbacks chained to its descriptor,
+    // so the second device loads the blobs stored by the first one:
+    auto create_pipeline = [&](PipelineCache& cache) {
+        DawnCacheDeviceDescriptor cacheDesc{};
+        cache.setup_device_cache(cacheDesc);
+        DeviceDescriptor devDesc{.nextInChain = &cacheDesc,
+                                 .label = "pipeline_cache_device"};
+        Device device = eng->get_adapter().CreateDevice(&devDesc);
+        BOOST_REQUIRE(device != nullptr);
+        auto pipeline = PipelineCache::create_compute_pipeline(device, key);
+        BOOST_CHECK(pipeline != nullptr);
+    };
+
+    auto cache = PipelineCache::create({.cacheDir = "test_device_cache"});
+    create_pipeline(*cache);
+    if (cache->get_num_blob_stores() == 0) {
+        logWARN("Backend doesn't store pipeline blobs, skipping test.");
+        std::filesystem::remove_all("test_device_cache");
+        return;
+    }
+    BOOST_CHECK_EQUAL(cache->get_num_blob_hits(), 0);
+
+    auto cache2 = PipelineCache::create({.cacheDir = "test_device_cache"});
+    create_pipeline(*cache2);
+    BOOST_CHECK_GT(cache2->get_num_blob_hits(), 0);
+
+    std::filesystem::remove_all("test_device_cache");
+}
+
+BOOST_AUTO_TEST_CASE(test_async_pipeline_loader) {
+    auto cache = PipelineCache::create({.cacheDir = "test_async_cache"});
+    auto loader = AsyncPipelineLoader::create({.numThreads = 4, .cache = cache});
+
+    auto make_source = [](U32 wgSize) {
+        return "@group(0) @binding(0) var<storage,read_write> data: "
+               "array<u32>;\n"
+               "@compute @workgroup_size(" +
+               std::to_string(wgSize) +
+               ")\n"
+               "fn main(@builtin(global_invocation_id) id: vec3<u32>) {\n"
+               "    data[id.x] += 1u;\n"
+               "}\n";
+    };
+
+    Vector<std::shared_future<ComputePipeline>> futures;
+    for (U32 wgSize : {32U, 64U, 128U, 256U}) {
+        futures.push_back(loader->request_compute_pipeline(
+            {.label = "inline_add",
+             .source = [=]() { return make_source(wgSize); },
+             .defs = {"WG_SIZE=" + std::to_string(wgSize)}}));
+    }
+
+    loader->wait_all();
+    BOOST_CHECK_EQUAL(loader->get_num_pending(), 0);
+    for (auto& future : futures) {
+        BOOST_CHECK(future.get() != nullptr);
+    }
+
+    // Identical requests are served from the cache, with the first pipeline
+    // used as a placeholder until then:
+    auto again = loader->request_compute_pipeline(
+        {.label = "inline_add",
+         .source = [=]() { return make_source(64); },
+         .defs = {"WG_SIZE=64"}});
+    AsyncPipeline<ComputePipeline> slot(again, futures[0].get());
+    BOOST_CHECK(slot.get().Get() == futures[0].get().Get());
+    loader->wait_all();
+    BOOST_CHECK(slot.is_ready());
+    BOOST_CHECK(slot.get().Get() == futures[1].get().Get());
+    BOOST_CHECK_EQUAL(cache->get_num_hits(), 1);
+
+    // Preprocessing errors resolve to a null pipeline:
+    auto failed = loader->request_compute_pipeline(
+        {.label = "failing",
+         .source = []() -> String { THROW_MSG("Missing include"); }});
+    loader->wait_all();
+    BOOST_CHECK(failed.get() == nullptr);
+
+    std::filesystem::remove_all("test_async_cache");
+}
+
+BOOST_AUTO_TEST_CASE(test_shader_preprocessor) {
+    namespace fs = std::filesystem;
+    fs::path dir = "test_shader_preprocessor";
+    fs::create_directories(dir / "base");
+
+    auto write_file = [&](const String& name, const String& content) {
+        std::ofstream(dir / name) << content;
+    };
+    write_file("base/common.wgsl", "const kOne: u32 = 1u;\n");
+    write_file("base/scan.wgsl", "#include \"base/common\"\n"
+                                 "var<workgroup> sdata: array<u32, WG_SIZE>;\n");
+    write_file("scan.wgsl", "#include \"base/scan\"\n"
+                            "#include \"base/common\"\n"
+                            "#ifdef EXCLUSIVE\n"
+                            "const kExclusive = true;\n"
+                            "#else\n"
+                            "const kExclusive = false;\n"
+                            "#endif\n"
+                            "#if 0\n"
+                            "disabled code\n"
+                            "#endif\n"
+                            "let a = OFFSET(ai) + OFFSET(bi + 1);\n");
+    write_file("other.wgsl", "#include \"base/common\"\n"
+                             "let b = kOne;\n");
+
+    auto pre = ShaderPreprocessor::create({.includeDirs = {dir.string()}});
+    StringVector defs = {"WG_SIZE=64", "OFFSET(x)=((x) >> 4)"};
+    auto scan = pre->preprocess("scan", defs);
+    BOOST_CHECK(scan->source.find("array<u32, 64>") != String::npos);
+    BOOST_CHECK(scan->source.find("((ai) >> 4) + ((bi + 1) >> 4)") !=
+                String::npos);
+    BOOST_CHECK(scan->source.find("kExclusive = false") != String::npos);
+    BOOST_CHECK(scan->source.find("disabled") == String::npos);
+    BOOST_CHECK_EQUAL(scan->dependencies.size(), 3);
+
+    // Each included file is expanded once:
+    auto pos = scan->source.find("kOne");
+    BOOST_CHECK(scan->source.find("kOne", pos + 1) == String::npos);
+
+    auto excl = pre->preprocess("scan", {"WG_SIZE=64", "OFFSET(x)=((x) >> 4)",
+                                         "EXCLUSIVE"});
+    BOOST_CHECK(excl->source.find("kExclusive = true") != String::npos);
+    BOOST_CHECK_NE(excl->contentHash, scan->contentHash);
+    auto other = pre->preprocess("other");
+
+    // The files are parsed once, and the variants are memoized:
+    BOOST_CHECK_EQUAL(pre->get_num_parses(), 4);
+    BOOST_CHECK(pre->preprocess("scan", defs) == scan);
+    BOOST_CHECK_EQUAL(pre->get_num_expansions(), 3);
+
+    // The hash is the pipeline cache key:
+    auto key = pre->get_pipeline_key("scan", defs);
+    BOOST_CHECK_EQUAL(key.contentHash, scan->contentHash);
+    BOOST_CHECK_EQUAL(key.source, scan->source);
+
+    // Touching a file without changing it keeps the variants:
+    BOOST_CHECK_EQUAL(pre->invalidate_file((dir / "base/scan.wgsl").string()),
+                      0);
+
+    // Changing a base file only drops its dependent variants:
+    BOOST_CHECK_EQUAL(pre->get_dependents((dir / "base/scan.wgsl").string())
+                          .size(),
+                      1);
+    write_file("base/scan.wgsl", "#include \"base/common\"\n"
+                                 "var<workgroup> sdata: array<u32, WG_SIZE*2>;"
+                                 "\n");
+    BOOST_CHECK_EQUAL(pre->invalidate_file((dir / "base/scan.wgsl").string()),
+                      2);
+    BOOST_CHECK(pre->preprocess("other") == other);
+    auto scan2 = pre->preprocess("scan", defs);
+    BOOST_CHECK(scan2->source.find("array<u32, 64*2>") != String::npos);
+    BOOST_CHECK_NE(scan2->contentHash, scan->contentHash);
+    BOOST_CHECK_EQUAL(pre->get_num_expansions(), 4);
+
+    // #if expressions and local #define:
+    write_file("cond.wgsl", "#define LOCAL_N 3\n"
+                            "#if defined(A) || defined(B)\n"
+                            "const kAorB = true;\n"
+                            "#endif\n"
+                            "#if defined A && defined B\n"
+                            "const kAandB = true;\n"
+                            "#endif\n"
+                            "#if X == 3\n"
+                            "const kX = 3;\n"
+                            "#else\n"
+                            "const kX = 0;\n"
+                            "#endif\n"
+                            "#if X >= 2 && !(X > 2) && LOCAL_N != 2\n"
+                            "const kX2 = true;\n"
+                            "#endif\n"
+                            "#if UNDEFINED_NAME\n"
+                            "const kUndefined = true;\n"
+                            "#endif\n");
+    auto cond = pre->preprocess("cond", {"B", "X=2"});
+    BOOST_CHECK(cond->source.find("kAorB") != String::npos);
+    BOOST_CHECK(cond->source.find("kAandB") == String::npos);
+    BOOST_CHECK(cond->source.find("kX = 0") != String::npos);
+    BOOST_CHECK(cond->source.find("kX2") != String::npos);
+    BOOST_CHECK(cond->source.find("kUndefined") == String::npos);
+    auto cond2 = pre->preprocess("cond", {"A", "B", "X=3"});
+    BOOST_CHECK(cond2->source.find("kAandB") != String::npos);
+    BOOST_CHECK(cond2->source.find("kX = 3") != String::npos);
+    BOOST_CHECK(cond2->source.find("kX2") == String::npos);
+
+    // Unsupported operators are rejected:
+    write_file("badcond.wgsl", "#if X + 1\n"
+                               "#endif\n");
+    BOOST_CHECK_THROW(pre->preprocess("badcond", {"X=2"}), std::exception);
+
+    fs::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_CASE(test_compute_dispatch_cache) {
+    auto* eng = WGPUEngine::instance();
+    auto device = eng->get_device();
+    auto cache = PipelineCache::create({.cacheDir = ""});
+    auto dcache = ComputeDispatchCache::create();
+
+    auto pipeline = cache->get_compute_pipeline(
+        {.shaderFile = "inline_add",
+         .source = "@group(0) @binding(0) var<storage,read_write> data: "
+                   "array<u32>;\n"
+                   "@compute @workgroup_size(64)\n"
+                   "fn main(@builtin(global_invocation_id) id: vec3<u32>) {\n"
+                   "    data[id.x] += 1u;\n"
+                   "}\n"});
+
+    constexpr U32 count = 64 * 16;
+    constexpr U64 size = count * sizeof(U32);
+    auto make_buffer = [&]() {
+        BufferDescriptor desc{.usage = BufferUsage::Storage |
+                                       BufferUsage::CopySrc |
+                                       BufferUsage::CopyDst,
+                              .size = size};
+        Buffer buf = device.CreateBuffer(&desc);
+        Vector<U32> zeros(count, 0);
+        eng->get_queue().WriteBuffer(buf, 0, zeros.data(), size);
+        return buf;
+    };
+
+    Buffer data = make_buffer();
+    ComputeDispatch dispatch{.pipeline = pipeline,
+                             .buffers = {{.buffer = data}},
+                             .dims = {count / 64, 1, 1}};
+
+    // Encoding the same dispatch N times only binds the resources once:
+    constexpr U32 numIters = 200;
+    auto t0 = SystemTime::tick();
+    dcache->execute({dispatch}, numIters);
+    auto t1 = SystemTime::tick();
+    BOOST_CHECK_EQUAL(dcache->get_num_misses(), 1);
+    BOOST_CHECK_EQUAL(dcache->get_num_skipped_bindings(), 2 * (numIters - 1));
+
+    // Separate executions reuse the bind group:
+    for (U32 i = 0; i < numIters; ++i) {
+        dcache->execute({dispatch});
+    }
+    auto t2 = SystemTime::tick();
+    BOOST_CHECK_EQUAL(dcache->get_num_hits(), numIters);
+    BOOST_CHECK_EQUAL(dcache->get_num_bind_groups(), 1);
+    logNOTE("Encoding {} dispatches: {:.3f}ms in one pass, {:.3f}ms in "
+            "separate passes",
+            numIters, SystemTime::delta_s(t0, t1) * 1000.0,
+            SystemTime::delta_s(t1, t2) * 1000.0);
+
+    // Read back the data:
+    BufferDescriptor rbDesc{.usage = BufferUsage::MapRead |
+                                     BufferUsage::CopyDst,
+                            .size = size};
+    Buffer readback = device.CreateBuffer(&rbDesc);
+    CommandEncoder encoder = device.CreateCommandEncoder();
+    encoder.CopyBufferToBuffer(data, 0, readback, 0, size);
+    CommandBuffer commands = encoder.Finish();
+    eng->get_queue().Submit(1, &commands);
+
+    bool mapped = false;
+    readback.MapAsync(
+        MapMode::Read, 0, size,
+        [](WGPUBufferMapAsyncStatus status, void* userdata) {
+            *(bool*)userdata = true;
+        },
+        &mapped);
+    while (!mapped) {
+        eng->get_instance().ProcessEvents();
+    }
+    const auto* values = (const U32*)readback.GetConstMappedRange(0, size);
+    U32 numErrors = 0;
+    for (U32 i = 0; i < count; ++i) {
+        numErrors += values[i] != 2 * numIters ? 1 : 0;
+    }
+    BOOST_CHECK_EQUAL(numErrors, 0);
+    readback.Unmap();
+
+    // Recreating the buffer invalidates the bind group (and the stale one is
+    // released):
+    BOOST_CHECK_EQUAL(dcache->invalidate(dispatch.buffers[0].buffer), 1);
+    dispatch.buffers[0].buffer = make_buffer();
+    dcache->execute({dispatch});
+    BOOST_CHECK_EQUAL(dcache->get_num_misses(), 2);
+    BOOST_CHECK_EQUAL(dcache->get_num_bind_groups(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()